@@ -18,17 +18,69 @@ main(int argc, char const* argv[])
   proc.set_path_design(config.at("DESIGN").get_as<std::string>("PATH"));
   proc.set_path_guide(config.at("DESIGN").get_as<std::string>("GUIDE"));
 
-  proc.prepare_data();
-  std::cout << "1. Data hash been prepared" << std::endl;
+  if(config.at("PDK").check_key("CACHE"))
+    {
+      proc.set_path_cache(config.at("PDK").get_as<std::string>("CACHE"));
+    }
+
+  if(config.at("DESIGN").check_key("SNAPSHOT"))
+    {
+      proc.set_path_snapshot(config.at("DESIGN").get_as<std::string>("SNAPSHOT"));
+    }
+
+  if(config.count("PROCESS") != 0 && config.at("PROCESS").check_key("THREADS"))
+    {
+      proc.set_threads_count(config.at("PROCESS").get_as<std::size_t>("THREADS"));
+    }
+
+  if(config.count("DATASET") != 0)
+    {
+      const auto&      section = config.at("DATASET");
+      dataset::Options options;
+
+      if(section.check_key("FORMAT"))
+        {
+          options.m_format = dataset::to_format(section.get_as<std::string>("FORMAT"));
+        }
 
-  proc.collect_overlaps();
-  std::cout << "2. Overlaps hash been collected" << std::endl;
+      if(section.check_key("COST"))
+        {
+          options.m_cost = dataset::to_cost_type(section.get_as<std::string>("COST"));
+        }
 
-  proc.apply_guide();
-  std::cout << "3. Guide has been applied" << std::endl;
+      if(section.check_key("PATH"))
+        {
+          options.m_path = dataset::to_path_type(section.get_as<std::string>("PATH"));
+        }
 
-  proc.remove_empty_gcells();
-  std::cout << "4. GCells has been processed" << std::endl;
+      if(section.check_key("RESUME"))
+        {
+          options.m_resume = section.get_as<bool>("RESUME");
+        }
+
+      proc.set_dataset_options(options);
+    }
+
+  if(proc.load_snapshot())
+    {
+      std::cout << "1-4. GCells has been restored from the snapshot" << std::endl;
+    }
+  else
+    {
+      proc.prepare_data();
+      std::cout << "1. Data hash been prepared" << std::endl;
+
+      proc.collect_overlaps();
+      std::cout << "2. Overlaps hash been collected" << std::endl;
+
+      proc.apply_guide();
+      std::cout << "3. Guide has been applied" << std::endl;
+
+      proc.remove_empty_gcells();
+      std::cout << "4. GCells has been processed" << std::endl;
+
+      proc.save_snapshot();
+    }
 
   proc.make_dataset();
 
@@ -12,10 +12,15 @@ from torch.nn.utils.rnn import pad_sequence, pack_padded_sequence
 from torch.utils.data import Dataset
 from tqdm import tqdm
 
+from dataset_format import find_root_folder, is_packed_path, load_cost, load_path
+
 def load_numpy(file_path, dtype=torch.float64):
     raw_data = np.transpose(np.load(file_path), axes=(2, 0, 1))
     return torch.tensor(raw_data, dtype=dtype)
 
+def to_tensor(raw_data, dtype=torch.float32):
+    return torch.tensor(np.transpose(raw_data, axes=(2, 0, 1)), dtype=dtype)
+
 def pad_and_resize(tensor, pad_size=(64, 64), resize_size=(128, 128)):
     pad_h = pad_size[0] - tensor.shape[-2]
     pad_w = pad_size[1] - tensor.shape[-1]
@@ -53,9 +58,17 @@ class ShuffleSequencePair:
         return self.__class__.__name__ + "()"
 
 class SegmentationDataset(Dataset):
-    def __init__(self, df: pd.DataFrame, validation: bool = False, remove_invalid: bool = False, check_data: bool = False, batch_size: int = 32, shuffle: bool = True):
+    def __init__(self, df: pd.DataFrame, validation: bool = False, remove_invalid: bool = False, check_data: bool = False, batch_size: int = 32, shuffle: bool = True, root_folder: str = None):
         super(SegmentationDataset, self).__init__()
+
+        if "source_h" not in df.columns:
+            raise ValueError("Rows don't reference npy files, a shard dataset is read with shard_dataset.ShardDataset.")
+
+        if root_folder is None and len(df) != 0:
+            root_folder = find_root_folder(df.iloc[0]["source_h"])
+
         self.validation = validation
+        self.packed_path = is_packed_path(root_folder) if root_folder is not None else False
         self.batch_size = batch_size
         self.shuffle = shuffle
         self.remove_invalid = remove_invalid
@@ -80,9 +93,9 @@ class SegmentationDataset(Dataset):
         for _, row in tqdm(df.iterrows(), total=len(df), desc="Prepare data", leave=False):
             if check_data:
                 nets = [self._process_net(row['net'])]
-                source_h_np = np.expand_dims(np.load(row['source_h']).astype(np.float32), axis=0)
-                source_v_np = np.expand_dims(np.load(row['source_v']).astype(np.float32), axis=0)
-                target_np   = np.expand_dims(np.transpose(np.load(row['target_path']).astype(np.float32), (2, 0, 1)), axis=0)
+                source_h_np = np.expand_dims(load_cost(row['source_h']), axis=0)
+                source_v_np = np.expand_dims(load_cost(row['source_v']), axis=0)
+                target_np   = np.expand_dims(np.transpose(self._load_path(row['target_path'], source_h_np.shape[2]), (2, 0, 1)), axis=0)
                 overall_result, general_result = net_connectivity.check_connectivity(nets, target_np)
 
                 if overall_result != 1.0 or general_result != 1.0:
@@ -108,7 +121,7 @@ class SegmentationDataset(Dataset):
 
             if remove_invalid:
                 nets = [self._process_net(row['net'])]
-                target_np = np.expand_dims(np.transpose(np.load(row['target_path']).astype(np.float32), (2, 0, 1)), axis=0)
+                target_np = np.expand_dims(np.transpose(self._load_path(row['target_path'], np.load(row['source_h'], mmap_mode='r').shape[1]), (2, 0, 1)), axis=0)
                 overall_result, general_result = net_connectivity.check_connectivity(nets, target_np)
 
                 if overall_result != 1.0 or general_result != 1.0:
@@ -151,10 +164,14 @@ class SegmentationDataset(Dataset):
 
         return netlist
     
+    def _load_path(self, target_path, width):
+        return load_path(target_path, width, self.packed_path).astype(np.float32)
+
     def _load_data(self, source_h_path, source_v_path, target_path):
-        source_h = load_numpy(source_h_path, dtype=torch.float32)
-        source_v = load_numpy(source_v_path, dtype=torch.float32)
-        target = load_numpy(target_path, dtype=torch.float32)
+        source_h_np = load_cost(source_h_path)
+        source_h = to_tensor(source_h_np)
+        source_v = to_tensor(load_cost(source_v_path))
+        target = to_tensor(self._load_path(target_path, source_h_np.shape[1]))
 
         source_h, source_v, target = self.transforms(source_h, source_v, target)
 
@@ -0,0 +1,67 @@
+import configparser
+import os
+
+import numpy as np
+
+DEFAULT_FORMAT = {"type": "npy", "cost": "f64", "path": "f64"}
+
+def read_format(root_folder: str):
+    """
+    Reads element types of tensors from dataset.ini, datasets without it are float64.
+    """
+    dataset_format = dict(DEFAULT_FORMAT)
+    ini_path = os.path.join(root_folder, "dataset.ini")
+
+    if os.path.exists(ini_path):
+        config = configparser.ConfigParser()
+        config.read(ini_path)
+        dataset_format.update({key.lower(): value for key, value in config["FORMAT"].items()})
+
+    return dataset_format
+
+def find_root_folder(source_h_path: str):
+    """
+    Finds the root folder of an npy dataset by a cost map file, files are saved as <root>/source/<name>/<chunk>_h.npy.
+    """
+    return os.path.dirname(os.path.dirname(os.path.dirname(os.path.abspath(source_h_path))))
+
+def is_packed_path(root_folder: str):
+    """
+    Checks whether target paths of an npy dataset are bit-packed, shard datasets can't be read as npy files.
+    """
+    dataset_format = read_format(root_folder)
+
+    if dataset_format["type"] != "npy":
+        raise ValueError(f"Dataset \"{root_folder}\" has TYPE = {dataset_format['type']}, read it with shard_dataset.ShardDataset instead of npy files.")
+
+    return dataset_format["path"] == "bits"
+
+def decode_cost(cost):
+    """
+    Converts cost maps of any element type to float32, quantised uint8 maps are scaled back to [0, 1].
+    """
+    if cost.dtype == np.uint8:
+        return cost.astype(np.float32) / 255.0
+
+    return cost.astype(np.float32)
+
+def decode_path(path, width):
+    """
+    Unpacks two bit planes (2, y, ceil(x / 8)) to a (y, x, 1) path with 0 - empty, 1 - wire, 2 - via.
+    """
+    planes = np.unpackbits(path, axis=-1, count=width)
+    return (planes[0] + planes[1])[..., np.newaxis]
+
+def load_cost(file_path):
+    return decode_cost(np.load(file_path))
+
+def load_path(file_path, width=None, packed=False):
+    """
+    Loads a target path, packed paths need the width of the cost maps since rows are padded up to 8 bits.
+    """
+    path = np.load(file_path)
+
+    if packed:
+        return decode_path(path, width)
+
+    return path.astype(np.float32)
@@ -0,0 +1,108 @@
+import os
+
+import numpy as np
+import pandas as pd
+
+from dataset_format import decode_path
+
+RECORD_MAGIC = b"FLRC"
+RECORD_VERSION = 1
+
+RECORD_HEADER = np.dtype([
+    ("magic", "S4"),
+    ("version", "<u4"),
+    ("cost_dtype", "S4"),
+    ("path_dtype", "S4"),
+    ("x", "<u8"),
+    ("y", "<u8"),
+    ("z", "<u8"),
+    ("pins_count", "<u8"),
+    ("nets_count", "<u8"),
+    ("name_size", "<u8"),
+    ("nets_size", "<u8"),
+    ("cost_size", "<u8"),
+    ("path_size", "<u8"),
+])
+
+def align_up(size):
+    return (size + 7) & ~7
+
+class ShardReader:
+    """
+    Memory-maps a single shard file written by the FastLink dataset writer with FORMAT = shard.
+    Records are returned as views into the mapped file, tensors have the same (y, x, z) layout as npy files.
+    Cost maps keep their stored element type, bit-packed paths are unpacked to uint8.
+    """
+    def __init__(self, shard_path: str):
+        self.shard_path = shard_path
+        self.data = np.memmap(shard_path, dtype=np.uint8, mode="r")
+        self.offsets = np.fromfile(os.path.splitext(shard_path)[0] + ".idx", dtype="<u8")
+
+    def __len__(self):
+        return len(self.offsets)
+
+    def _tensor(self, offset, size, dtype, shape):
+        return np.frombuffer(self.data, dtype=np.dtype(dtype), count=size // np.dtype(dtype).itemsize, offset=offset).reshape(shape)
+
+    def __getitem__(self, idx):
+        offset = int(self.offsets[idx])
+        header = np.frombuffer(self.data, dtype=RECORD_HEADER, count=1, offset=offset)[0]
+
+        if header["magic"] != RECORD_MAGIC or header["version"] != RECORD_VERSION:
+            raise ValueError(f"Invalid record {idx} in {self.shard_path}")
+
+        x, y, z = int(header["x"]), int(header["y"]), int(header["z"])
+        name_size, nets_size = int(header["name_size"]), int(header["nets_size"])
+        cost_size, path_size = int(header["cost_size"]), int(header["path_size"])
+
+        text_offset = offset + RECORD_HEADER.itemsize
+        tensor_offset = offset + align_up(RECORD_HEADER.itemsize + name_size + nets_size)
+        cost_dtype = header["cost_dtype"].decode()
+        path_dtype = header["path_dtype"].decode()
+
+        if path_dtype == "bits":
+            target_path = decode_path(self._tensor(tensor_offset + 2 * cost_size, path_size, "|u1", (2, y, (x + 7) // 8)), x)
+        else:
+            target_path = self._tensor(tensor_offset + 2 * cost_size, path_size, path_dtype, (y, x, 1))
+
+        return {
+            "name": self.data[text_offset:text_offset + name_size].tobytes().decode(),
+            "nets": self.data[text_offset + name_size:text_offset + name_size + nets_size].tobytes().decode(),
+            "source_h": self._tensor(tensor_offset, cost_size, cost_dtype, (y, x, z)),
+            "source_v": self._tensor(tensor_offset + cost_size, cost_size, cost_dtype, (y, x, z)),
+            "target_path": target_path,
+            "pins_count": int(header["pins_count"]),
+            "nets_count": int(header["nets_count"]),
+        }
+
+class ShardDataset:
+    """
+    Random access to all records of a sharded dataset through its data.csv.
+    """
+    def __init__(self, root_folder: str):
+        self.root_folder = root_folder
+        self.df = pd.read_csv(os.path.join(root_folder, "data.csv"))
+        self.readers = {}
+
+    def _reader(self, shard):
+        if shard not in self.readers:
+            self.readers[shard] = ShardReader(os.path.join(self.root_folder, shard))
+
+        return self.readers[shard]
+
+    def __len__(self):
+        return len(self.df)
+
+    def __getitem__(self, idx):
+        row = self.df.iloc[idx]
+        return self._reader(row["shard"])[int(row["record"])]
+
+if __name__ == "__main__":
+    import sys
+
+    dataset = ShardDataset(sys.argv[1])
+    print(f"Records: {len(dataset)}")
+
+    if len(dataset) != 0:
+        record = dataset[0]
+        print(record["name"], record["source_h"].shape, record["target_path"].shape)
@@ -0,0 +1,69 @@
+import os
+import tempfile
+import unittest
+
+import numpy as np
+
+from dataset_format import find_root_folder, is_packed_path, load_cost, load_path
+
+def write_ini(root_folder, dataset_type, cost, path):
+    """
+    Writes dataset.ini the way the FastLink dataset writer does.
+    """
+    with open(os.path.join(root_folder, "dataset.ini"), "w") as f:
+        f.write(f"[FORMAT]\nTYPE = {dataset_type}\nCOST = {cost}\nPATH = {path}\n")
+
+class DatasetFormatTest(unittest.TestCase):
+    def test_packed_sample_round_trip(self):
+        with tempfile.TemporaryDirectory() as root_folder:
+            write_ini(root_folder, "npy", "f16", "bits")
+
+            source_folder = os.path.join(root_folder, "source", "gcell_0_0_stack_1")
+            target_folder = os.path.join(root_folder, "target", "gcell_0_0_stack_1")
+            os.makedirs(source_folder)
+            os.makedirs(target_folder)
+
+            # Ten columns, so rows of planes are padded up to two bytes
+            path = np.zeros((3, 10), dtype=np.uint8)
+            path[0, 0] = 1
+            path[0, 7] = 2
+            path[1, 8] = 1
+            path[2, 9] = 2
+
+            # Planes are packed as the writer does, the first one marks wires and vias, the second one only vias
+            planes = np.stack([path != 0, path == 2])
+            packed = np.packbits(planes, axis=-1)
+            self.assertEqual(packed.shape, (2, 3, 2))
+
+            cost = np.linspace(0.0, 1.0, 30, dtype=np.float16).reshape(3, 10, 1)
+            np.save(os.path.join(source_folder, "0_h.npy"), cost)
+            np.save(os.path.join(target_folder, "0_path.npy"), packed)
+
+            source_h = os.path.join(source_folder, "0_h.npy")
+            self.assertEqual(os.path.realpath(find_root_folder(source_h)), os.path.realpath(root_folder))
+            self.assertTrue(is_packed_path(find_root_folder(source_h)))
+
+            loaded_cost = load_cost(source_h)
+            loaded_path = load_path(os.path.join(target_folder, "0_path.npy"), loaded_cost.shape[1], packed=True)
+
+            self.assertEqual(loaded_cost.dtype, np.float32)
+            self.assertEqual(loaded_path.shape, (3, 10, 1))
+            np.testing.assert_array_equal(loaded_path[..., 0], path)
+
+    def test_unpacked_and_legacy_datasets(self):
+        with tempfile.TemporaryDirectory() as root_folder:
+            # Datasets written before dataset.ini are float64 npy files
+            self.assertFalse(is_packed_path(root_folder))
+
+            write_ini(root_folder, "npy", "u8", "u8")
+            self.assertFalse(is_packed_path(root_folder))
+
+    def test_shard_dataset_is_rejected(self):
+        with tempfile.TemporaryDirectory() as root_folder:
+            write_ini(root_folder, "shard", "f16", "bits")
+
+            with self.assertRaises(ValueError):
+                is_packed_path(root_folder)
+
+if __name__ == "__main__":
+    unittest.main()
@@ -64,7 +64,7 @@ def main() -> None:
     print(df["nets_count"].value_counts())
     print(np.mean(df["nets_count"].values))
 
-    val_dataset = SegmentationDataset(df, validation=True, remove_invalid=True, check_data=False, batch_size=batch_size)
+    val_dataset = SegmentationDataset(df, validation=True, remove_invalid=True, check_data=False, batch_size=batch_size, root_folder=base_dir.parent)
     val_loader = DataLoader(val_dataset, batch_size=batch_size, collate_fn=pack_batch, shuffle=False, num_workers=4, pin_memory=True)
     
     model = RecurrentUNet(num_classes=3).to(device)
@@ -9,48 +9,236 @@
 #include <limits>
 #include <optional>
 #include <queue>
+#include <stop_token>
+#include <unordered_set>
 #include <vector>
 
 #include "Include/Geometry.hpp"
 #include "Include/Graph.hpp"
 #include "Include/Matrix.hpp"
 
-namespace algorithms
+namespace algorithms::details
 {
 
-class AStar
+/** A fixed size set of indices */
+class Bitset
 {
-  struct Node
+public:
+  void
+  resize(const std::size_t size)
   {
-    uint32_t m_ref;
-    double   m_g      = 0.0;
-    double   m_h      = 0.0;
-    double   m_f      = 0.0;
-    Node*    m_parent = nullptr;
+    m_words.assign((size + 63) / 64, 0);
+  }
 
-    Node(const uint32_t ref, const double g, const double h, Node* parent = nullptr)
-        : m_ref(ref), m_g(g), m_h(h), m_f(g + h), m_parent(parent) {};
+  bool
+  test(const uint32_t idx) const noexcept(true)
+  {
+    return (m_words[idx >> 6] >> (idx & 63)) & 1;
+  }
 
-    struct Compare
-    {
-      bool
-      operator()(const Node* lhs, const Node* rhs) const
-      {
-        return lhs->m_f > rhs->m_f;
-      };
-    };
+  void
+  set(const uint32_t idx) noexcept(true)
+  {
+    m_words[idx >> 6] |= uint64_t(1) << (idx & 63);
+  }
+
+  void
+  reset(const uint32_t idx) noexcept(true)
+  {
+    m_words[idx >> 6] &= ~(uint64_t(1) << (idx & 63));
+  }
+
+private:
+  std::vector<uint64_t> m_words; ///> Bits of indices, 64 per word.
+};
+
+/** A min heap with four children per node, it's shallower than a binary heap and children of a node share a cache line */
+class QuadHeap
+{
+public:
+  struct Entry
+  {
+    uint32_t m_key;  ///> The priority, lower is popped first.
+    uint32_t m_node; ///> The index of a node.
   };
 
 public:
-  AStar(const graph::Graph& graph, const matrix::SetOfNodes& obs, const std::vector<matrix::Node>& nodes)
-      : m_graph(graph), m_obs(obs), m_nodes(nodes)
+  bool
+  empty() const noexcept(true)
+  {
+    return m_entries.empty();
+  }
+
+  void
+  clear() noexcept(true)
   {
-    m_obstacle_cost = std::numeric_limits<uint32_t>::max() / (m_graph.get_adj().size() / 2);
+    m_entries.clear();
+  }
+
+  void
+  push(const Entry entry)
+  {
+    std::size_t idx = m_entries.size();
+    m_entries.push_back(entry);
+
+    while(idx != 0)
+      {
+        const std::size_t parent = (idx - 1) / 4;
+
+        if(m_entries[parent].m_key <= entry.m_key)
+          {
+            break;
+          }
+
+        m_entries[idx] = m_entries[parent];
+        idx            = parent;
+      }
+
+    m_entries[idx] = entry;
+  }
+
+  Entry
+  pop()
+  {
+    const Entry       top  = m_entries.front();
+    const Entry       last = m_entries.back();
+    const std::size_t size = m_entries.size() - 1;
+
+    m_entries.pop_back();
+
+    if(size == 0)
+      {
+        return top;
+      }
+
+    std::size_t idx = 0;
+
+    while(true)
+      {
+        const std::size_t first = idx * 4 + 1;
+
+        if(first >= size)
+          {
+            break;
+          }
+
+        std::size_t best = first;
+
+        for(std::size_t child = first + 1, end = std::min(first + 4, size); child < end; ++child)
+          {
+            if(m_entries[child].m_key < m_entries[best].m_key)
+              {
+                best = child;
+              }
+          }
+
+        if(last.m_key <= m_entries[best].m_key)
+          {
+            break;
+          }
+
+        m_entries[idx] = m_entries[best];
+        idx            = best;
+      }
+
+    m_entries[idx] = last;
+
+    return top;
+  }
+
+private:
+  std::vector<Entry> m_entries; ///> The heap, children of i are 4i + 1 ... 4i + 4.
+};
+
+} // namespace algorithms::details
+
+namespace algorithms
+{
+
+/**
+ * @brief A* on a graph of a stack, the cost of an edge is the cost of entering its destination node. Obstacles and terminals are bitsets
+ * indexed by graph nodes and per search state is kept in flat arrays that are reused by all searches of an instance.
+ */
+class AStar
+{
+  static constexpr uint32_t NONE = std::numeric_limits<uint32_t>::max();
+
+public:
+  static constexpr uint32_t STEP_COST = 8; ///> The cost of entering a free node, the heuristic is in the same units.
+
+public:
+  /**
+   * @brief Construct a new AStar.
+   *
+   * @param graph The graph of a stack.
+   * @param obs Blocked nodes, usually terminals of all nets of a stack.
+   * @param nodes Positions of graph nodes.
+   * @param costs Costs of entering graph nodes, not less than STEP_COST, they may change between searches.
+   */
+  AStar(const graph::Graph& graph, const matrix::SetOfNodes& obs, const std::vector<matrix::Node>& nodes, const std::vector<uint32_t>& costs)
+      : m_graph(graph), m_nodes(nodes), m_costs(costs)
+  {
+    const std::size_t size = m_nodes.size();
+
+    m_blocked.resize(size);
+    m_terminals.resize(size);
+    m_g_score.resize(size);
+    m_parents.resize(size);
+    m_visited.resize(size, 0);
+    m_closed.resize(size, 0);
+
+    for(std::size_t i = 0; i < size; ++i)
+      {
+        if(obs.count(m_nodes[i]) != 0)
+          {
+            m_blocked.set(i);
+          }
+      }
   };
 
 public:
+  /**
+   * @brief Connects terminals of a net by a tree, blocked nodes are never entered except terminals of the net.
+   *
+   * @param terminals Terminals of a net.
+   * @return std::vector<graph::Edge> Edges of the tree, empty if terminals can't be connected.
+   */
   std::vector<graph::Edge>
   multi_terminal_path(const std::unordered_set<uint32_t>& terminals)
+  {
+    for(const auto& terminal : terminals)
+      {
+        m_terminals.set(terminal);
+      }
+
+    std::vector<graph::Edge> result_path = connect(terminals);
+
+    for(const auto& terminal : terminals)
+      {
+        m_terminals.reset(terminal);
+      }
+
+    return result_path;
+  }
+
+  /**
+   * @brief Blocks nodes of a tree for all next searches.
+   *
+   * @param tree The tree.
+   */
+  void
+  block(const std::vector<graph::Edge>& tree)
+  {
+    for(const auto& edge : tree)
+      {
+        m_blocked.set(edge.m_source);
+        m_blocked.set(edge.m_destination);
+      }
+  }
+
+private:
+  std::vector<graph::Edge>
+  connect(const std::unordered_set<uint32_t>& terminals)
   {
     std::vector<graph::Edge>     result_path;
 
@@ -61,7 +249,7 @@ public:
       {
         uint32_t goal           = 0;
         uint32_t start          = 0;
-        double   best_heuristic = std::numeric_limits<double>::max();
+        uint32_t best_heuristic = NONE;
         bool     goal_is_set    = false;
 
         for(const auto& current_goal : terminals)
@@ -78,7 +266,7 @@ public:
                     continue;
                   }
 
-                double h = heuristic(current_start, current_goal);
+                const uint32_t h = heuristic(current_start, current_goal);
 
                 if(h < best_heuristic)
                   {
@@ -96,7 +284,7 @@ public:
             break;
           }
 
-        const std::vector<graph::Edge> path = find_path(start, goal, terminals);
+        const std::vector<graph::Edge> path = find_path(start, goal);
 
         if(path.empty())
           {
@@ -123,122 +311,322 @@ public:
           }
       }
 
-    for(const auto& edge : result_path)
-      {
-        m_obs.emplace(m_nodes[edge.m_source]);
-        m_obs.emplace(m_nodes[edge.m_destination]);
-      }
-
     return result_path;
   }
 
-private:
   std::vector<graph::Edge>
-  find_path(const uint32_t start, const uint32_t goal, const std::unordered_set<uint32_t>& terminals)
+  find_path(const uint32_t start, const uint32_t goal)
   {
-    const auto&                                                   adj = m_graph.get_adj();
-
-    std::vector<uint8_t>                                          closed(m_nodes.size(), 0);
-    std::vector<double>                                           g_score(m_nodes.size(), std::numeric_limits<double>::max());
-    std::vector<Node*>                                            nodes_collection;
+    /** Scores and parents are valid only for nodes stamped by the current search, so arrays aren't cleared between searches */
+    if(++m_search == 0)
+      {
+        std::fill(m_visited.begin(), m_visited.end(), 0);
+        std::fill(m_closed.begin(), m_closed.end(), 0);
+        m_search = 1;
+      }
 
-    std::priority_queue<Node*, std::vector<Node*>, Node::Compare> open_list;
+    m_open.clear();
+    m_open.push({ heuristic(start, goal), start });
 
-    {
-      Node* new_node = new Node(start, 0, heuristic(start, goal));
-      open_list.emplace(new_node);
-      nodes_collection.emplace_back(new_node);
-    }
+    m_g_score[start] = 0;
+    m_parents[start] = NONE;
+    m_visited[start] = m_search;
 
-    g_score[start]  = 0;
+    bool is_found    = false;
 
-    Node* goal_node = nullptr;
-
-    while(!open_list.empty())
+    while(!m_open.empty())
       {
-        Node* current = open_list.top();
-        open_list.pop();
+        const uint32_t current = m_open.pop().m_node;
 
-        if(current->m_ref == goal)
+        if(current == goal)
           {
-            goal_node = current;
+            is_found = true;
             break;
           }
 
-        if(closed.at(current->m_ref) == 1 || (m_obs.count(m_nodes.at(current->m_ref)) != 0 && terminals.count(current->m_ref) == 0))
+        if(m_closed[current] == m_search || is_blocked(current))
           {
             continue;
           }
 
-        closed[current->m_ref] = 1;
+        m_closed[current] = m_search;
+
+        m_graph.for_each_neighbour(current, [&](const uint32_t next, const uint32_t) {
+          if(m_closed[next] == m_search || is_blocked(next))
+            {
+              return;
+            }
+
+          const uint32_t tentative_g = m_g_score[current] + m_costs[next];
+
+          if(m_visited[next] != m_search || tentative_g < m_g_score[next])
+            {
+              m_g_score[next] = tentative_g;
+              m_parents[next] = current;
+              m_visited[next] = m_search;
+
+              m_open.push({ tentative_g + heuristic(next, goal), next });
+            }
+        });
+      }
+
+    if(!is_found)
+      {
+        return {};
+      }
+
+    std::vector<graph::Edge> path;
+
+    for(uint32_t current = goal; m_parents[current] != NONE; current = m_parents[current])
+      {
+        path.emplace_back(0, current, m_parents[current]);
+      }
+
+    return path;
+  }
+
+private:
+  bool
+  is_blocked(const uint32_t node) const noexcept(true)
+  {
+    return m_blocked.test(node) && !m_terminals.test(node);
+  }
+
+  uint32_t
+  heuristic(const uint32_t lhs, const uint32_t rhs) const
+  {
+    const auto& lhs_node = m_nodes[lhs];
+    const auto& rhs_node = m_nodes[rhs];
+
+    const auto  distance = [](const uint32_t a, const uint32_t b) { return a > b ? a - b : b - a; };
+
+    return STEP_COST * (distance(lhs_node.m_x, rhs_node.m_x) + distance(lhs_node.m_y, rhs_node.m_y) + distance(lhs_node.m_z, rhs_node.m_z));
+  }
+
+private:
+  const graph::Graph&              m_graph;
+  const std::vector<matrix::Node>& m_nodes;
+  const std::vector<uint32_t>&     m_costs;      ///> Costs of entering nodes.
+
+  details::Bitset                  m_blocked;    ///> Nodes of obstacles.
+  details::Bitset                  m_terminals;  ///> Terminals of the current net, they are never blocked for it.
+
+  details::QuadHeap                m_open;       ///> The open list, keyed by f = g + h.
+  std::vector<uint32_t>            m_g_score;    ///> The best known distance from the start.
+  std::vector<uint32_t>            m_parents;    ///> The previous node on the best known path.
+  std::vector<uint32_t>            m_visited;    ///> The last search that has reached a node.
+  std::vector<uint32_t>            m_closed;     ///> The last search that has expanded a node.
+  uint32_t                         m_search = 0; ///> The stamp of the current search.
+};
+
+/**
+ * @brief Negotiated congestion routing of nets of a stack (PathFinder). Nets are routed one by one and may share nodes, a shared node
+ * becomes more expensive with every iteration both for its present use and for its history, so nets negotiate nodes until no node is
+ * shared. Only nets on shared nodes are ripped up and routed again.
+ */
+class PathFinder
+{
+public:
+  static constexpr uint32_t PRESENT_COST         = AStar::STEP_COST / 2;  ///> The initial cost of a node per a net using it.
+  static constexpr uint32_t MAX_PRESENT_COST     = AStar::STEP_COST << 9; ///> The present cost stops growing there, costs fit in 32 bits.
+  static constexpr uint32_t HISTORY_COST         = AStar::STEP_COST;      ///> The cost added to a node for each iteration it was shared.
+  static constexpr uint32_t MAX_STALL_ITERATIONS = 3;                     ///> Iterations without less sharing before the negotiation stops.
+
+  struct Result
+  {
+    std::vector<std::vector<graph::Edge>> m_trees;                ///> Trees of nets in order of nets, empty ones for failed nets.
+    std::size_t                           m_iterations   = 0;     ///> The number of negotiation iterations.
+    std::size_t                           m_unroutable   = 0;     ///> The number of nets that can't be routed in any order.
+    bool                                  m_is_cancelled = false; ///> The routing has been stopped, trees are incomplete.
+
+    /** All nets except unroutable ones are routed */
+    bool
+    is_complete() const
+    {
+      return !m_is_cancelled && std::size_t(std::count_if(m_trees.begin(), m_trees.end(), [](const auto& tree) { return tree.empty(); })) == m_unroutable;
+    }
+  };
+
+public:
+  PathFinder(const graph::Graph& graph, const matrix::SetOfNodes& obs, const std::vector<matrix::Node>& nodes)
+      : m_costs(nodes.size(), AStar::STEP_COST), m_usage(nodes.size(), 0), m_history(nodes.size(), 0), m_present_cost(PRESENT_COST), m_search(graph, obs, nodes, m_costs)
+  {
+    m_marked.resize(nodes.size());
+  }
+
+public:
+  /**
+   * @brief Routes nets until no node is shared or iterations are over. Nets that are still sharing nodes after that are routed again in
+   * order around all other nets, so the result is always legal.
+   *
+   * @param nets Terminals of nets in order of routing.
+   * @param max_iterations The maximum number of routing iterations.
+   * @param token Stops the routing between two nets.
+   * @return Result Trees of nets.
+   */
+  Result
+  route(const std::vector<std::unordered_set<uint32_t>>& nets, const std::size_t max_iterations, const std::stop_token& token = {})
+  {
+    Result                                 result;
+    std::vector<std::vector<graph::Edge>>& trees        = result.m_trees;
+    std::size_t&                           itr          = result.m_iterations;
+
+    std::vector<uint8_t>                   is_failed(nets.size(), 0);
+    std::vector<uint8_t>                   is_shared(nets.size(), 1);
+    std::size_t                            best_itr     = 0;
+    std::size_t                            best_overuse = std::numeric_limits<std::size_t>::max();
 
-        for(const auto& edge : adj.at(current->m_ref))
+    trees.resize(nets.size());
+
+    while(itr < max_iterations)
+      {
+        ++itr;
+
+        for(std::size_t i = 0, end = nets.size(); i < end; ++i)
           {
-            if(closed.at(edge.m_destination) == 1 || (m_obs.count(m_nodes.at(edge.m_destination)) != 0 && terminals.count(edge.m_destination) == 0))
+            if(is_failed[i] != 0 || is_shared[i] == 0)
               {
                 continue;
               }
 
-            double tentative_g = current->m_g + 1;
+            if(token.stop_requested())
+              {
+                result.m_is_cancelled = true;
+                return result;
+              }
+
+            occupy(trees[i], -1);
+            trees[i] = m_search.multi_terminal_path(nets[i]);
 
-            if(tentative_g < g_score.at(edge.m_destination))
+            /** Other nets never block a net, so a net that can't be routed now can't be routed at all */
+            if(trees[i].empty())
               {
-                g_score[edge.m_destination] = tentative_g;
+                is_failed[i] = 1;
+                ++result.m_unroutable;
+              }
 
-                Node* new_node              = new Node(edge.m_destination, tentative_g, heuristic(edge.m_destination, goal), current);
-                open_list.emplace(new_node);
-                nodes_collection.emplace_back(new_node);
+            occupy(trees[i], 1);
+          }
+
+        std::size_t overuse = 0;
+
+        for(std::size_t node = 0, end = m_usage.size(); node < end; ++node)
+          {
+            if(m_usage[node] > 1)
+              {
+                m_history[node] += HISTORY_COST;
+                overuse         += m_usage[node] - 1;
               }
           }
-      }
 
-    if(goal_node == nullptr)
-      {
-        for(const auto& node : nodes_collection)
+        if(overuse == 0)
           {
-            delete node;
+            return result;
           }
 
-        return {};
+        /** Nets that keep fighting for the same nodes rarely agree later, the rest is left to the sequential routing below */
+        if(overuse < best_overuse)
+          {
+            best_overuse = overuse;
+            best_itr     = itr;
+          }
+        else if(itr - best_itr >= MAX_STALL_ITERATIONS)
+          {
+            break;
+          }
+
+        m_present_cost = std::min(m_present_cost * 2, MAX_PRESENT_COST);
+
+        for(std::size_t node = 0, end = m_costs.size(); node < end; ++node)
+          {
+            update_cost(node);
+          }
+
+        for(std::size_t i = 0, end = nets.size(); i < end; ++i)
+          {
+            is_shared[i] = is_tree_shared(trees[i]);
+          }
       }
 
-    std::vector<graph::Edge> path;
-    Node*                    current = goal_node;
+    /** A net keeps its tree if it doesn't share it with any of the remaining nets, others are routed again one by one around nodes of all
+     * other nets, as there were no negotiation */
+    std::vector<std::size_t> unresolved;
 
-    while(current->m_parent != nullptr)
+    for(std::size_t i = 0, end = nets.size(); i < end; ++i)
       {
-        path.emplace_back(0, current->m_ref, current->m_parent->m_ref);
-        current = current->m_parent;
+        if(is_tree_shared(trees[i]))
+          {
+            occupy(trees[i], -1);
+            trees[i].clear();
+            unresolved.push_back(i);
+          }
       }
 
-    for(const auto& node : nodes_collection)
+    for(const auto& tree : trees)
       {
-        delete node;
+        m_search.block(tree);
       }
 
-    return path;
+    for(const std::size_t i : unresolved)
+      {
+        if(token.stop_requested())
+          {
+            result.m_is_cancelled = true;
+            return result;
+          }
+
+        trees[i] = m_search.multi_terminal_path(nets[i]);
+        m_search.block(trees[i]);
+      }
+
+    return result;
   }
 
 private:
-  double
-  heuristic(const uint32_t lhs, const uint32_t rhs) const
+  /** Adds a net to nodes of its tree or removes it */
+  void
+  occupy(const std::vector<graph::Edge>& tree, const int32_t delta)
   {
-    const auto&  lhs_node = m_nodes.at(lhs);
-    const auto&  rhs_node = m_nodes.at(rhs);
+    /** Inner nodes of a tree are shared by several edges, so every node is counted once */
+    for(const auto& edge : tree)
+      {
+        for(const uint32_t node : { edge.m_source, edge.m_destination })
+          {
+            if(!m_marked.test(node))
+              {
+                m_marked.set(node);
+                m_usage[node] += delta;
+                update_cost(node);
+              }
+          }
+      }
 
-    const double dx       = std::abs(double(lhs_node.m_x) - double(rhs_node.m_x));
-    const double dy       = std::abs(double(lhs_node.m_y) - double(rhs_node.m_y));
-    const double dz       = std::abs(double(lhs_node.m_z) - double(rhs_node.m_z));
+    for(const auto& edge : tree)
+      {
+        m_marked.reset(edge.m_source);
+        m_marked.reset(edge.m_destination);
+      }
+  }
 
-    return dx + dy + dz;
+  bool
+  is_tree_shared(const std::vector<graph::Edge>& tree) const
+  {
+    return std::any_of(tree.begin(), tree.end(), [this](const graph::Edge& edge) { return m_usage[edge.m_source] > 1 || m_usage[edge.m_destination] > 1; });
   }
 
-private:
-  const graph::Graph&              m_graph;
-  const std::vector<matrix::Node>& m_nodes;
+  void
+  update_cost(const std::size_t node) noexcept(true)
+  {
+    m_costs[node] = AStar::STEP_COST + m_history[node] + m_present_cost * m_usage[node];
+  }
 
-  matrix::SetOfNodes               m_obs;
-  double                           m_obstacle_cost;
+private:
+  std::vector<uint32_t> m_costs;        ///> Costs of entering nodes, read by the search.
+  std::vector<uint32_t> m_usage;        ///> The number of nets using a node.
+  std::vector<uint32_t> m_history;      ///> The accumulated cost of sharing a node.
+  uint32_t              m_present_cost; ///> The cost of a node per a net using it.
+  details::Bitset       m_marked;       ///> Nodes already counted for the current tree.
+  AStar                 m_search;
 };
 
 } // namespace algorithms
@@ -0,0 +1,81 @@
+#ifndef __COST_MAP_HPP__
+#define __COST_MAP_HPP__
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+#include "Include/Matrix.hpp"
+
+namespace algorithms
+{
+
+/**
+ * @brief Distance cost maps of nets within a stack matrix, layer 0 allows horizontal moves and layer 1 allows vertical moves.
+ *
+ * All edge costs are small multiples of 1/8, so costs are kept as integers and the multi-source Dijkstra runs on a bucket queue (Dial's
+ * algorithm). Obstacles are shared by all nets of a stack, so they are packed into a mask once and reused by every net.
+ */
+class CostMap
+{
+public:
+  static constexpr uint32_t UNIT        = 8;  ///> Costs are stored in 1/8 of a step.
+  static constexpr uint32_t DETOUR_COST = 1;  ///> The cost of a step away from the row or the column of a terminal.
+  static constexpr uint32_t SWITCH_COST = 16; ///> The cost of switching layers.
+  static constexpr uint32_t MAX_EDGE    = 2 * (UNIT + DETOUR_COST);
+  static constexpr uint32_t BUCKETS     = 32; ///> A power of two greater than the largest edge cost.
+
+  static_assert(BUCKETS > MAX_EDGE && BUCKETS > SWITCH_COST && (BUCKETS & (BUCKETS - 1)) == 0);
+
+public:
+  /**
+   * @brief Construct a new CostMap.
+   *
+   * @param source The stack matrix, zero elements are blocked.
+   * @param obs Blocked nodes, usually terminals of all nets of a stack.
+   */
+  CostMap(const matrix::Matrix<>& source, const matrix::SetOfNodes& obs);
+
+public:
+  /**
+   * @brief Computes normalized cost maps of a net, reached cells are mapped to (0, 0.9], terminals are set to 1 and unreached cells are
+   * set to 0.
+   *
+   * @param terminals Terminals of a net, sources of the search.
+   * @param horizontal The cost map of layer 0.
+   * @param vertical The cost map of layer 1.
+   */
+  void
+  compute(const matrix::SetOfNodes& terminals, const matrix::View<double> horizontal, const matrix::View<double> vertical);
+
+private:
+  /**
+   * @brief Relaxes an edge of the search.
+   *
+   * @param node The index of a neighbour node.
+   * @param cost The cost of a neighbour node through the current one.
+   * @param origin The terminal of the current node.
+   */
+  void
+  relax(const uint32_t node, const uint32_t cost, const uint32_t origin);
+
+  uint32_t
+  index(const uint32_t x, const uint32_t y, const uint32_t z) const noexcept(true)
+  {
+    return (y * m_size_x + x) * 2 + z;
+  }
+
+private:
+  uint32_t                                   m_size_x;  ///> The width of a stack matrix.
+  uint32_t                                   m_size_y;  ///> The height of a stack matrix.
+
+  std::vector<uint8_t>                       m_open;    ///> Nonzero for nodes that may be entered, indexed the same way as a matrix.
+  std::vector<uint32_t>                      m_costs;   ///> The best known cost of nodes in UNIT.
+  std::vector<uint32_t>                      m_origins; ///> The terminal the best cost comes from, x in low and y in high 16 bits.
+  std::array<std::vector<uint32_t>, BUCKETS> m_buckets; ///> Nodes by their cost modulo BUCKETS.
+  std::size_t                                m_queued;  ///> The number of entries in all buckets.
+};
+
+} // namespace algorithms
+
+#endif
@@ -1,34 +1,130 @@
 #ifndef __ACCESS_POINT_GRID_HPP__
 #define __ACCESS_POINT_GRID_HPP__
 
+#include <cstdint>
 #include <iostream>
+#include <limits>
 #include <unordered_set>
+#include <vector>
 
 #include "Include/DEF/Pin.hpp"
 
 namespace def::details
 {
 
-struct AccessNode
+static_assert(uint8_t(types::Metal::SIZE) < 32, "Metal layers must fit into a 32-bit mask.");
+
+/**
+ * @brief Get the bit of a metal layer in a mask of blocked layers.
+ *
+ * @param metal The metal layer.
+ * @return uint32_t
+ */
+constexpr uint32_t
+metal_bit(const types::Metal metal) noexcept(true)
 {
-  enum class Status
-  {
-    FREE = 0,    ///> No pin claimed a node.
-    OCCUPIED,    ///> Some pin claimed a node.
-    VIA_BLOCKAGE ///> Pins may be allowed in this node only if no other place is found.
-  } m_status
-      = Status::FREE;
-
-  Pin*                             m_ptr = nullptr;  ///> Pointer to the def pin.
-  std::unordered_set<types::Metal> m_blocked_metals; ///> Set of metal layers that occupied on this node.
+  return uint32_t(1) << uint8_t(metal);
+}
+
+enum class AccessStatus : uint8_t
+{
+  FREE = 0,    ///> No pin claimed a node.
+  OCCUPIED,    ///> Some pin claimed a node.
+  VIA_BLOCKAGE ///> Pins may be allowed in this node only if no other place is found.
 };
 
-struct AccessLine
+/**
+ * @brief Nodes of parallel lines of a grid in the structure-of-arrays form.
+ *
+ * Each line holds its nodes followed by the left and the right side nodes, so the state of all nodes is kept in a few contiguous arrays
+ * indexed by the same node index. Blocked metal layers of a node are packed into a bit mask and pins are referenced by indices into the
+ * table of pins of the lines.
+ */
+struct AccessLines
 {
-  std::size_t             m_assigned = 0; ///> Number of pins assigned to a line.
-  std::vector<AccessNode> m_pins;         ///> Array of pins.
-  AccessNode              m_left_pin;     ///> Left side pin.
-  AccessNode              m_right_pin;    ///> Right side pin.
+  static constexpr uint32_t NO_PIN = std::numeric_limits<uint32_t>::max(); ///> A node without a pin.
+
+  std::size_t               m_length = 0; ///> The number of nodes of a line, side nodes excluded.
+  std::vector<std::size_t>  m_assigned;   ///> Number of pins assigned to a line.
+  std::vector<uint32_t>     m_blocked;    ///> Masks of metal layers occupied on a node.
+  std::vector<AccessStatus> m_status;     ///> The status of a node.
+  std::vector<uint32_t>     m_pin_ids;    ///> The index of the pin of a node, NO_PIN if there is no pin.
+  std::vector<Pin*>         m_pins;       ///> Pins referenced by nodes.
+
+  /**
+   * @brief Resets lines, the first and the last nodes of each line are via blockages.
+   *
+   * @param count The number of lines.
+   * @param length The number of nodes of a line.
+   */
+  void
+  resize(const std::size_t count, const std::size_t length)
+  {
+    const std::size_t size = count * (length + 2);
+
+    m_length               = length;
+    m_assigned.assign(count, 0);
+    m_blocked.assign(size, 0);
+    m_status.assign(size, AccessStatus::FREE);
+    m_pin_ids.assign(size, NO_PIN);
+    m_pins.clear();
+
+    for(std::size_t line = 0; line < count && length != 0; ++line)
+      {
+        m_status[index(line, 0)]          = AccessStatus::VIA_BLOCKAGE;
+        m_status[index(line, length - 1)] = AccessStatus::VIA_BLOCKAGE;
+      }
+  }
+
+  std::size_t
+  size() const noexcept(true)
+  {
+    return m_assigned.size();
+  }
+
+  std::size_t
+  index(const std::size_t line, const std::size_t node) const noexcept(true)
+  {
+    return line * (m_length + 2) + node;
+  }
+
+  std::size_t
+  left(const std::size_t line) const noexcept(true)
+  {
+    return index(line, m_length);
+  }
+
+  std::size_t
+  right(const std::size_t line) const noexcept(true)
+  {
+    return index(line, m_length + 1);
+  }
+
+  bool
+  is_blocked(const std::size_t node, const types::Metal metal) const noexcept(true)
+  {
+    return (m_blocked[node] & metal_bit(metal)) != 0;
+  }
+
+  Pin*
+  get_pin(const std::size_t node) const noexcept(true)
+  {
+    return m_pin_ids[node] == NO_PIN ? nullptr : m_pins[m_pin_ids[node]];
+  }
+
+  /**
+   * @brief Claims a node by a pin.
+   *
+   * @param node The index of a node.
+   * @param pin The pin.
+   */
+  void
+  occupy(const std::size_t node, Pin* pin)
+  {
+    m_pin_ids[node] = m_pins.size();
+    m_status[node]  = AccessStatus::OCCUPIED;
+    m_pins.push_back(pin);
+  }
 };
 
 } // namespace def::details
@@ -52,22 +148,8 @@ public:
     const std::size_t size_x = (end.x - start.x) / step + 1;
     const std::size_t size_y = (end.y - start.y) / step + 1;
 
-    m_h_lines.resize(size_y);
-    m_v_lines.resize(size_x);
-
-    for(auto& line : m_h_lines)
-      {
-        line.m_pins.resize(size_x);
-        line.m_pins.front().m_status = details::AccessNode::Status::VIA_BLOCKAGE;
-        line.m_pins.back().m_status  = details::AccessNode::Status::VIA_BLOCKAGE;
-      }
-
-    for(auto& line : m_v_lines)
-      {
-        line.m_pins.resize(size_y);
-        line.m_pins.front().m_status = details::AccessNode::Status::VIA_BLOCKAGE;
-        line.m_pins.back().m_status  = details::AccessNode::Status::VIA_BLOCKAGE;
-      }
+    m_h_lines.resize(size_y, size_x);
+    m_v_lines.resize(size_x, size_y);
   };
 
   ~AccessPointGrid()
@@ -104,6 +186,7 @@ public:
   {
     const types::Metal metal            = poly.m_metal;
     const std::size_t  metal_idx        = (uint8_t(metal) - 1) / 2 - 1;
+    const uint32_t     bit              = details::metal_bit(metal);
     const auto [left_top, right_bottom] = poly.get_extrem_points();
 
     const geom::Point left_top_proj     = project_coordinate(left_top);
@@ -125,29 +208,29 @@ public:
               {
                 if(is_via_blockage)
                   {
-                    m_h_lines[y_proj].m_pins[x_proj].m_status = details::AccessNode::Status::VIA_BLOCKAGE;
+                    m_h_lines.m_status[m_h_lines.index(y_proj, x_proj)] = details::AccessStatus::VIA_BLOCKAGE;
                   }
                 else
                   {
-                    m_h_lines[y_proj].m_pins[x_proj].m_blocked_metals.emplace(poly.m_metal);
+                    m_h_lines.m_blocked[m_h_lines.index(y_proj, x_proj)] |= bit;
 
-                    if(x_proj == m_h_lines[y_proj].m_pins.size() - 1)
+                    if(x_proj == m_h_lines.m_length - 1)
                       {
-                        m_h_lines[y_proj].m_right_pin.m_blocked_metals.emplace(metal);
+                        m_h_lines.m_blocked[m_h_lines.right(y_proj)] |= bit;
 
                         if(m_right != nullptr)
                           {
-                            m_right->m_h_lines[y_proj].m_left_pin.m_blocked_metals.emplace(metal);
+                            m_right->m_h_lines.m_blocked[m_right->m_h_lines.left(y_proj)] |= bit;
                           }
                       }
 
                     if(x_proj == 0)
                       {
-                        m_h_lines[y_proj].m_left_pin.m_blocked_metals.emplace(metal);
+                        m_h_lines.m_blocked[m_h_lines.left(y_proj)] |= bit;
 
                         if(m_left != nullptr)
                           {
-                            m_left->m_h_lines[y_proj].m_right_pin.m_blocked_metals.emplace(metal);
+                            m_left->m_h_lines.m_blocked[m_left->m_h_lines.right(y_proj)] |= bit;
                           }
                       }
                   }
@@ -156,29 +239,29 @@ public:
               {
                 if(is_via_blockage)
                   {
-                    m_v_lines[x_proj].m_pins[y_proj].m_status = details::AccessNode::Status::VIA_BLOCKAGE;
+                    m_v_lines.m_status[m_v_lines.index(x_proj, y_proj)] = details::AccessStatus::VIA_BLOCKAGE;
                   }
                 else
                   {
-                    m_v_lines[x_proj].m_pins[y_proj].m_blocked_metals.emplace(poly.m_metal);
+                    m_v_lines.m_blocked[m_v_lines.index(x_proj, y_proj)] |= bit;
 
-                    if(y_proj == m_v_lines[x_proj].m_pins.size() - 1)
+                    if(y_proj == m_v_lines.m_length - 1)
                       {
-                        m_v_lines[x_proj].m_right_pin.m_blocked_metals.emplace(metal);
+                        m_v_lines.m_blocked[m_v_lines.right(x_proj)] |= bit;
 
                         if(m_bottom != nullptr)
                           {
-                            m_bottom->m_v_lines[x_proj].m_left_pin.m_blocked_metals.emplace(metal);
+                            m_bottom->m_v_lines.m_blocked[m_bottom->m_v_lines.left(x_proj)] |= bit;
                           }
                       }
 
                     if(y_proj == 0)
                       {
-                        m_v_lines[x_proj].m_left_pin.m_blocked_metals.emplace(metal);
+                        m_v_lines.m_blocked[m_v_lines.left(x_proj)] |= bit;
 
                         if(m_top != nullptr)
                           {
-                            m_top->m_v_lines[x_proj].m_right_pin.m_blocked_metals.emplace(metal);
+                            m_top->m_v_lines.m_blocked[m_top->m_v_lines.right(x_proj)] |= bit;
                           }
                       }
                   }
@@ -202,25 +285,28 @@ public:
     geom::PointS        optimal_proj = { 0, 0 };
     double              min_cost     = __DBL_MAX__;
 
-    const auto          find_optimal = [&](details::AccessNode::Status status) {
+    const auto          find_optimal = [&](details::AccessStatus status) {
       bool found_place = false;
 
       for(const auto [point, proj] : pin->m_access_points.m_points)
         {
-          if(metal_idx % 2 == 0 && m_h_lines[proj.y].m_pins[proj.x].m_blocked_metals.count(metal) != 0)
+          const std::size_t h_node = m_h_lines.index(proj.y, proj.x);
+          const std::size_t v_node = m_v_lines.index(proj.x, proj.y);
+
+          if(metal_idx % 2 == 0 && m_h_lines.is_blocked(h_node, metal))
             {
               continue;
             }
 
-          if(metal_idx % 2 != 0 && m_v_lines[proj.x].m_pins[proj.y].m_blocked_metals.count(metal) != 0)
+          if(metal_idx % 2 != 0 && m_v_lines.is_blocked(v_node, metal))
             {
               continue;
             }
 
-          if((metal_idx % 2 == 0 && m_h_lines[proj.y].m_pins[proj.x].m_status == status) || (metal_idx % 2 != 0 && m_v_lines[proj.x].m_pins[proj.y].m_status == status))
+          if((metal_idx % 2 == 0 && m_h_lines.m_status[h_node] == status) || (metal_idx % 2 != 0 && m_v_lines.m_status[v_node] == status))
             {
-              const double cost_v = line_heuristic(m_v_lines[proj.x].m_assigned + 1);
-              const double cost_h = line_heuristic(m_h_lines[proj.y].m_assigned + 1);
+              const double cost_v = line_heuristic(m_v_lines.m_assigned[proj.x] + 1);
+              const double cost_h = line_heuristic(m_h_lines.m_assigned[proj.y] + 1);
 
               if(cost_v + cost_h < min_cost)
                 {
@@ -235,29 +321,29 @@ public:
       return found_place;
     };
 
-    if(!find_optimal(details::AccessNode::Status::FREE))
+    if(!find_optimal(details::AccessStatus::FREE))
       {
-        if(!find_optimal(details::AccessNode::Status::VIA_BLOCKAGE))
+        if(!find_optimal(details::AccessStatus::VIA_BLOCKAGE))
           {
             return false;
           }
 
         if(optimal_proj.x < m_v_lines.size() / 2)
           {
-            m_h_lines[optimal_proj.y].m_left_pin.m_status = details::AccessNode::Status::OCCUPIED;
+            m_h_lines.m_status[m_h_lines.left(optimal_proj.y)] = details::AccessStatus::OCCUPIED;
 
             if(m_left != nullptr)
               {
-                m_left->m_h_lines[optimal_proj.y].m_right_pin.m_status = details::AccessNode::Status::OCCUPIED;
+                m_left->m_h_lines.m_status[m_left->m_h_lines.right(optimal_proj.y)] = details::AccessStatus::OCCUPIED;
               }
           }
         else
           {
-            m_h_lines[optimal_proj.y].m_right_pin.m_status = details::AccessNode::Status::OCCUPIED;
+            m_h_lines.m_status[m_h_lines.right(optimal_proj.y)] = details::AccessStatus::OCCUPIED;
 
             if(m_right != nullptr)
               {
-                m_right->m_h_lines[optimal_proj.y].m_left_pin.m_status = details::AccessNode::Status::OCCUPIED;
+                m_right->m_h_lines.m_status[m_right->m_h_lines.left(optimal_proj.y)] = details::AccessStatus::OCCUPIED;
               }
           }
 
@@ -265,36 +351,34 @@ public:
           {
             if(optimal_proj.y < m_h_lines.size() / 2)
               {
-                m_v_lines[optimal_proj.x].m_left_pin.m_status = details::AccessNode::Status::OCCUPIED;
+                m_v_lines.m_status[m_v_lines.left(optimal_proj.x)] = details::AccessStatus::OCCUPIED;
 
                 if(m_top != nullptr)
                   {
-                    m_top->m_v_lines[optimal_proj.x].m_right_pin.m_status = details::AccessNode::Status::OCCUPIED;
+                    m_top->m_v_lines.m_status[m_top->m_v_lines.right(optimal_proj.x)] = details::AccessStatus::OCCUPIED;
                   }
               }
             else
               {
-                m_v_lines[optimal_proj.x].m_right_pin.m_status = details::AccessNode::Status::OCCUPIED;
+                m_v_lines.m_status[m_v_lines.right(optimal_proj.x)] = details::AccessStatus::OCCUPIED;
 
                 if(m_bottom != nullptr)
                   {
-                    m_bottom->m_v_lines[optimal_proj.x].m_left_pin.m_status = details::AccessNode::Status::OCCUPIED;
+                    m_bottom->m_v_lines.m_status[m_bottom->m_v_lines.left(optimal_proj.x)] = details::AccessStatus::OCCUPIED;
                   }
               }
           }
       }
 
-    const double old_v_cost                                   = line_heuristic(m_v_lines[optimal_proj.x].m_assigned);
-    m_v_lines[optimal_proj.x].m_pins[optimal_proj.y].m_ptr    = pin;
-    m_v_lines[optimal_proj.x].m_pins[optimal_proj.y].m_status = details::AccessNode::Status::OCCUPIED;
-    m_v_lines[optimal_proj.x].m_assigned += 1;
+    const double old_v_cost = line_heuristic(m_v_lines.m_assigned[optimal_proj.x]);
+    m_v_lines.occupy(m_v_lines.index(optimal_proj.x, optimal_proj.y), pin);
+    m_v_lines.m_assigned[optimal_proj.x] += 1;
 
-    const double old_h_cost                                   = line_heuristic(m_h_lines[optimal_proj.y].m_assigned);
-    m_h_lines[optimal_proj.y].m_pins[optimal_proj.x].m_ptr    = pin;
-    m_h_lines[optimal_proj.y].m_pins[optimal_proj.x].m_status = details::AccessNode::Status::OCCUPIED;
-    m_h_lines[optimal_proj.y].m_assigned += 1;
+    const double old_h_cost = line_heuristic(m_h_lines.m_assigned[optimal_proj.y]);
+    m_h_lines.occupy(m_h_lines.index(optimal_proj.y, optimal_proj.x), pin);
+    m_h_lines.m_assigned[optimal_proj.y] += 1;
 
-    m_cost               = m_cost - old_v_cost - old_h_cost + line_heuristic(m_v_lines[optimal_proj.x].m_assigned) + line_heuristic(m_h_lines[optimal_proj.y].m_assigned);
+    m_cost               = m_cost - old_v_cost - old_h_cost + line_heuristic(m_v_lines.m_assigned[optimal_proj.x]) + line_heuristic(m_h_lines.m_assigned[optimal_proj.y]);
 
     pin->m_ptr->m_center = optimal_real;
     pin->m_center        = optimal_proj;
@@ -329,6 +413,12 @@ public:
     double             min_cost     = __DBL_MAX__;
     bool               found_place  = true;
 
+    /** Checks whether a node is claimed by the net of the pin */
+    const auto         is_same_net  = [&](const details::AccessLines& lines, const std::size_t node) {
+      const Pin* ptr = lines.get_pin(node);
+      return lines.m_status[node] == details::AccessStatus::OCCUPIED && ptr && ptr->m_net == pin->m_net;
+    };
+
     for(const auto [point, proj] : pin->m_access_points.m_points)
       {
         const std::size_t x = metal_idx % 2 == 0 ? m_v_lines.size() - 1 : proj.x;
@@ -336,12 +426,14 @@ public:
 
         if(metal_idx % 2 == 0)
           {
-            if(m_h_lines[y].m_right_pin.m_status != details::AccessNode::Status::FREE && m_h_lines[y].m_right_pin.m_status != details::AccessNode::Status::VIA_BLOCKAGE)
+            const std::size_t side = m_h_lines.right(y);
+
+            if(m_h_lines.m_status[side] != details::AccessStatus::FREE && m_h_lines.m_status[side] != details::AccessStatus::VIA_BLOCKAGE)
               {
                 continue;
               }
 
-            if(m_h_lines[y].m_right_pin.m_blocked_metals.count(metal) != 0)
+            if(m_h_lines.is_blocked(side, metal))
               {
                 continue;
               }
@@ -349,22 +441,25 @@ public:
 
         if(metal_idx % 2 != 0)
           {
-            if(m_v_lines[x].m_right_pin.m_status != details::AccessNode::Status::FREE && m_v_lines[x].m_right_pin.m_status != details::AccessNode::Status::VIA_BLOCKAGE)
+            const std::size_t side = m_v_lines.right(x);
+
+            if(m_v_lines.m_status[side] != details::AccessStatus::FREE && m_v_lines.m_status[side] != details::AccessStatus::VIA_BLOCKAGE)
               {
                 continue;
               }
 
-            if(m_v_lines[x].m_right_pin.m_blocked_metals.count(metal) != 0)
+            if(m_v_lines.is_blocked(side, metal))
               {
                 continue;
               }
           }
 
         {
-          auto&                      line = metal_idx % 2 == 0 ? m_h_lines.at(y) : m_v_lines.at(x);
-          const details::AccessNode& node = line.m_assigned != 0 ? get_last_line_node(line) : line.m_right_pin;
+          const details::AccessLines& lines = metal_idx % 2 == 0 ? m_h_lines : m_v_lines;
+          const std::size_t           line  = metal_idx % 2 == 0 ? y : x;
+          const std::size_t           node  = lines.m_assigned.at(line) != 0 ? get_last_line_node(lines, line) : lines.right(line);
 
-          if(node.m_status == details::AccessNode::Status::OCCUPIED && node.m_ptr && node.m_ptr->m_net == pin->m_net)
+          if(is_same_net(lines, node))
             {
               optimal_proj = { x, y };
               optimal_real = point;
@@ -375,10 +470,10 @@ public:
 
         if(metal_idx % 2 == 0 && m_right)
           {
-            auto&                      line = m_right->m_h_lines.at(y);
-            const details::AccessNode& node = line.m_assigned != 0 ? get_first_line_node(line) : line.m_left_pin;
+            const details::AccessLines& lines = m_right->m_h_lines;
+            const std::size_t           node  = lines.m_assigned.at(y) != 0 ? get_first_line_node(lines, y) : lines.left(y);
 
-            if(node.m_status == details::AccessNode::Status::OCCUPIED && node.m_ptr && node.m_ptr->m_net == pin->m_net)
+            if(is_same_net(lines, node))
               {
                 optimal_proj = { x, y };
                 optimal_real = point;
@@ -389,10 +484,10 @@ public:
 
         if(metal_idx % 2 != 0 && m_bottom)
           {
-            auto&                      line = m_bottom->m_v_lines.at(x);
-            const details::AccessNode& node = line.m_assigned != 0 ? get_first_line_node(line) : line.m_left_pin;
+            const details::AccessLines& lines = m_bottom->m_v_lines;
+            const std::size_t           node  = lines.m_assigned.at(x) != 0 ? get_first_line_node(lines, x) : lines.left(x);
 
-            if(node.m_status == details::AccessNode::Status::OCCUPIED && node.m_ptr && node.m_ptr->m_net == pin->m_net)
+            if(is_same_net(lines, node))
               {
                 optimal_proj = { x, y };
                 optimal_real = point;
@@ -401,7 +496,7 @@ public:
               }
           }
 
-        const double cost = metal_idx % 2 == 0 ? line_heuristic(m_h_lines[y].m_assigned + 1) : line_heuristic(m_v_lines[x].m_assigned + 1);
+        const double cost = metal_idx % 2 == 0 ? line_heuristic(m_h_lines.m_assigned[y] + 1) : line_heuristic(m_v_lines.m_assigned[x] + 1);
 
         if(cost < min_cost)
           {
@@ -417,19 +512,18 @@ public:
         throw std::runtime_error("DEF AccessPointGrid Error: Unable to place right-cross-pin");
       }
 
-    auto& line                = metal_idx % 2 == 0 ? m_h_lines.at(optimal_proj.y) : m_v_lines.at(optimal_proj.x);
+    details::AccessLines& lines = metal_idx % 2 == 0 ? m_h_lines : m_v_lines;
+    const std::size_t     line  = metal_idx % 2 == 0 ? optimal_proj.y : optimal_proj.x;
 
-    line.m_right_pin.m_ptr    = pin;
-    line.m_right_pin.m_status = details::AccessNode::Status::OCCUPIED;
-    line.m_assigned += 1;
+    lines.occupy(lines.right(line), pin);
+    lines.m_assigned.at(line) += 1;
 
     /** Align pin to the gcell side */
     if(metal_idx % 2 == 0)
       {
         if(m_right != nullptr)
           {
-            m_right->m_h_lines[optimal_proj.y].m_left_pin.m_ptr    = pin;
-            m_right->m_h_lines[optimal_proj.y].m_left_pin.m_status = details::AccessNode::Status::OCCUPIED;
+            m_right->m_h_lines.occupy(m_right->m_h_lines.left(optimal_proj.y), pin);
           }
 
         optimal_real.x = pin->m_ptr->m_ports[0].m_points[0].x;
@@ -438,8 +532,7 @@ public:
       {
         if(m_bottom != nullptr)
           {
-            m_bottom->m_v_lines[optimal_proj.x].m_left_pin.m_ptr    = pin;
-            m_bottom->m_v_lines[optimal_proj.x].m_left_pin.m_status = details::AccessNode::Status::OCCUPIED;
+            m_bottom->m_v_lines.occupy(m_bottom->m_v_lines.left(optimal_proj.x), pin);
           }
 
         optimal_real.y = pin->m_ptr->m_ports[0].m_points[0].y;
@@ -471,18 +564,26 @@ public:
     double              min_cost            = __DBL_MAX__;
     bool                found_place         = false;
 
+    /** Checks whether a side node is claimed by another net */
+    const auto          is_foreign          = [](const details::AccessLines& lines, const std::size_t node, const Pin* pin) {
+      const Pin* ptr = lines.get_pin(node);
+      return lines.m_status[node] == details::AccessStatus::OCCUPIED && ptr != nullptr && ptr->m_net != pin->m_net;
+    };
+
     for(const auto [top_point, bottom_point, proj] : shared_access_points)
       {
         const std::size_t x                = proj.x;
         const std::size_t y                = proj.y;
+        const std::size_t h_node           = m_h_lines.index(y, x);
+        const std::size_t v_node           = m_v_lines.index(x, y);
 
-        const bool        is_blocked       = m_h_lines[y].m_pins[x].m_blocked_metals.count(bottom_metal) != 0 || m_v_lines[x].m_pins[y].m_blocked_metals.count(top_metal) != 0;
+        const bool        is_blocked       = m_h_lines.is_blocked(h_node, bottom_metal) || m_v_lines.is_blocked(v_node, top_metal);
 
-        const bool        is_occupied_h    = m_h_lines[y].m_pins[x].m_status == details::AccessNode::Status::OCCUPIED && m_h_lines[y].m_pins[x].m_ptr->m_net != bottom_pin->m_net;
-        const bool        is_occupied_v    = m_v_lines[x].m_pins[y].m_status == details::AccessNode::Status::OCCUPIED && m_v_lines[x].m_pins[y].m_ptr->m_net != top_pin->m_net;
+        const bool        is_occupied_h    = m_h_lines.m_status[h_node] == details::AccessStatus::OCCUPIED && m_h_lines.get_pin(h_node)->m_net != bottom_pin->m_net;
+        const bool        is_occupied_v    = m_v_lines.m_status[v_node] == details::AccessStatus::OCCUPIED && m_v_lines.get_pin(v_node)->m_net != top_pin->m_net;
 
-        const bool        is_via_blocked_h = m_h_lines[y].m_pins[x].m_status == details::AccessNode::Status::VIA_BLOCKAGE;
-        const bool        is_via_blocked_v = m_v_lines[x].m_pins[y].m_status == details::AccessNode::Status::VIA_BLOCKAGE;
+        const bool        is_via_blocked_h = m_h_lines.m_status[h_node] == details::AccessStatus::VIA_BLOCKAGE;
+        const bool        is_via_blocked_v = m_v_lines.m_status[v_node] == details::AccessStatus::VIA_BLOCKAGE;
 
         if(is_blocked || is_occupied_h || is_occupied_v)
           {
@@ -491,16 +592,16 @@ public:
 
         if(is_via_blocked_h)
           {
-            if(x > m_h_lines[y].m_pins.size() / 2)
+            if(x > m_h_lines.m_length / 2)
               {
-                if(m_h_lines[y].m_right_pin.m_status == details::AccessNode::Status::OCCUPIED && m_h_lines[y].m_right_pin.m_ptr != nullptr && m_h_lines[y].m_right_pin.m_ptr->m_net != bottom_pin->m_net)
+                if(is_foreign(m_h_lines, m_h_lines.right(y), bottom_pin))
                   {
                     continue;
                   }
               }
             else
               {
-                if(m_h_lines[y].m_left_pin.m_status == details::AccessNode::Status::OCCUPIED && m_h_lines[y].m_left_pin.m_ptr != nullptr && m_h_lines[y].m_left_pin.m_ptr->m_net != bottom_pin->m_net)
+                if(is_foreign(m_h_lines, m_h_lines.left(y), bottom_pin))
                   {
                     continue;
                   }
@@ -509,24 +610,24 @@ public:
 
         if(is_via_blocked_v)
           {
-            if(y > m_v_lines[x].m_pins.size() / 2)
+            if(y > m_v_lines.m_length / 2)
               {
-                if(m_v_lines[x].m_right_pin.m_status == details::AccessNode::Status::OCCUPIED && m_v_lines[x].m_right_pin.m_ptr != nullptr && m_v_lines[x].m_right_pin.m_ptr->m_net != top_pin->m_net)
+                if(is_foreign(m_v_lines, m_v_lines.right(x), top_pin))
                   {
                     continue;
                   }
               }
             else
               {
-                if(m_v_lines[x].m_left_pin.m_status == details::AccessNode::Status::OCCUPIED && m_v_lines[x].m_left_pin.m_ptr != nullptr && m_v_lines[x].m_left_pin.m_ptr->m_net != top_pin->m_net)
+                if(is_foreign(m_v_lines, m_v_lines.left(x), top_pin))
                   {
                     continue;
                   }
               }
           }
 
-        const double cost_v = line_heuristic(m_v_lines[x].m_assigned + 1);
-        const double cost_h = line_heuristic(m_h_lines[y].m_assigned + 1);
+        const double cost_v = line_heuristic(m_v_lines.m_assigned[x] + 1);
+        const double cost_h = line_heuristic(m_h_lines.m_assigned[y] + 1);
 
         if(cost_v + cost_h < min_cost)
           {
@@ -543,17 +644,15 @@ public:
         throw std::runtime_error("DEF AccessPointGrid Error: Unable to place between-stack-pin");
       }
 
-    const double old_h_cost                                   = line_heuristic(m_h_lines[optimal_proj.y].m_assigned);
-    m_h_lines[optimal_proj.y].m_pins[optimal_proj.x].m_ptr    = bottom_pin;
-    m_h_lines[optimal_proj.y].m_pins[optimal_proj.x].m_status = details::AccessNode::Status::OCCUPIED;
-    m_h_lines[optimal_proj.y].m_assigned += 1;
+    const double old_h_cost = line_heuristic(m_h_lines.m_assigned[optimal_proj.y]);
+    m_h_lines.occupy(m_h_lines.index(optimal_proj.y, optimal_proj.x), bottom_pin);
+    m_h_lines.m_assigned[optimal_proj.y] += 1;
 
-    const double old_v_cost                                   = line_heuristic(m_v_lines[optimal_proj.x].m_assigned);
-    m_v_lines[optimal_proj.x].m_pins[optimal_proj.y].m_ptr    = top_pin;
-    m_v_lines[optimal_proj.x].m_pins[optimal_proj.y].m_status = details::AccessNode::Status::OCCUPIED;
-    m_v_lines[optimal_proj.x].m_assigned += 1;
+    const double old_v_cost = line_heuristic(m_v_lines.m_assigned[optimal_proj.x]);
+    m_v_lines.occupy(m_v_lines.index(optimal_proj.x, optimal_proj.y), top_pin);
+    m_v_lines.m_assigned[optimal_proj.x] += 1;
 
-    m_cost                      = m_cost - old_v_cost - old_h_cost + line_heuristic(m_v_lines[optimal_proj.x].m_assigned) + line_heuristic(m_h_lines[optimal_proj.x].m_assigned);
+    m_cost                      = m_cost - old_v_cost - old_h_cost + line_heuristic(m_v_lines.m_assigned[optimal_proj.x]) + line_heuristic(m_h_lines.m_assigned[optimal_proj.x]);
 
     bottom_pin->m_ptr->m_center = optimal_real_bottom;
     bottom_pin->m_center        = optimal_proj;
@@ -563,7 +662,7 @@ public:
   }
 
   /**
-   * @brief Get obstacles for a metal layer.
+   * @brief Get obstacles for a metal layer, masks of a line are scanned as a contiguous block.
    *
    * @param metal
    * @return std::vector<geom::PointS>
@@ -571,31 +670,26 @@ public:
   std::vector<geom::PointS>
   get_obstacles(const types::Metal metal)
   {
-    const std::size_t         metal_idx = (uint8_t(metal) - 1) / 2 - 1;
-    std::vector<geom::PointS> points;
+    const std::size_t           metal_idx = (uint8_t(metal) - 1) / 2 - 1;
+    const uint32_t              bit       = details::metal_bit(metal);
+    const details::AccessLines& lines     = metal_idx % 2 == 0 ? m_h_lines : m_v_lines;
+    std::vector<geom::PointS>   points;
 
-    if(metal_idx % 2 == 0)
+    for(std::size_t line = 0, end_line = lines.size(); line < end_line; ++line)
       {
-        for(std::size_t y = 0, end_y = m_h_lines.size(); y < end_y; ++y)
+        const uint32_t* masks = lines.m_blocked.data() + lines.index(line, 0);
+
+        for(std::size_t node = 0, end_node = lines.m_length; node < end_node; ++node)
           {
-            for(std::size_t x = 0, end_x = m_h_lines[y].m_pins.size(); x < end_x; ++x)
+            if((masks[node] & bit) != 0)
               {
-                if(m_h_lines[y].m_pins[x].m_blocked_metals.count(metal) != 0)
+                if(metal_idx % 2 == 0)
                   {
-                    points.emplace_back(x, y);
+                    points.emplace_back(node, line);
                   }
-              }
-          }
-      }
-    else
-      {
-        for(std::size_t x = 0, end_x = m_v_lines.size(); x < end_x; ++x)
-          {
-            for(std::size_t y = 0, end_y = m_v_lines[x].m_pins.size(); y < end_y; ++y)
-              {
-                if(m_v_lines[x].m_pins[y].m_blocked_metals.count(metal) != 0)
+                else
                   {
-                    points.emplace_back(x, y);
+                    points.emplace_back(line, node);
                   }
               }
           }
@@ -644,13 +738,13 @@ private:
   geom::Point
   project_coordinate(const geom::Point& target) const noexcept(true)
   {
-    double projection_x = std::round((target.x - m_start.x) / m_step) * m_step + m_start.x;
-    projection_x        = std::max(projection_x, m_start.x);
-    projection_x        = std::min(projection_x, m_end.x);
+    geom::Coord projection_x = geom::to_coord(std::round((target.x - m_start.x) / m_step) * m_step + m_start.x);
+    projection_x             = std::max(projection_x, m_start.x);
+    projection_x             = std::min(projection_x, m_end.x);
 
-    double projection_y = std::round((target.y - m_start.y) / m_step) * m_step + m_start.y;
-    projection_y        = std::max(projection_y, m_start.y);
-    projection_y        = std::min(projection_y, m_end.y);
+    geom::Coord projection_y = geom::to_coord(std::round((target.y - m_start.y) / m_step) * m_step + m_start.y);
+    projection_y             = std::max(projection_y, m_start.y);
+    projection_y             = std::min(projection_y, m_end.y);
 
     return { projection_x, projection_y };
   }
@@ -668,43 +762,45 @@ private:
   };
 
   /**
-   * @brief Get the first node in a line.
+   * @brief Get the first occupied node in a line.
    *
-   * @param line
-   * @return const details::AccessNode&
+   * @param lines Lines of a grid.
+   * @param line The index of a line.
+   * @return std::size_t The index of a node.
    */
-  const details::AccessNode&
-  get_first_line_node(const details::AccessLine& line)
+  std::size_t
+  get_first_line_node(const details::AccessLines& lines, const std::size_t line)
   {
-    for(std::size_t i = 0, end = line.m_pins.size(); i < end; ++i)
+    for(std::size_t i = 0, end = lines.m_length; i < end; ++i)
       {
-        if(line.m_pins[i].m_status == details::AccessNode::Status::OCCUPIED)
+        if(lines.m_status[lines.index(line, i)] == details::AccessStatus::OCCUPIED)
           {
-            return line.m_pins.at(i);
+            return lines.index(line, i);
           }
       }
 
-    return line.m_pins.front();
+    return lines.index(line, 0);
   }
 
   /**
-   * @brief Get the last node in a line.
+   * @brief Get the last occupied node in a line.
    *
-   * @param line
-   * @return const details::AccessNode&
+   * @param lines Lines of a grid.
+   * @param line The index of a line.
+   * @return std::size_t The index of a node.
    */
-  const details::AccessNode&
-  get_last_line_node(const details::AccessLine& line)
+  std::size_t
+  get_last_line_node(const details::AccessLines& lines, const std::size_t line)
   {
-    for(std::size_t i = line.m_pins.size(), end = 0; i > end; --i)
+    for(std::size_t i = lines.m_length, end = 0; i > end; --i)
       {
-        if(line.m_pins[i - 1].m_status == details::AccessNode::Status::OCCUPIED)
+        if(lines.m_status[lines.index(line, i - 1)] == details::AccessStatus::OCCUPIED)
           {
-            return line.m_pins.at(i - 1);
+            return lines.index(line, i - 1);
           }
       }
 
-    return line.m_pins.front();
+    return lines.index(line, 0);
   }
 
 public:
@@ -715,14 +811,14 @@ public:
   AccessPointGrid* m_bottom = nullptr; ///> Bottom side neighbor, odd metal layers
 
 private:
-  geom::Point                      m_start;   ///> The start of a grid.
-  geom::Point                      m_end;     ///> The end of a grid.
-  double                           m_step;    ///> The step of a grid.
-  double                           m_cost;    ///> The cost of a grid.
-  std::vector<details::AccessLine> m_h_lines; ///> Horizontal lines(tracks)
-  std::vector<details::AccessLine> m_v_lines; ///> Vertical lines(tracks)
+  geom::Point          m_start;   ///> The start of a grid.
+  geom::Point          m_end;     ///> The end of a grid.
+  double               m_step;    ///> The step of a grid.
+  double               m_cost;    ///> The cost of a grid.
+  details::AccessLines m_h_lines; ///> Horizontal lines(tracks)
+  details::AccessLines m_v_lines; ///> Vertical lines(tracks)
 };
 
 } // namespace def
 
-#endif
\ No newline at end of file
+#endif
@@ -38,6 +38,12 @@ struct GCellGridTemplate
   uint32_t m_num;
 };
 
+struct WireTemplate
+{
+  std::array<int32_t, 4UL> m_box;   ///> Opposite corners of a segment, widened by the wire width and a margin.
+  types::Metal             m_metal;
+};
+
 struct ComponentTemplate
 {
   std::string        m_id;
@@ -53,6 +59,7 @@ struct Data
   std::array<uint32_t, 4UL>                  m_box;
   std::vector<ComponentTemplate>             m_components;
   std::vector<geom::Polygon>                 m_obstacles;
+  std::vector<WireTemplate>                  m_wires; ///> Segments of special nets, they are assigned to gcells after parsing.
 
   /** Pins related */
   std::unordered_map<std::string, pin::Pin*> m_pins;
@@ -66,6 +73,7 @@ struct Data
   std::size_t                                m_max_gcell_x;
   std::size_t                                m_max_gcell_y;
   std::vector<std::vector<GCell*>>           m_gcells;
+  GCellIndex                                 m_gcell_index; ///> Index of the full grid, rows of gcells match it until empty gcells are removed.
 };
 
 class DEF
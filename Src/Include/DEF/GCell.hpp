@@ -2,6 +2,7 @@
 #define __GCELL_HPP__
 
 #include "Include/DEF/AccessPointGrid.hpp"
+#include "Include/DEF/GCellIndex.hpp"
 #include "Include/DEF/Stack.hpp"
 
 namespace def
@@ -36,12 +37,11 @@ public:
    *
    * @param poly A polygon.
    * @param gcells A gcell grid.
-   * @param width The width of a single gcell.
-   * @param height The height of a single gcell.
+   * @param index The index of a gcell grid.
    * @return std::vector<std::pair<GCell*, geom::Polygon>>
    */
   static std::vector<std::pair<GCell*, geom::Polygon>>
-  find_overlaps(const geom::Polygon& poly, const std::vector<std::vector<GCell*>>& gcells, const uint32_t width, const uint32_t height);
+  find_overlaps(const geom::Polygon& poly, const std::vector<std::vector<GCell*>>& gcells, const GCellIndex& index);
 
   static void
   connect(GCell* lhs, GCell* rhs, types::Metal metal)
@@ -72,7 +72,7 @@ public:
 
 public:
   void
-  set_base(const geom::Point& start, const geom::Point& end, const double step, const std::size_t total_layers)
+  set_base(const geom::Point& start, const geom::Point& end, const geom::Coord step, const std::size_t total_layers)
   {
     m_access_point_grid = new AccessPointGrid(start, end, step);
     m_stacks.resize(std::ceil(total_layers / 2.0));
@@ -81,7 +81,7 @@ public:
   }
 
   void
-  add_track(const geom::Point& start, const geom::Point& end, const double step, const types::Metal metal)
+  add_track(const geom::Point& start, const geom::Point& end, const geom::Coord step, const types::Metal metal)
   {
     m_grids[metal] = { start, end, step };
   }
@@ -422,7 +422,7 @@ public:
   }
 
 public:
-  bool                                                                m_is_error;
+  bool                                                                m_is_error = false;            ///> Is any pin of the gcell failed to be placed.
   std::size_t                                                         m_x;                           ///> Position by x axis in gcell grid.
   std::size_t                                                         m_y;                           ///> Position by y axis in gcell grid.
   geom::Polygon                                                       m_box;                         ///> Bounding box of the gcell.
@@ -0,0 +1,78 @@
+#ifndef __GCELL_INDEX_HPP__
+#define __GCELL_INDEX_HPP__
+
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include "Include/Geometry.hpp"
+
+namespace def
+{
+
+struct CellRange
+{
+  std::size_t m_left;   ///> The first column.
+  std::size_t m_top;    ///> The first row.
+  std::size_t m_right;  ///> The last column, inclusive.
+  std::size_t m_bottom; ///> The last row, inclusive.
+};
+
+/**
+ * @brief Index over boundaries of a gcell grid, finds covered cells by binary search, so grids with non-uniform steps are
+ * handled the same way as uniform ones.
+ */
+class GCellIndex
+{
+public:
+  GCellIndex() = default;
+
+  /**
+   * @brief Construct a new GCellIndex.
+   *
+   * @param columns Sorted x coordinates of gcell edges.
+   * @param rows Sorted y coordinates of gcell edges.
+   */
+  GCellIndex(std::vector<double> columns, std::vector<double> rows)
+      : m_columns(std::move(columns)), m_rows(std::move(rows)) {};
+
+public:
+  /**
+   * @brief Finds the range of cells covered by a box, cells are half-open so a box touching a cell by its edge doesn't cover it.
+   *
+   * @param left_top The left top corner of a box.
+   * @param right_bottom The right bottom corner of a box.
+   * @return std::optional<CellRange> Nothing if a box is outside of the grid.
+   */
+  std::optional<CellRange>
+  find_range(const geom::Point& left_top, const geom::Point& right_bottom) const;
+
+  /**
+   * @brief Finds the cell that contains a point.
+   *
+   * @param point The point.
+   * @return std::optional<std::pair<std::size_t, std::size_t>> The column and the row of a cell, nothing if a point is outside of the grid.
+   */
+  std::optional<std::pair<std::size_t, std::size_t>>
+  find_cell(const geom::Point& point) const;
+
+  const std::vector<double>&
+  get_columns() const noexcept(true)
+  {
+    return m_columns;
+  }
+
+  const std::vector<double>&
+  get_rows() const noexcept(true)
+  {
+    return m_rows;
+  }
+
+private:
+  std::vector<double> m_columns; ///> Sorted x coordinates of gcell edges.
+  std::vector<double> m_rows;    ///> Sorted y coordinates of gcell edges.
+};
+
+} // namespace def
+
+#endif
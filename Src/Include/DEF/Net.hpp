@@ -2,6 +2,7 @@
 #define __NET_HPP__
 
 #include <string>
+#include <unordered_set>
 #include <vector>
 
 namespace def
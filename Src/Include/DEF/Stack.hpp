@@ -1,6 +1,9 @@
 #ifndef __STACK_HPP__
 #define __STACK_HPP__
 
+#include <algorithm>
+#include <optional>
+
 #include "Include/DEF/Pin.hpp"
 #include "Include/Graph.hpp"
 #include "Include/Matrix.hpp"
@@ -98,24 +101,227 @@ public:
     return m_nets.empty();
   }
 
+  /**
+   * @brief Get nets in order they were added to a stack, the order doesn't depend on the layout of the hash map.
+   *
+   * @return std::vector<const details::Net*>
+   */
+  std::vector<const details::Net*>
+  get_ordered_nets() const
+  {
+    std::vector<const details::Net*> nets;
+    nets.reserve(m_nets.size());
+
+    for(const auto& [_, net] : m_nets)
+      {
+        nets.emplace_back(&net);
+      }
+
+    std::sort(nets.begin(), nets.end(), [](const details::Net* lhs, const details::Net* rhs) { return lhs->m_idx < rhs->m_idx; });
+
+    return nets;
+  }
+
   void
   add_obstacle(const std::vector<geom::PointS>& points)
   {
     m_obstacles.emplace_back(std::move(points));
   }
 
+  const std::map<types::Metal, utils::MetalGrid, utils::MetalGrid::Compare>&
+  get_all_grids() const noexcept(true)
+  {
+    return m_all_grids;
+  }
+
+  const std::vector<utils::MetalGrid>&
+  get_used_grids() const noexcept(true)
+  {
+    return m_used_grids;
+  }
+
+  const std::vector<types::Metal>&
+  get_used_metals() const noexcept(true)
+  {
+    return m_used_metals;
+  }
+
+  const std::vector<std::vector<geom::PointS>>&
+  get_obstacles() const noexcept(true)
+  {
+    return m_obstacles;
+  }
+
+  /**
+   * @brief Creates the matrix of a chunk, grids and obstacles are placed into the base matrix by the first chunk and copied by the others.
+   *
+   * @param size The size of a chunk.
+   * @param step The number of cells per a track.
+   */
   void
   create_matrix(const std::size_t size, const std::size_t step)
   {
     constexpr std::size_t CROSS_PIN_PADDING = 2;
-    constexpr std::size_t INDEX_SHIFT       = 1;
 
-    auto [size_x, size_y]                   = utils::project<geom::PointS>(m_all_grids.at(types::Metal::M1).m_end, m_all_grids.at(types::Metal::M1));
+    const auto [size_x, size_y]             = utils::project<geom::PointS>(m_all_grids.at(types::Metal::M1).m_end, m_all_grids.at(types::Metal::M1));
     const geom::PointS end_base             = { size_x, size_y };
 
-    size_x                                  = size_x * step + INDEX_SHIFT + CROSS_PIN_PADDING;
-    size_y                                  = size_y * step + INDEX_SHIFT + CROSS_PIN_PADDING;
-    m_matrix                                = matrix::Matrix({ size_x, size_y, 2 });
+    if(m_base_matrix.size() == 0)
+      {
+        create_base_matrix(end_base, step);
+      }
+
+    /** Chunks of a stack have the same shape, so the matrix of the previous chunk is reused */
+    if(m_matrix.m_shape != m_base_matrix.m_shape)
+      {
+        matrix::Pool<>::local().release(std::move(m_matrix));
+        m_matrix = matrix::Pool<>::local().acquire(m_base_matrix.m_shape);
+      }
+
+    std::copy_n(m_base_matrix.data(), m_base_matrix.size(), m_matrix.data());
+
+    /** Place pins */
+    for(auto& [_, net] : m_nets)
+      {
+        for(const auto pin : net.m_pins)
+          {
+            const types::Metal metal     = pin->m_access_points.m_metal;
+            const std::size_t  metal_idx = (uint8_t(metal) - 1) / 2 - 1;
+
+            geom::PointS       pos       = { pin->m_center.x * step, pin->m_center.y * step };
+
+            if(pin->m_type != Pin::Type::CROSS)
+              {
+                ++pos.x;
+                ++pos.y;
+              }
+            else
+              {
+                if(metal_idx % 2 == 0)
+                  {
+                    ++pos.y;
+
+                    if(pos.x == end_base.x * step)
+                      {
+                        pos.x += CROSS_PIN_PADDING;
+                      }
+                  }
+                else
+                  {
+                    ++pos.x;
+
+                    if(pos.y == end_base.y * step)
+                      {
+                        pos.y += CROSS_PIN_PADDING;
+                      }
+                  }
+              }
+
+            pin->m_matrix_pos = { pos.x, pos.y };
+            m_matrix(pos.x, pos.y, metal_idx % 2) = double(types::Cell::TERMINAL);
+
+            net.m_terminals.emplace(pos.x, pos.y, metal_idx % 2);
+            m_terminals.emplace(pos.x, pos.y, metal_idx % 2);
+          }
+      }
+  }
+
+  /**
+   * @brief Creates the graph of a chunk. The base graph of grids and obstacles is built by the first chunk, the others only add an overlay
+   * of nodes and edges changed by their terminals and drop it afterwards.
+   *
+   */
+  void
+  create_graph()
+  {
+    std::vector<graph::Edge> edges;
+
+    if(!m_graph.is_frozen())
+      {
+        m_node_ids.assign(m_base_matrix.size(), graph::Graph::NONE);
+        m_nodes.clear();
+
+        add_seeds(m_base_matrix);
+        sweep(m_base_matrix, 0, edges);
+        build_graph(edges);
+
+        m_graph.freeze();
+      }
+    else
+      {
+        for(const std::size_t idx : m_overlay_ids)
+          {
+            m_node_ids[idx] = graph::Graph::NONE;
+          }
+
+        m_overlay_ids.clear();
+        m_graph.discard_overlay();
+        m_nodes.resize(m_graph.nodes_count());
+      }
+
+    const uint32_t front = m_nodes.size();
+
+    for(const auto& terminal : m_terminals)
+      {
+        add_terminal(terminal, edges);
+      }
+
+    sweep(m_matrix, front, edges);
+    build_graph(edges);
+  }
+
+  /**
+   * @brief Returns matrices to the pool of this thread and drops the graph, the stack is rebuilt from scratch afterwards.
+   *
+   */
+  void
+  release()
+  {
+    matrix::Pool<>::local().release(std::move(m_matrix));
+    matrix::Pool<>::local().release(std::move(m_base_matrix));
+
+    m_graph.clear();
+    m_nodes.clear();
+    m_node_ids.clear();
+    m_overlay_ids.clear();
+  }
+
+  /**
+   * @brief Finds the graph node at a position of the matrix.
+   *
+   * @param node The position.
+   * @return uint32_t The index of a graph node, graph::Graph::NONE if there is no node at the position.
+   */
+  uint32_t
+  find_node(const matrix::Node& node) const
+  {
+    if(node.m_x >= m_matrix.m_shape.m_x || node.m_y >= m_matrix.m_shape.m_y || node.m_z >= m_matrix.m_shape.m_z)
+      {
+        return graph::Graph::NONE;
+      }
+
+    return m_node_ids[(std::size_t(node.m_y) * m_matrix.m_shape.m_x + node.m_x) * m_matrix.m_shape.m_z + node.m_z];
+  }
+
+public:
+  matrix::Matrix<>                                     m_matrix;    ///> Level sized matrix.
+  graph::Graph                                         m_graph;     ///> Graph that represent the matrix.
+  std::vector<matrix::Node>                            m_nodes;     ///> Map node to position on the matrix.
+  std::vector<uint32_t>                                m_node_ids;  ///> Map position on matrix to the graph nodes, laid out as the matrix.
+  matrix::SetOfNodes                                   m_terminals; ///> All terminals of all nets.
+  std::unordered_map<Net*, details::Net, Net::HashPtr> m_nets;      ///> All nets within a stack.
+
+private:
+  void
+  create_base_matrix(const geom::PointS& end_base, const std::size_t step)
+  {
+    constexpr std::size_t CROSS_PIN_PADDING = 2;
+    constexpr std::size_t INDEX_SHIFT       = 1;
+
+    const std::size_t     size_x            = end_base.x * step + INDEX_SHIFT + CROSS_PIN_PADDING;
+    const std::size_t     size_y            = end_base.y * step + INDEX_SHIFT + CROSS_PIN_PADDING;
+
+    m_base_matrix                           = matrix::Pool<>::local().acquire({ size_x, size_y, 2 });
 
     /** Place grids */
     for(std::size_t z = 0, end_z = m_used_grids.size(); z < end_z; ++z)
@@ -130,25 +336,25 @@ public:
 
         if(z % 2 == 0)
           {
-            for(double y = grid.m_start.y; y <= grid.m_end.y; y += grid.m_step)
+            for(geom::Coord y = grid.m_start.y; y <= grid.m_end.y; y += grid.m_step)
               {
                 const geom::PointS proj_int = utils::project_down<geom::PointS>({ grid.m_start.x, y }, metal, m_all_grids);
 
                 for(std::size_t x = INDEX_SHIFT; x <= end_base.x * step + 1; ++x)
                   {
-                    m_matrix.set_at(double(types::Cell::PATH), x, proj_int.y * step + 1, z);
+                    m_base_matrix(x, proj_int.y * step + 1, z) = double(types::Cell::PATH);
                   }
               }
           }
         else
           {
-            for(double x = grid.m_start.x; x <= grid.m_end.x; x += grid.m_step)
+            for(geom::Coord x = grid.m_start.x; x <= grid.m_end.x; x += grid.m_step)
               {
                 const geom::PointS proj_int = utils::project_down<geom::PointS>({ x, grid.m_start.y }, metal, m_all_grids);
 
                 for(std::size_t y = INDEX_SHIFT; y <= end_base.y * step + 1; ++y)
                   {
-                    m_matrix.set_at(double(types::Cell::PATH), proj_int.x * step + 1, y, z);
+                    m_base_matrix(proj_int.x * step + 1, y, z) = double(types::Cell::PATH);
                   }
               }
           }
@@ -172,8 +378,8 @@ public:
 
             if(end_point.x - start_point.x > 1 || end_point.y - start_point.y > 1)
               {
-                m_matrix.set_at(0, start_point.x * step + 1, start_point.y * step + 1, z);
-                m_matrix.set_at(0, end_point.x * step + 1, end_point.y * step + 1, z);
+                m_base_matrix(start_point.x * step + 1, start_point.y * step + 1, z) = 0;
+                m_base_matrix(end_point.x * step + 1, end_point.y * step + 1, z) = 0;
                 continue;
               }
 
@@ -181,192 +387,246 @@ public:
               {
                 for(std::size_t x = start_point.x * step + 1; x <= end_point.x * step + 1; ++x)
                   {
-                    m_matrix.set_at(0, x, y, z);
+                    m_base_matrix(x, y, z) = 0;
                   }
               }
           }
       }
+  }
 
-    /** Place pins */
-    for(auto& [_, net] : m_nets)
+  /**
+   * @brief Adds a node at a position of the matrix if there is no node yet, nodes added to the frozen graph are remembered to be dropped.
+   *
+   * @return uint32_t The index of the node.
+   */
+  uint32_t
+  add_node(const uint32_t x, const uint32_t y, const uint32_t z)
+  {
+    const std::size_t idx = (std::size_t(y) * m_base_matrix.m_shape.m_x + x) * m_base_matrix.m_shape.m_z + z;
+    uint32_t&         id  = m_node_ids[idx];
+
+    if(id == graph::Graph::NONE)
       {
-        for(const auto pin : net.m_pins)
+        id = m_nodes.size();
+        m_nodes.push_back(matrix::Node{ x, y, z });
+
+        if(m_graph.is_frozen())
           {
-            const types::Metal metal     = pin->m_access_points.m_metal;
-            const std::size_t  metal_idx = (uint8_t(metal) - 1) / 2 - 1;
+            m_overlay_ids.push_back(idx);
+          }
+      }
 
-            geom::PointS       pos       = { pin->m_center.x * step, pin->m_center.y * step };
+    return id;
+  }
 
-            if(pin->m_type != Pin::Type::CROSS)
+  /** Cells where both layers are open are seeds of the sweep */
+  void
+  add_seeds(const matrix::Matrix<>& source)
+  {
+    for(uint32_t x = 0; x < source.m_shape.m_x; ++x)
+      {
+        for(uint32_t y = 0; y < source.m_shape.m_y; ++y)
+          {
+            if(source(x, y, 0) != 0 && source(x, y, 1) != 0)
               {
-                ++pos.x;
-                ++pos.y;
+                add_node(x, y, 0);
               }
-            else
-              {
-                if(metal_idx % 2 == 0)
-                  {
-                    ++pos.y;
+          }
+      }
+  }
 
-                    if(pos.x == end_base.x * step)
-                      {
-                        pos.x += CROSS_PIN_PADDING;
-                      }
-                  }
-                else
-                  {
-                    ++pos.x;
+  /**
+   * @brief Moves from a position in a direction until a via or a terminal is met.
+   *
+   * @param source The matrix.
+   * @param from The start position.
+   * @return std::optional<matrix::Node> The position of a via or a terminal, nothing if a blocked cell or a border is met first.
+   */
+  static std::optional<matrix::Node>
+  cast_ray(const matrix::Matrix<>& source, const matrix::Node& from, const int32_t dx, const int32_t dy, const int32_t dz)
+  {
+    const uint32_t size_x = source.m_shape.m_x;
+    const uint32_t size_y = source.m_shape.m_y;
+    const uint32_t size_z = source.m_shape.m_z;
 
-                    if(pos.y == end_base.y * step)
-                      {
-                        pos.y += CROSS_PIN_PADDING;
-                      }
-                  }
-              }
+    uint32_t       new_x  = from.m_x;
+    uint32_t       new_y  = from.m_y;
+    uint32_t       new_z  = from.m_z;
 
-            pin->m_matrix_pos = { pos.x, pos.y };
-            m_matrix.set_at(double(types::Cell::TERMINAL), pos.x, pos.y, metal_idx % 2);
+    while(true)
+      {
+        if((dx > 0 && new_x < size_x - 1) || (dx < 0 && new_x > 0))
+          {
+            new_x += dx;
+          }
+        else if(dx != 0)
+          {
+            return std::nullopt;
+          }
 
-            net.m_terminals.emplace(pos.x, pos.y, metal_idx % 2);
-            m_terminals.emplace(pos.x, pos.y, metal_idx % 2);
+        if((dy > 0 && new_y < size_y - 1) || (dy < 0 && new_y > 0))
+          {
+            new_y += dy;
+          }
+        else if(dy != 0)
+          {
+            return std::nullopt;
+          }
+
+        if((dz > 0 && new_z < size_z - 1) || (dz < 0 && new_z > 0))
+          {
+            new_z += dz;
+          }
+        else if(dz != 0)
+          {
+            return std::nullopt;
+          }
+
+        const uint8_t next_matrix_value = source(new_x, new_y, new_z);
+        const bool    is_via            = new_z % 2 == 0 ? source(new_x, new_y, 1) != 0 : source(new_x, new_y, 0) != 0;
+
+        if(is_via || next_matrix_value == uint8_t(types::Cell::TERMINAL))
+          {
+            return matrix::Node{ new_x, new_y, new_z };
+          }
+
+        if(next_matrix_value == 0)
+          {
+            return std::nullopt;
           }
       }
-  };
+  }
 
+  /** Adds an edge from a node to the end of its ray if there is one */
   void
-  create_graph()
+  connect(const matrix::Matrix<>& source, const uint32_t node, const int32_t dx, const int32_t dy, const int32_t dz, std::vector<graph::Edge>& edges)
+  {
+    const matrix::Node                from = m_nodes[node];
+    const std::optional<matrix::Node> to   = cast_ray(source, from, dx, dy, dz);
+
+    if(to)
+      {
+        const uint32_t weight = to->m_z != from.m_z ? 4 * std::max(to->m_z, from.m_z) : (std::max(to->m_x, from.m_x) - std::min(to->m_x, from.m_x)) + (std::max(to->m_y, from.m_y) - std::min(to->m_y, from.m_y));
+        edges.emplace_back(weight, node, add_node(to->m_x, to->m_y, to->m_z));
+      }
+  }
+
+  /** Discovered nodes are appended to m_nodes, so it's the queue of the sweep as well */
+  void
+  sweep(const matrix::Matrix<>& source, const uint32_t front, std::vector<graph::Edge>& edges)
+  {
+    for(uint32_t node = front; node < m_nodes.size(); ++node)
+      {
+        if(m_nodes[node].m_z % 2 == 0)
+          {
+            connect(source, node, 1, 0, 0, edges);
+            connect(source, node, -1, 0, 0, edges);
+          }
+        else
+          {
+            connect(source, node, 0, 1, 0, edges);
+            connect(source, node, 0, -1, 0, edges);
+          }
+
+        connect(source, node, 0, 0, 1, edges);
+        connect(source, node, 0, 0, -1, edges);
+      }
+  }
+
+  /**
+   * @brief Updates the overlay for a terminal of a chunk. The base matrix has no terminals, so a terminal only adds a via to the layers
+   * where the other layer was blocked. Rays of base nodes that crossed such a cell are cast again, the rest is left to the sweep.
+   *
+   * @param terminal The terminal.
+   * @param edges Edges of the overlay.
+   */
+  void
+  add_terminal(const matrix::Node& terminal, std::vector<graph::Edge>& edges)
   {
-    std::queue<matrix::Node> queue;
+    const uint32_t x = terminal.m_x;
+    const uint32_t y = terminal.m_y;
+
+    if(x >= m_base_matrix.m_shape.m_x || y >= m_base_matrix.m_shape.m_y)
+      {
+        return;
+      }
 
-    for(uint8_t x = 0; x < m_matrix.m_shape.m_x; ++x)
+    for(uint32_t z = 0; z < 2; ++z)
       {
-        for(uint8_t y = 0; y < m_matrix.m_shape.m_y; ++y)
+        if(m_base_matrix(x, y, 1 - z) != 0)
           {
-            if(m_matrix.get_at(x, y, 0) != 0 && m_matrix.get_at(x, y, 1) != 0)
+            continue;
+          }
+
+        const int32_t dx = z == 0 ? 1 : 0;
+        const int32_t dy = z == 0 ? 0 : 1;
+
+        for(const int32_t sign : { 1, -1 })
+          {
+            const std::optional<matrix::Node> base_stop = cast_ray(m_base_matrix, { x, y, z }, sign * dx, sign * dy, 0);
+
+            if(!base_stop)
               {
-                const matrix::Node new_node{ x, y, 0 };
+                continue;
+              }
+
+            const uint32_t node = find_node(*base_stop);
 
-                m_node_map[new_node] = m_nodes.size();
-                m_nodes.emplace_back(new_node);
-                m_graph.place_node();
-                queue.push(new_node);
+            if(node == graph::Graph::NONE || node >= m_graph.nodes_count())
+              {
+                continue;
               }
+
+            if(const std::optional<matrix::Node> old_end = cast_ray(m_base_matrix, *base_stop, -sign * dx, -sign * dy, 0))
+              {
+                m_graph.disable_edge(node, find_node(*old_end));
+              }
+
+            connect(m_matrix, node, -sign * dx, -sign * dy, 0, edges);
           }
       }
 
-    const auto add_edge = [&](const matrix::Node& front, const matrix::Node next_node, const uint32_t weight) {
-      uint32_t dest_idx;
-
-      if(m_node_map.count(next_node) == 0)
-        {
-          dest_idx              = m_nodes.size();
-
-          m_node_map[next_node] = m_nodes.size();
-          m_nodes.push_back(next_node);
-          m_graph.place_node();
-          queue.push(next_node);
-        }
-      else
-        {
-          dest_idx = m_node_map[next_node];
-        }
-
-      const uint32_t source_idx = m_node_map[front];
-
-      m_graph.add_edge(weight, source_idx, dest_idx);
-    };
-
-    const auto search_direction = [&](int8_t dx, int8_t dy, int8_t dz, const matrix::Node& front) {
-      uint8_t        x            = front.m_x;
-      uint8_t        y            = front.m_y;
-      uint8_t        z            = front.m_z;
-
-      const uint8_t& matrix_value = m_matrix.get_at(x, y, z);
-
-      uint8_t        new_x        = x;
-      uint8_t        new_y        = y;
-      uint8_t        new_z        = z;
-
-      while(true)
-        {
-          if((dx > 0 && new_x < m_matrix.m_shape.m_x - 1) || (dx < 0 && new_x > 0))
-            {
-              new_x += dx;
-            }
-          else if(dx != 0)
-            {
-              break;
-            }
-
-          if((dy > 0 && new_y < m_matrix.m_shape.m_y - 1) || dy < 0 && new_y > 0)
-            {
-              new_y += dy;
-            }
-          else if(dy != 0)
-            {
-              break;
-            }
-
-          if((dz > 0 && new_z < m_matrix.m_shape.m_z - 1) || dz < 0 && new_z > 0)
-            {
-              new_z += dz;
-            }
-          else if(dz != 0)
-            {
-              break;
-            }
-
-          const uint8_t& next_matrix_value = m_matrix.get_at(new_x, new_y, new_z);
-          bool           is_via            = new_z % 2 == 0 ? m_matrix.get_at(new_x, new_y, 1) != 0 : m_matrix.get_at(new_x, new_y, 0) != 0;
-
-          if(is_via || next_matrix_value == uint8_t(types::Cell::TERMINAL))
-            {
-              const uint32_t weight = new_z != z ? 4 * std::max(new_z, z) : (std::abs(new_x - x) + std::abs(new_y - y));
-              add_edge(front, { new_x, new_y, new_z }, weight);
-              break;
-            }
-
-          if(next_matrix_value == 0)
-            {
-              break;
-            }
-        }
-    };
-
-    while(!queue.empty())
+    for(uint32_t z = 0; z < 2; ++z)
       {
-        const auto front = queue.front();
-        queue.pop();
+        const uint32_t node = find_node({ x, y, z });
 
-        if(front.m_z % 2 == 0)
+        if(node != graph::Graph::NONE && node < m_graph.nodes_count())
           {
-            search_direction(1, 0, 0, front);
-            search_direction(-1, 0, 0, front);
-          }
-        else
-          {
-            search_direction(0, 1, 0, front);
-            search_direction(0, -1, 0, front);
+            connect(m_matrix, node, 0, 0, z == 0 ? 1 : -1, edges);
           }
+      }
 
-        search_direction(0, 0, 1, front);
-        search_direction(0, 0, -1, front);
+    if(m_matrix(x, y, 0) != 0 && m_matrix(x, y, 1) != 0)
+      {
+        add_node(x, y, 0);
       }
   }
 
-public:
-  matrix::Matrix                                       m_matrix;    ///> Level sized matrix.
-  graph::Graph                                         m_graph;     ///> Graph that represent the matrix.
-  std::vector<matrix::Node>                            m_nodes;     ///> Map node to position on the matrix.
-  matrix::MapOfNodes                                   m_node_map;  ///> Map position on matrix to the graph nodes.
-  matrix::SetOfNodes                                   m_terminals; ///> All terminals of all nets.
-  std::unordered_map<Net*, details::Net, Net::HashPtr> m_nets;      ///> All nets within a stack.
+  /** Places nodes added since the last call and adds collected edges */
+  void
+  build_graph(std::vector<graph::Edge>& edges)
+  {
+    for(std::size_t i = m_graph.nodes_count(), end = m_nodes.size(); i < end; ++i)
+      {
+        m_graph.place_node();
+      }
+
+    for(const auto& edge : edges)
+      {
+        m_graph.add_edge(edge.m_weight, edge.m_source, edge.m_destination);
+      }
+
+    edges.clear();
+  }
 
 private:
-  std::vector<utils::MetalGrid>                                       m_used_grids; ///> Metal grids used by this stack.
+  matrix::Matrix<>                                                    m_base_matrix; ///> Grids and obstacles of the stack without terminals.
+  std::vector<std::size_t>                                            m_overlay_ids; ///> Positions of nodes of the overlay in m_node_ids.
+
+  std::vector<utils::MetalGrid>                                       m_used_grids;  ///> Metal grids used by this stack.
   std::vector<types::Metal>                                           m_used_metals;
-  std::map<types::Metal, utils::MetalGrid, utils::MetalGrid::Compare> m_all_grids; ///> All available metal grids.
-  std::vector<std::vector<geom::PointS>>                              m_obstacles; ///> Obstacles for each grid.
+  std::map<types::Metal, utils::MetalGrid, utils::MetalGrid::Compare> m_all_grids;   ///> All available metal grids.
+  std::vector<std::vector<geom::PointS>>                              m_obstacles;   ///> Obstacles for each grid.
 };
 
 } // namespace def
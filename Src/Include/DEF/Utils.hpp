@@ -2,6 +2,7 @@
 #define __DEF_UTILS_HPP__
 
 #include <map>
+#include <type_traits>
 
 #include "Include/Geometry.hpp"
 
@@ -18,7 +19,7 @@ struct MetalGrid
 {
   geom::Point m_start;
   geom::Point m_end;
-  double      m_step;
+  geom::Coord m_step;
 
   struct Compare
   {
@@ -30,17 +31,34 @@ struct MetalGrid
   };
 };
 
+/** Rounds a coordinate to the nearest line of a grid, halfway cases are rounded away from the start as std::round does */
+inline geom::Coord
+snap(const geom::Coord value, const geom::Coord start, const geom::Coord step) noexcept(true)
+{
+  if constexpr(std::is_integral_v<geom::Coord>)
+    {
+      const geom::Coord offset = value - start;
+      const geom::Coord index  = offset >= 0 ? (2 * offset + step) / (2 * step) : -((step - 2 * offset) / (2 * step));
+
+      return index * step + start;
+    }
+  else
+    {
+      return std::round((value - start) / step) * step + start;
+    }
+}
+
 template <typename Tp>
 auto
 project(const geom::Point& point, const MetalGrid& grid) noexcept(true)
 {
-  double proj_x = std::round((point.x - grid.m_start.x) / grid.m_step) * grid.m_step + grid.m_start.x;
-  proj_x        = std::max(proj_x, grid.m_start.x);
-  proj_x        = std::min(proj_x, grid.m_end.x);
+  geom::Coord proj_x = snap(point.x, grid.m_start.x, grid.m_step);
+  proj_x             = std::max(proj_x, grid.m_start.x);
+  proj_x             = std::min(proj_x, grid.m_end.x);
 
-  double proj_y = std::round((point.y - grid.m_start.y) / grid.m_step) * grid.m_step + grid.m_start.y;
-  proj_y        = std::max(proj_y, grid.m_start.y);
-  proj_y        = std::min(proj_y, grid.m_end.y);
+  geom::Coord proj_y = snap(point.y, grid.m_start.y, grid.m_step);
+  proj_y             = std::max(proj_y, grid.m_start.y);
+  proj_y             = std::min(proj_y, grid.m_end.y);
 
   if constexpr(std::is_same_v<Tp, geom::Point>)
     {
@@ -59,18 +77,18 @@ template <typename Tp>
 auto
 project_down(const geom::Point& point, const types::Metal source, const std::map<types::Metal, MetalGrid, MetalGrid::Compare>& grids) noexcept(true)
 {
-  double proj_x = point.x;
-  double proj_y = point.y;
+  geom::Coord proj_x = point.x;
+  geom::Coord proj_y = point.y;
 
   for(auto itr = grids.find(source), end = grids.end(); itr != end; --itr)
     {
       const MetalGrid& grid = itr->second;
 
-      proj_x                = std::round((proj_x - grid.m_start.x) / grid.m_step) * grid.m_step + grid.m_start.x;
+      proj_x                = snap(proj_x, grid.m_start.x, grid.m_step);
       proj_x                = std::max(proj_x, grid.m_start.x);
       proj_x                = std::min(proj_x, grid.m_end.x);
 
-      proj_y                = std::round((proj_y - grid.m_start.y) / grid.m_step) * grid.m_step + grid.m_start.y;
+      proj_y                = snap(proj_y, grid.m_start.y, grid.m_step);
       proj_y                = std::max(proj_y, grid.m_start.y);
       proj_y                = std::min(proj_y, grid.m_end.y);
     }
@@ -0,0 +1,471 @@
+#ifndef __DATASET_HPP__
+#define __DATASET_HPP__
+
+#include <atomic>
+#include <cstdint>
+#include <exception>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_set>
+#include <vector>
+
+#include "Include/Macro.hpp"
+#include "Include/Matrix.hpp"
+#include "Include/Parallel.hpp"
+
+namespace dataset::details
+{
+
+/**
+ * @brief The header of a record in a shard file, all fields are little-endian.
+ * A header is followed by the name, the nets text, padding up to 8 bytes, both cost maps, the path and padding up to 8 bytes.
+ */
+struct RecordHeader
+{
+  char     m_magic[4];      ///> The magic string "FLRC".
+  uint32_t m_version;       ///> The version of a record format.
+  char     m_cost_dtype[4]; ///> Numpy type descriptor of cost maps.
+  char     m_path_dtype[4]; ///> Numpy type descriptor of the path.
+  uint64_t m_x;             ///> The width of tensors.
+  uint64_t m_y;             ///> The height of tensors.
+  uint64_t m_z;             ///> The number of cost map layers.
+  uint64_t m_pins_count;    ///> The number of pins of all nets.
+  uint64_t m_nets_count;    ///> The number of nets.
+  uint64_t m_name_size;     ///> The size of the name in bytes.
+  uint64_t m_nets_size;     ///> The size of the nets text in bytes.
+  uint64_t m_cost_size;     ///> The size of a single cost map tensor in bytes.
+  uint64_t m_path_size;     ///> The size of the path tensor in bytes.
+};
+
+static_assert(sizeof(RecordHeader) == 88, "Unexpected padding of the record header");
+
+/**
+ * @brief An encoded tensor ready to be written.
+ */
+struct Tensor
+{
+  std::string              m_dtype; ///> Numpy type descriptor, "bits" for bit-packed masks.
+  std::vector<std::size_t> m_shape; ///> The shape of the tensor as it's saved.
+  std::vector<char>        m_data;  ///> Encoded data.
+};
+
+/**
+ * @brief An encoded sample, tensors are encoded by producers so the writer thread only writes bytes.
+ */
+struct Record
+{
+  std::string m_name;           ///> The name of a sample.
+  std::size_t m_chunk      = 0; ///> The number of a nets chunk within a stack.
+  std::string m_nets;           ///> Content of the nets file.
+  Tensor      m_cost_h;         ///> Horizontal cost maps.
+  Tensor      m_cost_v;         ///> Vertical cost maps.
+  Tensor      m_path;           ///> Target path.
+  std::size_t m_pins_count = 0; ///> The number of pins of all nets.
+  std::size_t m_nets_count = 0; ///> The number of nets.
+};
+
+struct EncodedBatch
+{
+  std::size_t         m_task = 0; ///> The index of a task produced records.
+  std::string         m_key;      ///> The key of a task in the journal.
+  std::vector<Record> m_records;  ///> Records in order of nets chunks.
+};
+
+} // namespace dataset::details
+
+namespace dataset
+{
+
+enum class Format
+{
+  NPY = 0, ///> Separate numpy files per sample, indexed by data.csv.
+  SHARD    ///> Few large append-only shard files with offset indices.
+};
+
+enum class CostType
+{
+  F64 = 0, ///> float64, values as they are computed.
+  F32,     ///> float32.
+  F16,     ///> float16, rounded to nearest even.
+  U8       ///> uint8, values in [0, 1] quantised to [0, 255].
+};
+
+enum class PathType
+{
+  F64 = 0, ///> float64 (y, x, 1) tensor.
+  U8,      ///> uint8 (y, x, 1) tensor.
+  BITS     ///> Two bit-packed planes (2, y, ceil(x / 8)), wires and vias, rows are packed like numpy.packbits.
+};
+
+struct Options
+{
+  Format   m_format = Format::NPY;   ///> The output format.
+  CostType m_cost   = CostType::F64; ///> The element type of cost maps.
+  PathType m_path   = PathType::F64; ///> The element type of the target path.
+  bool     m_resume = false;         ///> Keep completed tasks of an existing dataset and append to it.
+};
+
+/**
+ * @brief Convert a name of the format to the format.
+ *
+ * @param name The name of a format, "npy" or "shard".
+ * @return Format
+ */
+Format
+to_format(const std::string& name);
+
+/**
+ * @brief Convert a name of the element type of cost maps to the type.
+ *
+ * @param name The name of a type, "f64", "f32", "f16" or "u8".
+ * @return CostType
+ */
+CostType
+to_cost_type(const std::string& name);
+
+/**
+ * @brief Convert a name of the element type of the path to the type.
+ *
+ * @param name The name of a type, "f64", "u8" or "bits".
+ * @return PathType
+ */
+PathType
+to_path_type(const std::string& name);
+
+} // namespace dataset
+
+namespace dataset::details
+{
+
+/**
+ * @brief Convert a double to IEEE 754 half precision bits, rounding to nearest even.
+ *
+ * @param value The value to convert.
+ * @return uint16_t
+ */
+uint16_t
+to_half(const double value);
+
+/**
+ * @brief Encode cost maps, the layout (y, x, z) of a matrix is kept.
+ *
+ * @param cost Cost maps.
+ * @param type The element type.
+ * @return Tensor
+ */
+Tensor
+encode_cost(const matrix::Matrix<>& cost, const CostType type);
+
+/**
+ * @brief Encode the path, bit-packed planes are packed along x with the most significant bit first.
+ *
+ * @param path The path.
+ * @param type The element type.
+ * @return Tensor
+ */
+Tensor
+encode_path(const matrix::Matrix<uint8_t>& path, const PathType type);
+
+} // namespace dataset::details
+
+namespace dataset
+{
+
+struct Sample
+{
+  std::string             m_name;           ///> The name of a sample, used as a folder name.
+  std::size_t             m_chunk      = 0; ///> The number of a nets chunk within a stack, used as a files prefix.
+  std::string             m_nets;           ///> Content of the nets file.
+  matrix::Matrix<>        m_cost_h;         ///> Horizontal cost maps, a single layer per net.
+  matrix::Matrix<>        m_cost_v;         ///> Vertical cost maps, a single layer per net.
+  matrix::Matrix<uint8_t> m_path;           ///> Target path, 0 - empty, 1 - wire, 2 - via.
+  std::size_t             m_pins_count = 0; ///> The number of pins of all nets.
+  std::size_t             m_nets_count = 0; ///> The number of nets.
+};
+
+struct Batch
+{
+  std::size_t         m_task = 0; ///> The index of a task produced samples.
+  std::string         m_key;      ///> The key of a task in the journal, unique within a dataset.
+  std::vector<Sample> m_samples;  ///> Samples in order of nets chunks.
+};
+
+class Journal
+{
+public:
+  NON_COPYABLE(Journal)
+  NON_MOVABLE(Journal)
+
+  /**
+   * @brief Open a journal of completed tasks, creates it if it doesn't exist.
+   *
+   * An entry is a line "<rows count> <key>" followed by rows of the data.csv written by the task.
+   * A torn entry at the end of the file left by a killed process is cut off.
+   *
+   * @param path The path to a journal file.
+   */
+  explicit Journal(const std::filesystem::path& path);
+
+  /**
+   * @brief Destroy the Journal and close the file.
+   *
+   */
+  ~Journal();
+
+public:
+  /**
+   * @brief Check if a task is completed.
+   *
+   * @param key The key of a task.
+   * @return true - The task is completed.
+   * @return false
+   */
+  bool
+  contains(const std::string& key) const;
+
+  /**
+   * @brief Returns rows of the data.csv of all completed tasks in order of completion.
+   *
+   * @return const std::vector<std::string>&
+   */
+  const std::vector<std::string>&
+  rows() const noexcept(true);
+
+  /**
+   * @brief Append entries with a single write and sync them to the disk.
+   *
+   * @param entries Keys of completed tasks with their rows.
+   */
+  void
+  append(const std::vector<std::pair<std::string, std::vector<std::string>>>& entries);
+
+private:
+  std::filesystem::path           m_path;      ///> The path to the journal file.
+  int                             m_file = -1; ///> The journal file descriptor.
+  std::unordered_set<std::string> m_keys;      ///> Keys of completed tasks.
+  std::vector<std::string>        m_rows;      ///> Rows of completed tasks.
+};
+
+class ShardWriter
+{
+public:
+  NON_COPYABLE(ShardWriter)
+  NON_MOVABLE(ShardWriter)
+
+  /**
+   * @brief Construct a new Shard Writer.
+   *
+   * @param folder The folder for shard files.
+   * @param max_size The size of a shard file in bytes after which a new shard is started.
+   */
+  ShardWriter(const std::filesystem::path& folder, const std::size_t max_size);
+
+public:
+  /**
+   * @brief Append a record to the current shard.
+   *
+   * @param record The record to append.
+   * @return std::pair<std::string, std::size_t> The name of a shard file and the index of a record in it.
+   */
+  std::pair<std::string, std::size_t>
+  append(const details::Record& record);
+
+  /**
+   * @brief Flush shard and index files and sync them to the disk.
+   *
+   */
+  void
+  flush();
+
+  /**
+   * @brief Returns the name of a shard file.
+   *
+   * @param shard The index of a shard.
+   * @return std::string
+   */
+  static std::string
+  shard_name(const std::size_t shard);
+
+private:
+  /**
+   * @brief Close the current shard and open the next one.
+   *
+   */
+  void
+  open_next();
+
+private:
+  std::filesystem::path m_folder;      ///> The folder for shard files.
+  std::size_t           m_max_size;    ///> The size of a shard file after which a new shard is started.
+  std::size_t           m_shard   = 0; ///> The index of the current shard.
+  std::size_t           m_offset  = 0; ///> The size of the current shard.
+  std::size_t           m_records = 0; ///> The number of records in the current shard.
+  std::ofstream         m_data;        ///> The current shard file.
+  std::ofstream         m_index;       ///> The offset index of the current shard.
+};
+
+struct RecordView
+{
+  std::string_view m_name;                 ///> The name of a sample.
+  std::string_view m_nets;                 ///> The nets text.
+  matrix::Shape    m_shape;                ///> The shape of cost maps, the path has a single layer.
+  std::string_view m_cost_dtype;           ///> Numpy type descriptor of cost maps.
+  std::string_view m_path_dtype;           ///> Numpy type descriptor of the path, "bits" for bit-packed planes.
+  const void*      m_cost_h     = nullptr; ///> Horizontal cost maps.
+  const void*      m_cost_v     = nullptr; ///> Vertical cost maps.
+  const void*      m_path       = nullptr; ///> Target path.
+  std::size_t      m_pins_count = 0;       ///> The number of pins of all nets.
+  std::size_t      m_nets_count = 0;       ///> The number of nets.
+};
+
+class ShardReader
+{
+public:
+  NON_COPYABLE(ShardReader)
+  NON_MOVABLE(ShardReader)
+
+  /**
+   * @brief Memory-map a shard file and read its offset index.
+   *
+   * @param shard_path The path to a shard file.
+   */
+  explicit ShardReader(const std::filesystem::path& shard_path);
+
+  /**
+   * @brief Destroy the Shard Reader and unmap the shard file.
+   *
+   */
+  ~ShardReader();
+
+public:
+  /**
+   * @brief Returns the number of records.
+   *
+   * @return std::size_t
+   */
+  std::size_t
+  size() const noexcept(true);
+
+  /**
+   * @brief Returns a view of a record, the view is valid while the reader is alive.
+   *
+   * @param idx The index of a record.
+   * @return RecordView
+   */
+  RecordView
+  at(const std::size_t idx) const;
+
+private:
+  const char*           m_data = nullptr; ///> The mapped shard file.
+  std::size_t           m_size = 0;       ///> The size of the shard file.
+  std::vector<uint64_t> m_offsets;        ///> Offsets of records.
+};
+
+class Writer
+{
+public:
+  NON_COPYABLE(Writer)
+  NON_MOVABLE(Writer)
+
+  /**
+   * @brief Construct a new Writer and start the writer thread.
+   * When resuming, the data.csv is rebuilt from the journal, so only rows of completed tasks are kept.
+   *
+   * @param root_folder The root folder of a dataset.
+   * @param capacity The maximum number of batches waiting to be written.
+   * @param options The output format and element types of tensors.
+   */
+  Writer(const std::filesystem::path& root_folder, const std::size_t capacity, const Options& options = {});
+
+  /**
+   * @brief Destroy the Writer, waits for all pushed batches to be written.
+   *
+   */
+  ~Writer();
+
+public:
+  /**
+   * @brief Check if a task has been completed by a previous run.
+   *
+   * @param key The key of a task.
+   * @return true - The task is completed.
+   * @return false
+   */
+  bool
+  is_completed(const std::string& key) const;
+
+  /**
+   * @brief Encode a batch and hand it over to the writer thread, blocks while the queue is full.
+   * Each task must push exactly one batch, even an empty one, rows of data.csv are written in order of tasks.
+   *
+   * @param batch The batch to write.
+   */
+  void
+  push(Batch&& batch);
+
+  /**
+   * @brief Wait for all pushed batches to be written and rethrow an error of the writer thread if any.
+   *
+   */
+  void
+  finish();
+
+private:
+  /**
+   * @brief The main loop of the writer thread.
+   *
+   */
+  void
+  work_loop();
+
+  /**
+   * @brief Encode tensors of a sample with the element types of options.
+   *
+   * @param sample The sample to encode.
+   * @return details::Record
+   */
+  details::Record
+  encode(const Sample& sample) const;
+
+  /**
+   * @brief Create folders of all records in batches at once.
+   *
+   * @param batches Batches to create folders for.
+   */
+  void
+  create_folders(const std::vector<details::EncodedBatch>& batches);
+
+  /**
+   * @brief Write files of a single record.
+   *
+   * @param record The record to write.
+   * @return std::string The row of the data.csv.
+   */
+  std::string
+  write(const details::Record& record);
+
+private:
+  Options                                                                 m_options;           ///> The output format and element types of tensors.
+  std::filesystem::path                                                   m_source_folder;     ///> The folder for source samples.
+  std::filesystem::path                                                   m_target_folder;     ///> The folder for target samples.
+  std::unique_ptr<ShardWriter>                                            m_shards;            ///> Shard files, only for the shard format.
+  std::size_t                                                             m_capacity;          ///> The maximum number of batches in the queue.
+  std::ofstream                                                           m_csv_file;          ///> The data.csv file.
+  parallel::BoundedQueue<details::EncodedBatch>                           m_queue;             ///> Batches waiting to be written.
+  std::unique_ptr<Journal>                                                m_journal;           ///> The journal of completed tasks.
+  std::map<std::size_t, std::pair<std::string, std::vector<std::string>>> m_pending_rows;      ///> Keys and rows of tasks waiting for previous tasks.
+  std::size_t                                                             m_next_task = 0;     ///> The next task to write rows of.
+  std::unordered_set<std::string>                                         m_created_folders;   ///> Already created folders.
+  std::exception_ptr                                                      m_error;             ///> The first error of the writer thread.
+  std::atomic<bool>                                                       m_is_failed = false; ///> Has the writer thread failed.
+  std::thread                                                             m_thread;            ///> The writer thread.
+};
+
+} // namespace dataset
+
+#endif
@@ -22,7 +22,7 @@ private:
   create_menu();
 
   void
-  apply_global_routing();
+  apply_global_routing(const std::filesystem::path& project_folder);
 
 signals:
   void
@@ -2,6 +2,9 @@
 #define __GEOMETRY_HPP__
 
 #include <array>
+#include <cmath>
+#include <limits>
+#include <type_traits>
 
 #include <clipper2/clipper.h>
 
@@ -10,6 +13,50 @@
 namespace geom
 {
 
+#ifdef FASTLINK_INTEGER_DBU
+using Coord = int64_t; ///> Coordinates in database units, the arithmetic is exact.
+#else
+using Coord = double;  ///> Coordinates in database units.
+#endif
+
+/**
+ * @brief Converts a value to a coordinate, integer coordinates are rounded to the nearest database unit.
+ *
+ * @param value The value.
+ * @return Coord
+ */
+inline Coord
+to_coord(const double value) noexcept(true)
+{
+  if constexpr(std::is_integral_v<Coord>)
+    {
+      return static_cast<Coord>(std::llround(value));
+    }
+  else
+    {
+      return value;
+    }
+}
+
+/**
+ * @brief Gets the largest coordinate below a value, so a point there is still inside of an interval [begin, value).
+ *
+ * @param value The value.
+ * @return Coord
+ */
+inline Coord
+prev_coord(const Coord value) noexcept(true)
+{
+  if constexpr(std::is_integral_v<Coord>)
+    {
+      return value - 1;
+    }
+  else
+    {
+      return std::nextafter(value, -std::numeric_limits<Coord>::infinity());
+    }
+}
+
 using PointS = Clipper2Lib::Point<std::size_t>;
 
 struct LineS
@@ -19,7 +66,7 @@ struct LineS
   types::Metal m_metal;
 };
 
-using Point = Clipper2Lib::Point<double>;
+using Point = Clipper2Lib::Point<Coord>;
 
 struct Line
 {
@@ -116,6 +163,15 @@ public:
   Point
   get_center() const;
 
+  /**
+   * @brief Checks if the polygon is an axis-aligned box, operations on two boxes don't go to Clipper.
+   *
+   * @return true
+   * @return false
+   */
+  bool
+  is_box() const noexcept(true);
+
   /**
    * @brief Checks if point lies in polygon.
    *
@@ -139,6 +195,15 @@ public:
   std::vector<Point> m_points;
 };
 
+/**
+ * @brief Replaces every group of intersected polygons by their union, polygons are grouped transitively.
+ *
+ * @param polygons Polygons of the same layer in order of addition, a group takes the position of its last polygon, as if each polygon
+ * was merged with the previous ones and the union was appended to the end.
+ */
+void
+merge_overlapping(std::vector<Polygon>& polygons);
+
 } // namespace geom
 
 #endif
\ No newline at end of file
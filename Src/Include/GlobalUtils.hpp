@@ -1,7 +1,9 @@
 #ifndef __GLOBAL_UTILS_HPP__
 #define __GLOBAL_UTILS_HPP__
 
+#include <string>
 #include <string_view>
+#include <tuple>
 
 #include "Include/Types.hpp"
 
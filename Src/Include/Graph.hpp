@@ -2,7 +2,8 @@
 #define __GRAPH_HPP__
 
 #include <cstdint>
-#include <unordered_set>
+#include <limits>
+#include <utility>
 #include <vector>
 
 namespace graph
@@ -14,12 +15,6 @@ struct Edge
   uint32_t m_source;
   uint32_t m_destination;
 
-  uint32_t m_base_cost;
-  uint32_t m_usage    = 0;
-  uint32_t m_capacity = 1;
-
-  double   m_history  = 0.0;
-
   friend bool
   operator>(const Edge& lhs, const Edge& rhs);
 
@@ -30,20 +25,156 @@ struct Edge
   operator==(const Edge& lhs, const Edge& rhs);
 
   Edge(uint32_t weight, uint32_t source, uint32_t destination)
-      : m_weight(weight), m_source(source), m_destination(destination), m_base_cost(weight)
+      : m_weight(weight), m_source(source), m_destination(destination)
   {
   }
 };
 
+/**
+ * @brief An undirected graph in the compressed sparse row form.
+ *
+ * Nodes and edges are added first and the graph is frozen afterwards. Every edge is stored in both directions, the edges of a node are
+ * contiguous and each edge knows its reverse, so updates of an edge found by its index are O(1). Edge attributes are kept in separate
+ * arrays indexed by edges. Edges given by their nodes are found by a scan of the row of the source, which is O(degree) rather than O(1),
+ * nodes of routing grids have at most six neighbours, so a hash index of node pairs wouldn't pay for its memory.
+ *
+ * A frozen graph is the base of an overlay: nodes and edges added after freezing and disabled base edges are kept apart and dropped at
+ * once by discard_overlay, so a base shared by several routing tasks is built only once.
+ */
 class Graph
 {
 public:
+  static constexpr uint32_t NONE = std::numeric_limits<uint32_t>::max(); ///> A missing edge.
+
+public:
+  /** =============================== BUILDING ===================================== */
+
   void
   place_node();
 
+  /**
+   * @brief Adds an edge in both directions, only the first edge between two nodes is kept. An edge added to a frozen graph belongs to
+   * the overlay.
+   *
+   * @param weight The weight of an edge.
+   * @param source The first node.
+   * @param destination The second node.
+   */
   void
   add_edge(uint32_t weight, uint32_t source, uint32_t destination);
 
+  /**
+   * @brief Builds rows of the graph from added edges, the graph becomes the base of an overlay.
+   *
+   */
+  void
+  freeze();
+
+  bool
+  is_frozen() const noexcept(true)
+  {
+    return !m_offsets.empty();
+  }
+
+  /**
+   * @brief Hides a base edge in both directions until the overlay is discarded.
+   *
+   * @param source The first node.
+   * @param destination The second node.
+   * @return true The edge is disabled.
+   * @return false There is no enabled base edge between the nodes.
+   */
+  bool
+  disable_edge(uint32_t source, uint32_t destination);
+
+  /**
+   * @brief Drops nodes and edges of the overlay and enables disabled edges, costs of base edges are kept.
+   *
+   */
+  void
+  discard_overlay();
+
+  /**
+   * @brief Removes all nodes and edges.
+   *
+   */
+  void
+  clear();
+
+  /** =============================== TOPOLOGY ===================================== */
+
+  bool
+  empty() const noexcept(true)
+  {
+    return m_nodes_count == 0;
+  }
+
+  std::size_t
+  nodes_count() const noexcept(true)
+  {
+    return m_nodes_count;
+  }
+
+  std::size_t
+  edges_count() const noexcept(true)
+  {
+    return m_destinations.size();
+  }
+
+  /**
+   * @brief Calls a function for each enabled edge of a node, base edges come first.
+   *
+   * @param node The node.
+   * @param fn The function, takes the destination and the index of an edge.
+   */
+  template <typename Fn>
+  void
+  for_each_neighbour(uint32_t node, Fn&& fn) const
+  {
+    if(node < m_base_nodes_count)
+      {
+        for(uint32_t edge = m_offsets[node], end = m_offsets[node + 1]; edge < end; ++edge)
+          {
+            if(m_disabled[edge] == 0)
+              {
+                fn(m_destinations[edge], edge);
+              }
+          }
+      }
+
+    if(node < m_overlay_rows.size())
+      {
+        for(const uint32_t edge : m_overlay_rows[node])
+          {
+            fn(m_destinations[edge], edge);
+          }
+      }
+  }
+
+  uint32_t
+  get_destination(uint32_t edge) const
+  {
+    return m_destinations[edge];
+  }
+
+  uint32_t
+  get_reverse(uint32_t edge) const
+  {
+    return m_reverse[edge];
+  }
+
+  /**
+   * @brief Finds an enabled edge by its nodes in O(degree) of the source, base and overlay rows of the source are scanned.
+   *
+   * @param source The source node.
+   * @param destination The destination node.
+   * @return uint32_t The index of an edge, NONE if there is no such edge.
+   */
+  uint32_t
+  find_edge(uint32_t source, uint32_t destination) const;
+
+  /** =============================== COSTS ======================================== */
+
   void
   add_cost(uint32_t cost, uint32_t source, uint32_t destination);
 
@@ -53,22 +184,51 @@ public:
   void
   restore_cost(uint32_t source, uint32_t destination);
 
-  void
-  update_usage(int32_t delta, uint32_t source, uint32_t destination);
-
   void
   remove_cost(uint32_t cost, uint32_t source, uint32_t destination);
 
-  std::vector<std::vector<Edge>>&
-  get_adj();
+  uint32_t
+  get_weight(uint32_t edge) const
+  {
+    return m_weights[edge];
+  }
 
-  const std::vector<std::vector<Edge>>&
-  get_adj() const;
+  uint32_t
+  get_base_cost(uint32_t edge) const
+  {
+    return m_base_costs[edge];
+  }
+
+private:
+  /**
+   * @brief Gets both directions of an edge.
+   *
+   * @param source The source node.
+   * @param destination The destination node.
+   * @return std::pair<uint32_t, uint32_t> The edge and its reverse.
+   */
+  std::pair<uint32_t, uint32_t>
+  get_edges(uint32_t source, uint32_t destination) const;
 
 private:
-  std::vector<std::vector<Edge>> m_adj;
+  std::size_t                        m_nodes_count       = 0; ///> The number of nodes.
+  std::size_t                        m_base_nodes_count  = 0; ///> The number of nodes when the graph was frozen.
+  std::size_t                        m_base_edges_count  = 0; ///> The number of edges when the graph was frozen.
+  std::vector<Edge>                  m_pending;               ///> Edges added before the graph is frozen, both directions.
+
+  std::vector<uint32_t>              m_offsets;               ///> Base edges of the node i are [m_offsets[i], m_offsets[i + 1]).
+  std::vector<uint32_t>              m_destinations;          ///> The destination of an edge.
+  std::vector<uint32_t>              m_reverse;               ///> The index of the opposite direction of an edge.
+  std::vector<uint8_t>               m_disabled;              ///> Nonzero for hidden edges.
+
+  std::vector<std::vector<uint32_t>> m_overlay_rows;          ///> Overlay edges of nodes.
+  std::vector<uint32_t>              m_overlay_touched;       ///> Nodes with overlay edges.
+  std::vector<uint32_t>              m_disabled_edges;        ///> Disabled base edges, one direction of each.
+
+  std::vector<uint32_t>              m_weights;               ///> The current cost of an edge.
+  std::vector<uint32_t>              m_base_costs;            ///> The cost of an edge when it was added.
 };
 
 } // namespace graph
 
-#endif
\ No newline at end of file
+#endif
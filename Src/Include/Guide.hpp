@@ -1,9 +1,9 @@
 #ifndef __GUIDE_HPP__
 #define __GUIDE_HPP__
 
+#include <cstdint>
 #include <filesystem>
 #include <string>
-#include <unordered_set>
 #include <vector>
 
 #include "Include/Geometry.hpp"
@@ -13,76 +13,35 @@ namespace guide
 
 struct Node
 {
-  std::size_t m_x;
-  std::size_t m_y;
-  std::size_t m_connections = 0;
-
-  struct Hash
-  {
-    std::size_t
-    operator()(const Node* node) const
-    {
-      static std::size_t prime = 0x9e3779b9;
-
-      const std::size_t  a     = std::hash<std::size_t>{}(node->m_x);
-      const std::size_t  b     = std::hash<std::size_t>{}(node->m_y);
-      return a ^ (b + prime + (a << 6) + (a >> 2));
-    }
-  };
-
-  struct Equal
-  {
-    bool
-    operator()(const Node* lhs, const Node* rhs) const
-    {
-      return lhs->m_x == rhs->m_x && lhs->m_y == rhs->m_y;
-    }
-  };
+  uint32_t m_x;               ///> Position by x axis in gcell grid.
+  uint32_t m_y;               ///> Position by y axis in gcell grid.
+  uint32_t m_connections = 0; ///> The number of edges of a node.
 };
 
 struct Edge
 {
-  Node*        m_source;
-  Node*        m_destination;
+  uint32_t     m_source;      ///> Index of a source node in a tree.
+  uint32_t     m_destination; ///> Index of a destination node in a tree.
   types::Metal m_metal_layer;
-
-  struct Hash
-  {
-    std::size_t
-    operator()(const Edge& edge) const
-    {
-      static std::size_t prime            = 0x9e3779b9;
-
-      const std::size_t  source_hash      = std::hash<Node*>{}(edge.m_source);
-      const std::size_t  destination_hash = std::hash<Node*>{}(edge.m_destination);
-      const std::size_t  metal_hash       = std::hash<types::Metal>{}(edge.m_metal_layer);
-      return source_hash ^ (destination_hash + prime + (source_hash << 6) + (source_hash >> 2)) ^ (metal_hash + prime + (destination_hash << 6) + (destination_hash >> 2));
-    }
-  };
-
-  struct Equal
-  {
-    bool
-    operator()(const Edge& lhs, const Edge& rhs) const
-    {
-      return lhs.m_source == rhs.m_source && lhs.m_destination == rhs.m_destination && lhs.m_metal_layer == rhs.m_metal_layer;
-    }
-  };
 };
 
 struct Tree
 {
-  std::string                                        m_name;
-  std::unordered_set<Node*, Node::Hash, Node::Equal> m_nodes;
-  std::unordered_set<Edge, Edge::Hash, Edge::Equal> m_edges;
+  std::string       m_name;
+  std::vector<Node> m_nodes; ///> Unique nodes in order of appearance in a guide.
+  std::vector<Edge> m_edges; ///> Unique edges in order of appearance in a guide.
 };
 
+/**
+ * @brief Reads a guide file, the file is split by nets and parts are parsed in parallel.
+ *
+ * @param path The path to a guide file.
+ * @param threads The number of threads, 0 means all hardware threads.
+ * @return std::vector<Tree> Trees in order of nets in a file.
+ */
 std::vector<Tree>
-read(const std::filesystem::path& path);
-
-void
-cleanup(const std::vector<Tree>& trees);
+read(const std::filesystem::path& path, const std::size_t threads = 1);
 
 } // namespace
 
-#endif
\ No newline at end of file
+#endif
@@ -4,12 +4,15 @@
 #include <cstdint>
 #include <filesystem>
 #include <string>
+#include <type_traits>
 #include <unordered_map>
+#include <vector>
 
 #include <lefrReader.hpp>
 
 #include "Include/Geometry.hpp"
 #include "Include/Pin.hpp"
+#include "Include/Serialize.hpp"
 #include "Include/Types.hpp"
 
 namespace lef
@@ -38,15 +41,15 @@ struct Layer
 
 struct Macro
 {
-  double                                    m_width;
-  double                                    m_height;
-  std::vector<geom::Polygon>                m_obs;
-  std::unordered_map<std::string, pin::Pin> m_pins;
+  double                                    m_width;  ///> The width in microns.
+  double                                    m_height; ///> The height in microns.
+  std::vector<geom::Polygon>                m_obs;    ///> Obstacles in database units.
+  std::unordered_map<std::string, pin::Pin> m_pins;   ///> Pins with ports and obstacles in database units.
 };
 
 struct Data
 {
-  double                                  m_database_number;
+  double                                  m_database_number; ///> Database units per micron, geometry of macros is scaled by it while parsing.
   std::unordered_map<types::Metal, Layer> m_layers;
   std::unordered_map<std::string, Macro>  m_macros;
 };
@@ -72,12 +75,28 @@ public:
   /** =============================== PUBLIC METHODS ==================================== */
 
   /**
-   * @brief Parses a LEF file from the given file path.
+   * @brief Parses all LEF files of a pdk folder.
    *
-   * @param file_path The path to the LEF file to be parsed.
+   * With a cache folder, the parsed data is stored as a binary snapshot keyed by a hash of paths, sizes and modification
+   * times of all LEF files, and the next parse of unchanged files just loads the snapshot.
+   *
+   * @param dir_path The path to a pdk folder.
+   * @param cache_folder The folder for snapshots, empty to always parse.
    */
   Data
-  parse(const std::filesystem::path& file_path) const;
+  parse(const std::filesystem::path& dir_path, const std::filesystem::path& cache_folder = {}) const;
+
+public:
+  /** =============================== PUBLIC STATIC METHODS ==================================== */
+
+  /**
+   * @brief Finds all LEF files of a pdk folder in the order of parsing, technology files go first.
+   *
+   * @param dir_path The path to a pdk folder.
+   * @return std::vector<std::filesystem::path>
+   */
+  static std::vector<std::filesystem::path>
+  find_files(const std::filesystem::path& dir_path);
 
 protected:
   /** =============================== PROTECTED VIRTUAL METHODS ============================ */
@@ -136,6 +155,31 @@ protected:
   void
   obstruction_callback(lefiObstruction* param, Data& data);
 
+public:
+  /** =============================== PUBLIC STATIC METHODS ==================================== */
+
+  /**
+   * @brief Loads a snapshot of data.
+   *
+   * @param cache_path The path to a snapshot.
+   * @param key The hash of LEF files the snapshot must be made for.
+   * @param data Loaded data.
+   * @return true - The snapshot is valid and has been loaded.
+   * @return false
+   */
+  static bool
+  load_cache(const std::filesystem::path& cache_path, const uint64_t key, Data& data);
+
+  /**
+   * @brief Stores a snapshot of data, the snapshot is replaced atomically so concurrent runs never see a partial one.
+   *
+   * @param cache_path The path to a snapshot.
+   * @param key The hash of LEF files the snapshot is made for.
+   * @param data Data to store.
+   */
+  static void
+  store_cache(const std::filesystem::path& cache_path, const uint64_t key, const Data& data);
+
 private:
   /** =============================== PRIVATE STATIC METHODS =================================== */
 
@@ -220,4 +264,30 @@ protected:
 
 } // namespace lef
 
+namespace lef::details
+{
+
+/** Snapshot format version, must be increased with any change of the lef::Data layout, the highest bit marks integer coordinates */
+constexpr uint32_t CACHE_VERSION = 2 | (std::is_integral_v<geom::Coord> ? 1u << 31 : 0u);
+
+/**
+ * @brief Writes layers and macros of LEF data.
+ *
+ * @param writer The writer.
+ * @param data The data.
+ */
+void
+write_data(serialize::Writer& writer, const Data& data);
+
+/**
+ * @brief Reads LEF data written by the write_data.
+ *
+ * @param reader The reader.
+ * @param data The data.
+ */
+void
+read_data(serialize::Reader& reader, Data& data);
+
+} // namespace lef::details
+
 #endif
\ No newline at end of file
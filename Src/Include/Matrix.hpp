@@ -3,14 +3,19 @@
 
 #include <cstdint>
 #include <cstdlib>
+#include <limits>
 #include <stdexcept>
+#include <type_traits>
 #include <unordered_map>
 #include <unordered_set>
+#include <utility>
 #include <vector>
 
 namespace matrix
 {
 
+constexpr std::size_t ALIGNMENT = 64; ///> Alignment of matrix storage, a cache line and the widest vector register.
+
 struct Node
 {
   uint32_t m_x;
@@ -80,8 +85,131 @@ struct Shape
   }
 };
 
+/**
+ * @brief A non-owning view of a single z layer of a matrix, elements of a layer are strided by the depth of a matrix.
+ *
+ * @tparam Tp The type of elements, const for read-only views.
+ */
+template <typename Tp>
+class View
+{
+public:
+  View(Tp* data, const std::size_t size_x, const std::size_t size_y, const std::size_t stride)
+      : m_data(data), m_size_x(size_x), m_size_y(size_y), m_stride(stride) {};
+
+public:
+  /**
+   * @brief Accesses an element without a bounds check, the check is done only in debug builds.
+   *
+   * @param x X-coordinate (width).
+   * @param y Y-coordinate (height).
+   * @return Tp&
+   */
+  Tp&
+  operator()(const uint32_t x, const uint32_t y) const
+  {
+#ifdef FASTLINK_DEBUG
+    if(x >= m_size_x || y >= m_size_y)
+      {
+        throw std::out_of_range("Out of range");
+      }
+#endif
+
+    return m_data[(y * m_size_x + x) * m_stride];
+  }
+
+  /**
+   * @brief Sets all elements of the view to the value.
+   *
+   * @param value The value.
+   */
+  void
+  fill(const std::remove_const_t<Tp> value) const noexcept(true)
+  {
+    for(std::size_t i = 0, end = m_size_x * m_size_y; i < end; ++i)
+      {
+        m_data[i * m_stride] = value;
+      }
+  }
+
+  /**
+   * @brief Gets the smallest and the largest elements of the view, elements equal to the ignored value are skipped.
+   *
+   * @param ignored The value to skip.
+   * @return std::pair<std::remove_const_t<Tp>, std::remove_const_t<Tp>> The limits of Tp in reverse order if all elements are skipped.
+   */
+  std::pair<std::remove_const_t<Tp>, std::remove_const_t<Tp>>
+  min_max(const std::remove_const_t<Tp> ignored) const noexcept(true)
+  {
+    using Value   = std::remove_const_t<Tp>;
+
+    Value min     = std::numeric_limits<Value>::max();
+    Value max     = std::numeric_limits<Value>::lowest();
+
+    for(std::size_t i = 0, end = m_size_x * m_size_y; i < end; ++i)
+      {
+        const Value value = m_data[i * m_stride];
+
+        if(value != ignored)
+          {
+            min = value < min ? value : min;
+            max = value > max ? value : max;
+          }
+      }
+
+    return { min, max };
+  }
+
+  /**
+   * @brief Maps elements of the view from [min, max] to [scale, 0], the same as Matrix::normalize_inverse.
+   *
+   * @param min The value mapped to the scale.
+   * @param max The value mapped to zero.
+   * @param scale The largest value after the mapping.
+   * @param ignored The value to zero.
+   */
+  void
+  normalize_inverse(const Tp min, const Tp max, const Tp scale, const Tp ignored) const noexcept(true)
+  {
+    const bool is_empty = !(max > min);
+    const Tp   range    = max - min;
+
+    for(std::size_t i = 0, end = m_size_x * m_size_y; i < end; ++i)
+      {
+        Tp& value = m_data[i * m_stride];
+        value     = value == ignored ? Tp(0) : (is_empty ? scale : Tp(scale * (Tp(1) - (value - min) / range)));
+      }
+  }
+
+  std::size_t
+  size_x() const noexcept(true)
+  {
+    return m_size_x;
+  }
+
+  std::size_t
+  size_y() const noexcept(true)
+  {
+    return m_size_y;
+  }
+
+private:
+  Tp*         m_data;   ///> The first element of a layer.
+  std::size_t m_size_x; ///> The width of a layer.
+  std::size_t m_size_y; ///> The height of a layer.
+  std::size_t m_stride; ///> The distance between neighbour elements of a layer, the depth of a matrix.
+};
+
+/**
+ * @brief A dense 3D matrix, z is the fastest axis, storage is aligned by ALIGNMENT so bulk operations vectorize.
+ *
+ * @tparam Tp The type of elements.
+ */
+template <typename Tp = double>
 class Matrix
 {
+  static_assert(std::is_arithmetic_v<Tp>, "Matrix elements are initialized and copied as raw memory.");
+
 public:
   /** =============================== CONSTRUCTORS ================================= */
 
@@ -110,7 +238,7 @@ public:
    *
    * @param matrix The matrix to be moved.
    */
-  Matrix(Matrix&& matrix);
+  Matrix(Matrix&& matrix) noexcept(true);
 
 public:
   /** =============================== OPERATORS ==================================== */
@@ -131,7 +259,7 @@ public:
    * @return Matrix&
    */
   Matrix&
-  operator=(Matrix&& matrix);
+  operator=(Matrix&& matrix) noexcept(true);
 
   /**
    * @brief Sum-assignment of two matrices.
@@ -142,6 +270,34 @@ public:
   Matrix&
   operator+=(const Matrix& matrix);
 
+  /**
+   * @brief Accesses an element without a bounds check, the check is done only in debug builds.
+   *
+   * @param x X-coordinate (width).
+   * @param y Y-coordinate (height).
+   * @param z Z-coordinate (depth).
+   * @return Tp&
+   */
+  Tp&
+  operator()(const uint32_t x, const uint32_t y, const uint32_t z)
+  {
+    return m_data[index(x, y, z)];
+  }
+
+  /**
+   * @brief Accesses an element without a bounds check, the check is done only in debug builds.
+   *
+   * @param x X-coordinate (width).
+   * @param y Y-coordinate (height).
+   * @param z Z-coordinate (depth).
+   * @return const Tp&
+   */
+  const Tp&
+  operator()(const uint32_t x, const uint32_t y, const uint32_t z) const
+  {
+    return m_data[index(x, y, z)];
+  }
+
 public:
   /** =============================== PUBLIC STATIC METHODS =============================== */
 
@@ -160,17 +316,17 @@ public:
   /**
    * @brief Returns pointer to the underlying data.
    *
-   * @return double*
+   * @return Tp*
    */
-  double*
+  Tp*
   data();
 
   /**
    * @brief Returns pointer to the underlying data.
    *
-   * @return const double*
+   * @return const Tp*
    */
-  const double*
+  const Tp*
   data() const;
 
   /**
@@ -187,9 +343,9 @@ public:
    * @param x X-coordinate (width).
    * @param y Y-coordinate (height).
    * @param z Z-coordinate (depth).
-   * @return const double&
+   * @return const Tp&
    */
-  const double&
+  const Tp&
   get_at(const uint32_t x, const uint32_t y, const uint32_t z) const;
 
   /**
@@ -201,7 +357,83 @@ public:
    * @param z Z-coordinate (depth).
    */
   void
-  set_at(const double value, const uint32_t x, const uint32_t y, const uint32_t z);
+  set_at(const Tp value, const uint32_t x, const uint32_t y, const uint32_t z);
+
+  /**
+   * @brief Returns the number of elements.
+   *
+   * @return std::size_t
+   */
+  std::size_t
+  size() const noexcept(true)
+  {
+    return m_shape.m_x * m_shape.m_y * m_shape.m_z;
+  }
+
+  /**
+   * @brief Returns a row, all x and z elements of a row are contiguous.
+   *
+   * @param y Y-coordinate (height).
+   * @return Tp*
+   */
+  Tp*
+  row(const uint32_t y)
+  {
+    return m_data + index(0, y, 0);
+  }
+
+  /**
+   * @brief Returns a view of a single z layer.
+   *
+   * @param z Z-coordinate (depth).
+   * @return View<Tp>
+   */
+  View<Tp>
+  slice(const uint32_t z)
+  {
+    return View<Tp>(m_data + index(0, 0, z), m_shape.m_x, m_shape.m_y, m_shape.m_z);
+  }
+
+  /**
+   * @brief Returns a read-only view of a single z layer.
+   *
+   * @param z Z-coordinate (depth).
+   * @return View<const Tp>
+   */
+  View<const Tp>
+  slice(const uint32_t z) const
+  {
+    return View<const Tp>(m_data + index(0, 0, z), m_shape.m_x, m_shape.m_y, m_shape.m_z);
+  }
+
+  /**
+   * @brief Sets all elements to the value.
+   *
+   * @param value The value.
+   */
+  void
+  fill(const Tp value) noexcept(true);
+
+  /**
+   * @brief Gets the smallest and the largest elements, elements equal to the ignored value are skipped.
+   *
+   * @param ignored The value to skip.
+   * @return std::pair<Tp, Tp> The limits of Tp in reverse order if all elements are skipped.
+   */
+  std::pair<Tp, Tp>
+  min_max(const Tp ignored) const noexcept(true);
+
+  /**
+   * @brief Maps elements from [min, max] to [scale, 0], elements equal to the ignored value become zero and all other elements become
+   * the scale if the range is empty.
+   *
+   * @param min The value mapped to the scale.
+   * @param max The value mapped to zero.
+   * @param scale The largest value after the mapping.
+   * @param ignored The value to zero.
+   */
+  void
+  normalize_inverse(const Tp min, const Tp max, const Tp scale, const Tp ignored) noexcept(true);
 
   /**
    * @brief Clears the matrix data.
@@ -214,20 +446,101 @@ private:
   /** =============================== PRIVATE METHODS ============================== */
 
   /**
-   * @brief Allocates memory for matrix elements.
+   * @brief Gets the index of an element, the bounds are checked only in debug builds.
+   *
+   * @param x X-coordinate (width).
+   * @param y Y-coordinate (height).
+   * @param z Z-coordinate (depth).
+   * @return std::size_t
+   */
+  std::size_t
+  index(const uint32_t x, const uint32_t y, const uint32_t z) const
+  {
+#ifdef FASTLINK_DEBUG
+    if(x >= m_shape.m_x || y >= m_shape.m_y || z >= m_shape.m_z)
+      {
+        throw std::out_of_range("Out of range");
+      }
+#endif
+
+    return (std::size_t(y) * m_shape.m_x + x) * m_shape.m_z + z;
+  }
+
+  /**
+   * @brief Allocates aligned memory for matrix elements.
    *
    * @return std::size_t
    */
   std::size_t
   allocate();
 
+  /**
+   * @brief Releases memory of matrix elements.
+   *
+   */
+  void
+  release() noexcept(true);
+
 public:
   Shape m_shape; ///< Holds the dimensions of the matrix.
 
 private:
-  double* m_data; ///< Pointer to the dynamically allocated matrix data.
+  Tp* m_data; ///< Pointer to the dynamically allocated matrix data.
 };
 
+/**
+ * @brief A per-thread pool of released matrices keyed by shape, chunks of a stack and stacks of a gcell have the same shapes, so their
+ * buffers are reused instead of being allocated and page faulted again.
+ *
+ * @tparam Tp The type of elements.
+ */
+template <typename Tp = double>
+class Pool
+{
+public:
+  /**
+   * @brief Gets the pool of the calling thread.
+   *
+   * @return Pool&
+   */
+  static Pool&
+  local()
+  {
+    thread_local Pool pool;
+    return pool;
+  }
+
+  /**
+   * @brief Takes a zeroed matrix of the shape, a released matrix of the same shape is reused if there is one.
+   *
+   * @param shape The shape of a matrix.
+   * @return Matrix<Tp>
+   */
+  Matrix<Tp>
+  acquire(const Shape& shape);
+
+  /**
+   * @brief Returns a matrix to the pool, the oldest matrix is dropped if the pool is full.
+   *
+   * @param matrix The matrix, empty after the call.
+   */
+  void
+  release(Matrix<Tp>&& matrix);
+
+private:
+  static constexpr std::size_t MAX_SIZE = 16; ///> The number of kept matrices, enough for all buffers of a nets chunk.
+
+  std::vector<Matrix<Tp>>      m_free;        ///> Released matrices, the most recent is the last.
+};
+
+extern template class Matrix<double>;
+extern template class Matrix<float>;
+extern template class Matrix<uint8_t>;
+extern template class Matrix<uint16_t>;
+
+extern template class Pool<double>;
+extern template class Pool<uint8_t>;
+
 } // namespace matrix
 
 #endif
\ No newline at end of file
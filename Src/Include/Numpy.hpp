@@ -1,6 +1,7 @@
 #ifndef __NUMPY_HPP__
 #define __NUMPY_HPP__
 
+#include <cstdint>
 #include <filesystem>
 #include <fstream>
 #include <string>
@@ -10,16 +11,16 @@ namespace numpy
 {
 
 /**
- * @brief Saves a matrix as numpy array.
+ * @brief Saves raw data as numpy array.
  *
- * @tparam Tp The data type.
  * @param file_path The save path.
- * @param data The matrix's data to save.
- * @param shape The matrix's shape.
+ * @param descr The numpy type descriptor, e.g. "<f8".
+ * @param data The data to save.
+ * @param bytes The size of the data in bytes.
+ * @param shape The shape of an array.
  */
-template <typename Tp>
-void
-save_as(const std::filesystem::path& file_path, const Tp* data, const std::vector<std::size_t>& shape)
+inline void
+save_raw(const std::filesystem::path& file_path, const std::string& descr, const void* data, const std::size_t bytes, const std::vector<std::size_t>& shape)
 {
   if(!std::filesystem::exists(file_path.parent_path()))
     {
@@ -43,32 +44,11 @@ save_as(const std::filesystem::path& file_path, const Tp* data, const std::vecto
       throw std::runtime_error("Numpy Error: Failed to open the file.");
     }
 
-  std::size_t data_length = 1;
-
   /** Writing header */
-  std::string header;
-
-  if constexpr(std::is_floating_point_v<Tp>)
-    {
-      header = "{\"descr\": \"<f" + std::to_string(sizeof(Tp)) + "\", \"fortran_order\": False, \"shape\": (";
-    }
-  else if constexpr(std::is_signed_v<Tp>)
-    {
-      header = "{\"descr\": \"<i" + std::to_string(sizeof(Tp)) + "\", \"fortran_order\": False, \"shape\": (";
-    }
-  else if constexpr(std::is_unsigned_v<Tp>)
-    {
-      header = "{\"descr\": \"<u" + std::to_string(sizeof(Tp)) + "\", \"fortran_order\": False, \"shape\": (";
-    }
-  else
-    {
-      throw std::invalid_argument("Numpy Error: Unsupported data type.");
-    }
+  std::string header = "{\"descr\": \"" + descr + "\", \"fortran_order\": False, \"shape\": (";
 
   for(std::size_t i = 0, end = shape.size(); i < end; ++i)
     {
-      data_length *= shape[i];
-
       if(i != end - 1)
         {
           header += std::to_string(shape[i]) + ", ";
@@ -107,12 +87,62 @@ save_as(const std::filesystem::path& file_path, const Tp* data, const std::vecto
   out_file.write("\n", 1);
 
   /** Write the data */
-  out_file.write(reinterpret_cast<const char*>(data), data_length * sizeof(Tp));
+  out_file.write(reinterpret_cast<const char*>(data), bytes);
 
   /** Close the file */
   out_file.close();
 }
 
+/**
+ * @brief Returns the numpy type descriptor of a type.
+ *
+ * @tparam Tp The data type.
+ * @return std::string
+ */
+template <typename Tp>
+std::string
+descr()
+{
+  if constexpr(std::is_floating_point_v<Tp>)
+    {
+      return "<f" + std::to_string(sizeof(Tp));
+    }
+  else if constexpr(std::is_signed_v<Tp>)
+    {
+      return (sizeof(Tp) == 1 ? "|i" : "<i") + std::to_string(sizeof(Tp));
+    }
+  else if constexpr(std::is_unsigned_v<Tp>)
+    {
+      return (sizeof(Tp) == 1 ? "|u" : "<u") + std::to_string(sizeof(Tp));
+    }
+  else
+    {
+      throw std::invalid_argument("Numpy Error: Unsupported data type.");
+    }
+}
+
+/**
+ * @brief Saves a matrix as numpy array.
+ *
+ * @tparam Tp The data type.
+ * @param file_path The save path.
+ * @param data The matrix's data to save.
+ * @param shape The matrix's shape.
+ */
+template <typename Tp>
+void
+save_as(const std::filesystem::path& file_path, const Tp* data, const std::vector<std::size_t>& shape)
+{
+  std::size_t data_length = 1;
+
+  for(const auto dim : shape)
+    {
+      data_length *= dim;
+    }
+
+  save_raw(file_path, descr<Tp>(), data, data_length * sizeof(Tp), shape);
+}
+
 } // namespace numpy
 
 #endif
\ No newline at end of file
@@ -0,0 +1,243 @@
+#ifndef __PARALLEL_HPP__
+#define __PARALLEL_HPP__
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <vector>
+
+namespace parallel::details
+{
+
+class TaskDeque
+{
+public:
+  /**
+   * @brief Push a task to the back of a deque.
+   *
+   * @param task An index of a task.
+   */
+  void
+  push_back(const std::size_t task);
+
+  /**
+   * @brief Pop a task from the front of a deque, used by the owner of a deque.
+   *
+   * @param task An index of the popped task.
+   * @return true - A task has been popped.
+   * @return false
+   */
+  bool
+  pop_front(std::size_t& task);
+
+  /**
+   * @brief Steal a task from the back of a deque, used by other workers.
+   *
+   * @param task An index of the stolen task.
+   * @return true - A task has been stolen.
+   * @return false
+   */
+  bool
+  steal_back(std::size_t& task);
+
+private:
+  std::mutex              m_mutex; ///> Guards the tasks.
+  std::deque<std::size_t> m_tasks; ///> Indices of tasks.
+};
+
+} // namespace parallel::details
+
+namespace parallel
+{
+
+/**
+ * @brief Resolve the number of worker threads.
+ *
+ * @param requested The requested number of threads, 0 means all hardware threads.
+ * @return std::size_t
+ */
+std::size_t
+resolve_threads(const std::size_t requested) noexcept(true);
+
+/**
+ * @brief Threads that are idle while a pool of workers is still running, tasks of the pool borrow them for nested work.
+ *
+ */
+class ThreadBudget
+{
+public:
+  /**
+   * @brief Construct a new Thread Budget.
+   *
+   * @param available The number of idle threads.
+   */
+  explicit ThreadBudget(const std::size_t available = 0)
+      : m_available(available) {};
+
+public:
+  /**
+   * @brief Borrow up to the requested number of threads.
+   *
+   * @param requested The number of threads.
+   * @return std::size_t The number of borrowed threads, may be zero.
+   */
+  std::size_t
+  acquire(const std::size_t requested) noexcept(true);
+
+  /**
+   * @brief Return threads to a budget.
+   *
+   * @param count The number of threads.
+   */
+  void
+  release(const std::size_t count) noexcept(true);
+
+  std::size_t
+  available() const noexcept(true)
+  {
+    return m_available.load();
+  }
+
+private:
+  std::atomic<std::size_t> m_available; ///> The number of idle threads.
+};
+
+/**
+ * @brief Run tasks [0, count) on a pool of workers with work stealing.
+ *
+ * Each worker owns a deque seeded with a contiguous block of tasks. A worker pops tasks from the front of its own deque
+ * and steals from the back of other deques once its own runs dry, so uneven tasks get balanced between workers.
+ * The first thrown exception stops the scheduling of new tasks and is rethrown after all workers joined.
+ *
+ * @param count The number of tasks.
+ * @param threads The number of threads, 0 means all hardware threads.
+ * @param task A function called with an index of a task and an index of a worker.
+ * @param budget Receives the requested threads that have no tasks, at the start and as soon as a worker runs out of tasks.
+ */
+void
+for_each_task(const std::size_t count, const std::size_t threads, const std::function<void(std::size_t, std::size_t)>& task, ThreadBudget* budget = nullptr);
+
+/**
+ * @brief Returns the number of shards the for_each_shard splits items into.
+ *
+ * @param count The number of items.
+ * @param threads The number of threads, 0 means all hardware threads.
+ * @return std::size_t
+ */
+std::size_t
+shards_count(const std::size_t count, const std::size_t threads) noexcept(true);
+
+/**
+ * @brief Split items [0, count) into contiguous shards and process each shard on a pool of workers.
+ *
+ * Shards are numbered in order of items, so per-shard buffers merged by the index of a shard keep the sequential order.
+ *
+ * @param count The number of items.
+ * @param threads The number of threads, 0 means all hardware threads.
+ * @param shard A function called with the begin and the end of a shard and an index of a shard.
+ */
+void
+for_each_shard(const std::size_t count, const std::size_t threads, const std::function<void(std::size_t, std::size_t, std::size_t)>& shard);
+
+/**
+ * @brief A multi-producer queue with a limited capacity, producers are blocked while the queue is full.
+ *
+ * @tparam Tp The type of items.
+ */
+template <typename Tp>
+class BoundedQueue
+{
+public:
+  /**
+   * @brief Construct a new Bounded Queue.
+   *
+   * @param capacity The maximum number of items in a queue.
+   */
+  explicit BoundedQueue(const std::size_t capacity)
+      : m_capacity(std::max<std::size_t>(capacity, 1)) {};
+
+public:
+  /**
+   * @brief Push an item, blocks while the queue is full.
+   *
+   * @param item An item to push.
+   * @return true - The item has been pushed.
+   * @return false - The queue is closed.
+   */
+  bool
+  push(Tp&& item)
+  {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_not_full.wait(lock, [this]() { return m_items.size() < m_capacity || m_is_closed; });
+
+    if(m_is_closed)
+      {
+        return false;
+      }
+
+    m_items.push_back(std::move(item));
+    m_not_empty.notify_one();
+
+    return true;
+  }
+
+  /**
+   * @brief Pop up to the max items at once, blocks until any item is available or the queue is closed.
+   *
+   * @param items A container for popped items.
+   * @param max_items The maximum number of items to pop.
+   * @return true - Some items have been popped.
+   * @return false - The queue is closed and empty.
+   */
+  bool
+  pop_all(std::vector<Tp>& items, const std::size_t max_items)
+  {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_not_empty.wait(lock, [this]() { return !m_items.empty() || m_is_closed; });
+
+    if(m_items.empty())
+      {
+        return false;
+      }
+
+    for(std::size_t i = 0; i < max_items && !m_items.empty(); ++i)
+      {
+        items.push_back(std::move(m_items.front()));
+        m_items.pop_front();
+      }
+
+    m_not_full.notify_all();
+
+    return true;
+  }
+
+  /**
+   * @brief Close the queue, all pushes after that fail and pops drain remaining items.
+   *
+   */
+  void
+  close()
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_is_closed = true;
+
+    m_not_full.notify_all();
+    m_not_empty.notify_all();
+  }
+
+private:
+  std::size_t             m_capacity;          ///> The maximum number of items.
+  bool                    m_is_closed = false; ///> Is the queue closed.
+  std::mutex              m_mutex;             ///> Guards the items.
+  std::condition_variable m_not_full;          ///> Signals producers.
+  std::condition_variable m_not_empty;         ///> Signals consumers.
+  std::deque<Tp>          m_items;             ///> Items.
+};
+
+} // namespace parallel
+
+#endif
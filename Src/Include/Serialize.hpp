@@ -0,0 +1,281 @@
+#ifndef __SERIALIZE_HPP__
+#define __SERIALIZE_HPP__
+
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "Geometry.hpp"
+
+namespace serialize
+{
+
+constexpr uint64_t FNV_OFFSET = 14695981039346656037ull; ///> FNV-1a 64-bit offset basis.
+constexpr uint64_t FNV_PRIME  = 1099511628211ull;        ///> FNV-1a 64-bit prime.
+
+/**
+ * @brief Hash bytes with 64-bit FNV-1a.
+ *
+ * @param data The data to hash.
+ * @param size The size of the data in bytes.
+ * @param hash The hash to continue, the offset basis for a new hash.
+ * @return uint64_t
+ */
+inline uint64_t
+fnv1a(const void* data, const std::size_t size, uint64_t hash = FNV_OFFSET) noexcept(true)
+{
+  const unsigned char* bytes = static_cast<const unsigned char*>(data);
+
+  for(std::size_t i = 0; i < size; ++i)
+    {
+      hash ^= bytes[i];
+      hash *= FNV_PRIME;
+    }
+
+  return hash;
+}
+
+/**
+ * @brief Hash the absolute path, the size and the modification time of a file.
+ *
+ * @param path The path to a file.
+ * @param hash The hash to continue, the offset basis for a new hash.
+ * @return uint64_t
+ */
+inline uint64_t
+hash_file(const std::filesystem::path& path, uint64_t hash = FNV_OFFSET)
+{
+  const std::string path_name  = std::filesystem::absolute(path).string();
+  const uint64_t    size       = std::filesystem::file_size(path);
+  const int64_t     write_time = static_cast<int64_t>(std::filesystem::last_write_time(path).time_since_epoch().count());
+
+  hash                         = fnv1a(path_name.c_str(), path_name.size() + 1, hash);
+  hash                         = fnv1a(&size, sizeof(size), hash);
+  hash                         = fnv1a(&write_time, sizeof(write_time), hash);
+
+  return hash;
+}
+
+/**
+ * @brief Serializes values into a little-endian binary buffer.
+ */
+class Writer
+{
+public:
+  /**
+   * @brief Write a trivially copyable value.
+   *
+   * @tparam Tp The type of a value.
+   * @param value The value.
+   */
+  template <typename Tp>
+  void
+  write(const Tp& value)
+  {
+    static_assert(std::is_trivially_copyable_v<Tp>, "Serialize Error: Only trivially copyable types can be written as is.");
+    m_buffer.append(reinterpret_cast<const char*>(&value), sizeof(Tp));
+  }
+
+  /**
+   * @brief Write a string prefixed by its size.
+   *
+   * @param value The string.
+   */
+  void
+  write(const std::string& value)
+  {
+    write<uint64_t>(value.size());
+    m_buffer.append(value);
+  }
+
+  /**
+   * @brief Returns the written data.
+   *
+   * @return const std::string&
+   */
+  const std::string&
+  buffer() const noexcept(true)
+  {
+    return m_buffer;
+  }
+
+private:
+  std::string m_buffer; ///> The written data.
+};
+
+/**
+ * @brief Deserializes values written by the Writer, all reads are bounds checked.
+ */
+class Reader
+{
+public:
+  /**
+   * @brief Construct a new Reader, the data must outlive the reader.
+   *
+   * @param data The data to read.
+   * @param size The size of the data in bytes.
+   */
+  Reader(const char* data, const std::size_t size)
+      : m_data(data), m_size(size) {};
+
+public:
+  /**
+   * @brief Read a trivially copyable value.
+   *
+   * @tparam Tp The type of a value.
+   * @param value The value.
+   */
+  template <typename Tp>
+  void
+  read(Tp& value)
+  {
+    static_assert(std::is_trivially_copyable_v<Tp>, "Serialize Error: Only trivially copyable types can be read as is.");
+    require(sizeof(Tp));
+
+    std::memcpy(&value, m_data + m_pos, sizeof(Tp));
+    m_pos += sizeof(Tp);
+  }
+
+  /**
+   * @brief Read a string prefixed by its size.
+   *
+   * @param value The string.
+   */
+  void
+  read(std::string& value)
+  {
+    uint64_t size;
+    read(size);
+    require(size);
+
+    value.assign(m_data + m_pos, size);
+    m_pos += size;
+  }
+
+  /**
+   * @brief Read a value of the given type.
+   *
+   * @tparam Tp The type of a value.
+   * @return Tp
+   */
+  template <typename Tp>
+  Tp
+  read()
+  {
+    Tp value;
+    read(value);
+    return value;
+  }
+
+  /**
+   * @brief Checks if all data has been read.
+   *
+   * @return true
+   * @return false
+   */
+  bool
+  is_end() const noexcept(true)
+  {
+    return m_pos == m_size;
+  }
+
+private:
+  /**
+   * @brief Throws if less than the size of bytes are left.
+   *
+   * @param size The number of bytes to read.
+   */
+  void
+  require(const std::size_t size) const
+  {
+    if(size > m_size - m_pos)
+      {
+        throw std::runtime_error("Serialize Error: Unexpected end of data.");
+      }
+  }
+
+private:
+  const char* m_data;    ///> The data to read.
+  std::size_t m_size;    ///> The size of the data.
+  std::size_t m_pos = 0; ///> The current position.
+};
+
+/**
+ * @brief Write a polygon as its metal and its points.
+ *
+ * @param writer The writer.
+ * @param polygon The polygon.
+ */
+inline void
+write_polygon(Writer& writer, const geom::Polygon& polygon)
+{
+  writer.write(polygon.m_metal);
+  writer.write<uint64_t>(polygon.m_points.size());
+
+  for(const auto& point : polygon.m_points)
+    {
+      writer.write(point.x);
+      writer.write(point.y);
+    }
+}
+
+/**
+ * @brief Read a polygon written by the write_polygon.
+ *
+ * @param reader The reader.
+ * @param polygon The polygon.
+ */
+inline void
+read_polygon(Reader& reader, geom::Polygon& polygon)
+{
+  reader.read(polygon.m_metal);
+  polygon.m_points.resize(reader.read<uint64_t>());
+
+  for(auto& point : polygon.m_points)
+    {
+      reader.read(point.x);
+      reader.read(point.y);
+    }
+}
+
+/**
+ * @brief Write polygons prefixed by their number.
+ *
+ * @param writer The writer.
+ * @param polygons The polygons.
+ */
+inline void
+write_polygons(Writer& writer, const std::vector<geom::Polygon>& polygons)
+{
+  writer.write<uint64_t>(polygons.size());
+
+  for(const auto& polygon : polygons)
+    {
+      write_polygon(writer, polygon);
+    }
+}
+
+/**
+ * @brief Read polygons written by the write_polygons.
+ *
+ * @param reader The reader.
+ * @param polygons The polygons.
+ */
+inline void
+read_polygons(Reader& reader, std::vector<geom::Polygon>& polygons)
+{
+  polygons.resize(reader.read<uint64_t>());
+
+  for(auto& polygon : polygons)
+    {
+      read_polygon(reader, polygon);
+    }
+}
+
+} // namespace serialize
+
+#endif
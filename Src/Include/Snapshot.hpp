@@ -0,0 +1,49 @@
+#ifndef __SNAPSHOT_HPP__
+#define __SNAPSHOT_HPP__
+
+#include <cstdint>
+#include <filesystem>
+#include <vector>
+
+#include "Include/DEF/DEF.hpp"
+
+namespace snapshot
+{
+
+/**
+ * @brief Makes the key of a snapshot from paths, sizes and modification times of input files.
+ *
+ * @param files All files the routing state is made from.
+ * @return uint64_t
+ */
+uint64_t
+make_key(const std::vector<std::filesystem::path>& files);
+
+/**
+ * @brief Saves the routing state of a design: the gcell grid with obstacles, pins, access points, nets and stacks.
+ *
+ * The state must be saved before stacks are solved, matrices and graphs of stacks are not the part of a snapshot.
+ * The snapshot is replaced atomically so concurrent runs never see a partial one.
+ *
+ * @param path The path to a snapshot.
+ * @param key The key of input files.
+ * @param data The design data.
+ */
+void
+save(const std::filesystem::path& path, const uint64_t key, const def::Data& data);
+
+/**
+ * @brief Loads the routing state of a design.
+ *
+ * @param path The path to a snapshot.
+ * @param key The key of input files the snapshot must be made for.
+ * @param data Loaded data, untouched if the snapshot can't be loaded.
+ * @return true - The snapshot is valid and has been loaded.
+ * @return false
+ */
+bool
+load(const std::filesystem::path& path, const uint64_t key, def::Data& data);
+
+} // namespace snapshot
+
+#endif
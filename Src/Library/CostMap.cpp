@@ -0,0 +1,173 @@
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+
+#include "Include/CostMap.hpp"
+
+namespace algorithms
+{
+
+constexpr uint32_t INF        = std::numeric_limits<uint32_t>::max();
+constexpr double   INF_VALUE  = std::numeric_limits<double>::max();
+constexpr uint32_t ORIGIN_MAX = 0xFFFF; ///> Origins pack both coordinates into a single word.
+
+CostMap::CostMap(const matrix::Matrix<>& source, const matrix::SetOfNodes& obs)
+    : m_size_x(source.m_shape.m_x), m_size_y(source.m_shape.m_y), m_queued(0)
+{
+  if(source.m_shape.m_z != 2)
+    {
+      throw std::runtime_error("CostMap Error: A stack matrix must have exactly two layers.");
+    }
+
+  if(source.m_shape.m_x > ORIGIN_MAX || source.m_shape.m_y > ORIGIN_MAX)
+    {
+      throw std::runtime_error("CostMap Error: A stack matrix is too large.");
+    }
+
+  const std::size_t length = source.size();
+  const double*     values = source.data();
+
+  m_open.resize(length);
+  m_costs.resize(length);
+  m_origins.resize(length);
+
+  for(std::size_t i = 0; i < length; ++i)
+    {
+      m_open[i] = values[i] != 0.0;
+    }
+
+  for(const auto& node : obs)
+    {
+      if(node.m_x < m_size_x && node.m_y < m_size_y && node.m_z < 2)
+        {
+          m_open[index(node.m_x, node.m_y, node.m_z)] = 0;
+        }
+    }
+}
+
+void
+CostMap::compute(const matrix::SetOfNodes& terminals, const matrix::View<double> horizontal, const matrix::View<double> vertical)
+{
+  std::fill(m_costs.begin(), m_costs.end(), INF);
+
+  for(const auto& terminal : terminals)
+    {
+      const uint32_t node = index(terminal.m_x, terminal.m_y, terminal.m_z == 0 ? 0 : 1);
+
+      m_costs[node]       = 0;
+      m_origins[node]     = terminal.m_x | (terminal.m_y << 16);
+
+      m_buckets[0].push_back(node);
+      ++m_queued;
+    }
+
+  /** All edges are longer than zero and shorter than BUCKETS, so a bucket holds nodes of exactly one cost when it's reached */
+  for(uint32_t cost = 0; m_queued != 0; ++cost)
+    {
+      std::vector<uint32_t>& bucket = m_buckets[cost & (BUCKETS - 1)];
+
+      for(const uint32_t node : bucket)
+        {
+          /** The node has been reached cheaper and expanded already */
+          if(m_costs[node] != cost)
+            {
+              continue;
+            }
+
+          const uint32_t z      = node & 1;
+          const uint32_t x      = (node >> 1) % m_size_x;
+          const uint32_t y      = (node >> 1) / m_size_x;
+
+          const uint32_t origin = m_origins[node];
+          const uint32_t src_x  = origin & ORIGIN_MAX;
+          const uint32_t src_y  = origin >> 16;
+
+          /** A step costs more when it leaves the row (the column) of the terminal and twice as much off that row (column) */
+          if(z == 0)
+            {
+              const uint32_t factor = y == src_y ? 1 : 2;
+
+              if(x > 0)
+                {
+                  relax(node - 2, cost + (x <= src_x ? UNIT + DETOUR_COST : UNIT - DETOUR_COST) * factor, origin);
+                }
+
+              if(x + 1 < m_size_x)
+                {
+                  relax(node + 2, cost + (x >= src_x ? UNIT + DETOUR_COST : UNIT - DETOUR_COST) * factor, origin);
+                }
+
+              relax(node + 1, cost + SWITCH_COST, origin);
+            }
+          else
+            {
+              const uint32_t factor = x == src_x ? 1 : 2;
+              const uint32_t row    = 2 * m_size_x;
+
+              if(y > 0)
+                {
+                  relax(node - row, cost + (y <= src_y ? UNIT + DETOUR_COST : UNIT - DETOUR_COST) * factor, origin);
+                }
+
+              if(y + 1 < m_size_y)
+                {
+                  relax(node + row, cost + (y >= src_y ? UNIT + DETOUR_COST : UNIT - DETOUR_COST) * factor, origin);
+                }
+
+              relax(node - 1, cost + SWITCH_COST, origin);
+            }
+        }
+
+      m_queued -= bucket.size();
+      bucket.clear();
+    }
+
+  for(uint32_t y = 0; y < m_size_y; ++y)
+    {
+      for(uint32_t x = 0; x < m_size_x; ++x)
+        {
+          const uint32_t cost_h = m_costs[index(x, y, 0)];
+          const uint32_t cost_v = m_costs[index(x, y, 1)];
+
+          horizontal(x, y)      = cost_h == INF ? INF_VALUE : double(cost_h) / UNIT;
+          vertical(x, y)        = cost_v == INF ? INF_VALUE : double(cost_v) / UNIT;
+        }
+    }
+
+  /** Lower cost means a higher probability, so maps are inverted while normalized by the common range */
+  const auto [min_h, max_h] = horizontal.min_max(INF_VALUE);
+  const auto [min_v, max_v] = vertical.min_max(INF_VALUE);
+
+  const double min          = std::min(min_h, min_v);
+  const double max          = std::max(max_h, max_v);
+
+  horizontal.normalize_inverse(min, max, 0.9, INF_VALUE);
+  vertical.normalize_inverse(min, max, 0.9, INF_VALUE);
+
+  for(const auto& terminal : terminals)
+    {
+      if(terminal.m_z == 0)
+        {
+          horizontal(terminal.m_x, terminal.m_y) = 1.0;
+        }
+      else
+        {
+          vertical(terminal.m_x, terminal.m_y) = 1.0;
+        }
+    }
+}
+
+void
+CostMap::relax(const uint32_t node, const uint32_t cost, const uint32_t origin)
+{
+  if(m_open[node] != 0 && cost < m_costs[node])
+    {
+      m_costs[node]   = cost;
+      m_origins[node] = origin;
+
+      m_buckets[cost & (BUCKETS - 1)].push_back(node);
+      ++m_queued;
+    }
+}
+
+} // namespace algorithms
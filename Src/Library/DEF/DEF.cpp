@@ -259,11 +259,11 @@ DEF::component_start_callback(int32_t param, Data& data)
 
               if(i == 0)
                 {
-                  gcell->set_base(geom::Point(left_edge_x, left_edge_y), geom::Point(right_edge_x, right_edge_y), step, end_i);
+                  gcell->set_base(geom::Point(left_edge_x, left_edge_y), geom::Point(right_edge_x, right_edge_y), geom::to_coord(step), end_i);
                 }
               else
                 {
-                  gcell->add_track(geom::Point(left_edge_x, left_edge_y), geom::Point(right_edge_x, right_edge_y), step, data.m_tracks[i].m_metal);
+                  gcell->add_track(geom::Point(left_edge_x, left_edge_y), geom::Point(right_edge_x, right_edge_y), geom::to_coord(step), data.m_tracks[i].m_metal);
                 }
             }
 
@@ -276,6 +276,7 @@ DEF::component_start_callback(int32_t param, Data& data)
   data.m_max_gcell_x = max_grid_x;
   data.m_max_gcell_y = max_grid_y;
   data.m_gcells      = std::move(gcells);
+  data.m_gcell_index = GCellIndex(std::move(columns), std::move(rows));
   data.m_components.reserve(param);
 }
 
@@ -324,28 +325,16 @@ DEF::pin_callback(defiPin* param, Data& data)
               top_metal = metal;
             }
 
-          geom::Polygon target({ static_cast<double>(xl) + x, static_cast<double>(yl) + y, static_cast<double>(xh) + x, static_cast<double>(yh) + y }, metal);
-
-          // TODO Find a way to optimize this part
-          auto          remove_itr = std::remove_if(polygons[metal].begin(), polygons[metal].end(), [&target](const auto& polygon) {
-            if(!(target / polygon))
-              {
-                return false;
-              }
-
-            target += polygon;
-            return true;
-          });
-
-          if(remove_itr != polygons[metal].end())
-            {
-              polygons[metal].erase(remove_itr, polygons[metal].end());
-            }
-
-          polygons[metal].emplace_back(std::move(target));
+          polygons[metal].emplace_back(geom::Polygon({ static_cast<double>(xl) + x, static_cast<double>(yl) + y, static_cast<double>(xh) + x, static_cast<double>(yh) + y }, metal));
         }
     }
 
+  /** Rectangles of all ports are merged per layer at once */
+  for(auto& [metal, v_polygons] : polygons)
+    {
+      geom::merge_overlapping(v_polygons);
+    }
+
   if(polygons.size() == 0)
     {
       return;
@@ -459,13 +448,8 @@ DEF::net_callback(defiNet* param, Data& data)
                             y += width / 2;
                           }
 
-                        const geom::Polygon target({ prev_x - 10.0, prev_y - 10.0, x + 10.0, y + 10.0 }, metal);
-                        auto                gcell_with_overlaps = GCell::find_overlaps(target, data.m_gcells, data.m_max_gcell_x, data.m_max_gcell_y);
-
-                        for(auto& [gcell, overlap] : gcell_with_overlaps)
-                          {
-                            gcell->m_obstacles.emplace_back(std::move(overlap));
-                          }
+                        /** Only a record is kept here, segments are assigned to gcells in parallel after parsing */
+                        data.m_wires.push_back(WireTemplate{ { prev_x - 10, prev_y - 10, x + 10, y + 10 }, metal });
 
                         x      = -1;
                         y      = -1;
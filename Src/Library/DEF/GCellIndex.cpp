@@ -0,0 +1,79 @@
+#include <algorithm>
+
+#include "Include/DEF/GCellIndex.hpp"
+
+namespace def::details
+{
+
+/** Finds cells of an axis, which intervals [edges[i], edges[i + 1]) overlap [begin, end), a point is treated as [begin, begin], the far edge of the grid belongs to the last cell */
+bool
+find_axis_range(const std::vector<double>& edges, const double begin, const double end, std::size_t& first, std::size_t& last)
+{
+  if(edges.size() < 2 || begin > edges.back() || (begin == edges.back() && begin != end) || end < edges.front() || (end == edges.front() && begin != end))
+    {
+      return false;
+    }
+
+  const std::size_t last_cell = edges.size() - 2;
+  const auto        first_itr = std::upper_bound(edges.begin(), edges.end(), begin);
+  const auto        last_itr  = std::lower_bound(edges.begin(), edges.end(), end);
+
+  first                       = std::min<std::size_t>(std::max<std::ptrdiff_t>(first_itr - edges.begin() - 1, 0), last_cell);
+  last                        = std::min<std::size_t>(std::max<std::ptrdiff_t>(last_itr - edges.begin() - 1, 0), last_cell);
+  last                        = std::max(first, last);
+
+  return true;
+}
+
+/** Finds the cell of an axis that contains a coordinate, the far edge of the grid belongs to the last cell */
+std::optional<std::size_t>
+find_axis_cell(const std::vector<double>& edges, const double value)
+{
+  if(edges.size() < 2 || value < edges.front() || value > edges.back())
+    {
+      return std::nullopt;
+    }
+
+  const auto itr = std::upper_bound(edges.begin(), edges.end(), value);
+
+  return std::min<std::size_t>(itr - edges.begin() - 1, edges.size() - 2);
+}
+
+} // namespace def::details
+
+namespace def
+{
+
+std::optional<CellRange>
+GCellIndex::find_range(const geom::Point& left_top, const geom::Point& right_bottom) const
+{
+  CellRange range;
+
+  if(!details::find_axis_range(m_columns, left_top.x, right_bottom.x, range.m_left, range.m_right))
+    {
+      return std::nullopt;
+    }
+
+  if(!details::find_axis_range(m_rows, left_top.y, right_bottom.y, range.m_top, range.m_bottom))
+    {
+      return std::nullopt;
+    }
+
+  return range;
+}
+
+std::optional<std::pair<std::size_t, std::size_t>>
+GCellIndex::find_cell(const geom::Point& point) const
+{
+  const std::optional<std::size_t> column = details::find_axis_cell(m_columns, point.x);
+  const std::optional<std::size_t> row    = details::find_axis_cell(m_rows, point.y);
+
+  if(!column || !row)
+    {
+      return std::nullopt;
+    }
+
+  return std::make_pair(*column, *row);
+}
+
+} // namespace def
@@ -18,9 +18,9 @@ find_access_points(const geom::Polygon& poly, const types::Metal target, const s
   std::vector<std::pair<geom::Point, geom::PointS>> inner_access_points;
   std::vector<std::pair<geom::Point, geom::PointS>> outer_access_points;
 
-  for(double y = grid_start.y; y <= grid_end.y; y += grid.m_step)
+  for(geom::Coord y = grid_start.y; y <= grid_end.y; y += grid.m_step)
     {
-      for(double x = grid_start.x; x <= grid_end.x; x += grid.m_step)
+      for(geom::Coord x = grid_start.x; x <= grid_end.x; x += grid.m_step)
         {
           const geom::Point  point = { x, y };
           const geom::PointS proj  = project_down<geom::PointS>(point, target_metal, grids);
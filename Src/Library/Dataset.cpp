@@ -0,0 +1,940 @@
+#include <algorithm>
+#include <cerrno>
+#include <charconv>
+#include <cmath>
+#include <cstddef>
+#include <cstring>
+#include <iterator>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "Include/Dataset.hpp"
+#include "Include/Numpy.hpp"
+
+namespace dataset::details
+{
+
+/** Record format version */
+constexpr uint32_t    RECORD_VERSION = 1;
+
+/** Size of a shard after which the next shard is started */
+constexpr std::size_t MAX_SHARD_SIZE = std::size_t(1) << 30;
+
+/** Names of options in order of enumerators, written to the dataset.ini */
+constexpr const char* FORMAT_NAMES[] = { "npy", "shard" };
+constexpr const char* COST_NAMES[]   = { "f64", "f32", "f16", "u8" };
+constexpr const char* PATH_NAMES[]   = { "f64", "u8", "bits" };
+
+/** Support function for records alignment, so tensors can be mapped without copies */
+inline std::size_t
+align_up(const std::size_t size)
+{
+  return (size + 7) & ~std::size_t(7);
+}
+
+/**
+ * @brief Sync a file to the disk, ofstreams don't expose their descriptors so the file is opened again.
+ *
+ * @param path The path to a file.
+ */
+void
+sync_file(const std::filesystem::path& path)
+{
+  const int file = open(path.c_str(), O_RDONLY);
+
+  if(file < 0 || fsync(file) != 0)
+    {
+      if(file >= 0)
+        {
+          close(file);
+        }
+
+      throw std::runtime_error("Dataset Error: Can't sync the file - \"" + path.string() + "\".");
+    }
+
+  close(file);
+}
+
+uint16_t
+to_half(const double value)
+{
+  uint64_t bits;
+  std::memcpy(&bits, &value, sizeof(bits));
+
+  const uint16_t sign = static_cast<uint16_t>((bits >> 48) & 0x8000);
+  const uint64_t abs  = bits & 0x7FFFFFFFFFFFFFFF;
+
+  /** Infinity and NaN */
+  if(abs >= 0x7FF0000000000000)
+    {
+      return sign | 0x7C00 | (abs != 0x7FF0000000000000 ? 0x0200 : 0);
+    }
+
+  /** Values from 65520 round to infinity */
+  if(abs >= 0x40EFFE0000000000)
+    {
+      return sign | 0x7C00;
+    }
+
+  /** Normal values, from 2^-14 */
+  if(abs >= 0x3F10000000000000)
+    {
+      uint64_t       half      = (abs >> 42) - (uint64_t(1023 - 15) << 10);
+      const uint64_t remainder = abs & ((uint64_t(1) << 42) - 1);
+
+      if(remainder > (uint64_t(1) << 41) || (remainder == (uint64_t(1) << 41) && (half & 1) != 0))
+        {
+          ++half;
+        }
+
+      return sign | static_cast<uint16_t>(half);
+    }
+
+  /** Values below 2^-25 round to zero */
+  if(abs < 0x3E60000000000000)
+    {
+      return sign;
+    }
+
+  /** Subnormal values, a half is the mantissa times 2^-24 */
+  const uint64_t exponent  = abs >> 52;
+  const uint64_t mantissa  = (abs & ((uint64_t(1) << 52) - 1)) | (uint64_t(1) << 52);
+  const uint64_t shift     = 1051 - exponent;
+  const uint64_t halfway   = uint64_t(1) << (shift - 1);
+  const uint64_t remainder = mantissa & ((uint64_t(1) << shift) - 1);
+  uint64_t       half      = mantissa >> shift;
+
+  if(remainder > halfway || (remainder == halfway && (half & 1) != 0))
+    {
+      ++half;
+    }
+
+  return sign | static_cast<uint16_t>(half);
+}
+
+Tensor
+encode_cost(const matrix::Matrix<>& cost, const CostType type)
+{
+  const matrix::Shape& shape  = cost.m_shape;
+  const std::size_t    length = shape.m_x * shape.m_y * shape.m_z;
+  const double*        values = cost.data();
+
+  Tensor               tensor;
+  tensor.m_shape = { shape.m_y, shape.m_x, shape.m_z };
+
+  switch(type)
+    {
+    case CostType::F64:
+      tensor.m_dtype = "<f8";
+      tensor.m_data.resize(length * sizeof(double));
+      std::memcpy(tensor.m_data.data(), values, tensor.m_data.size());
+      break;
+    case CostType::F32:
+      {
+        tensor.m_dtype = "<f4";
+        tensor.m_data.resize(length * sizeof(float));
+        float* data = reinterpret_cast<float*>(tensor.m_data.data());
+
+        for(std::size_t i = 0; i < length; ++i)
+          {
+            data[i] = static_cast<float>(values[i]);
+          }
+      }
+      break;
+    case CostType::F16:
+      {
+        tensor.m_dtype = "<f2";
+        tensor.m_data.resize(length * sizeof(uint16_t));
+
+        for(std::size_t i = 0; i < length; ++i)
+          {
+            const uint16_t half = to_half(values[i]);
+            std::memcpy(tensor.m_data.data() + i * sizeof(uint16_t), &half, sizeof(uint16_t));
+          }
+      }
+      break;
+    case CostType::U8:
+      {
+        tensor.m_dtype = "|u1";
+        tensor.m_data.resize(length);
+
+        for(std::size_t i = 0; i < length; ++i)
+          {
+            tensor.m_data[i] = static_cast<char>(std::lround(std::clamp(values[i], 0.0, 1.0) * 255.0));
+          }
+      }
+      break;
+    }
+
+  return tensor;
+}
+
+Tensor
+encode_path(const matrix::Matrix<uint8_t>& path, const PathType type)
+{
+  const matrix::Shape& shape  = path.m_shape;
+  const std::size_t    length = shape.m_x * shape.m_y;
+  const uint8_t*       values = path.data();
+
+  Tensor               tensor;
+
+  switch(type)
+    {
+    case PathType::F64:
+      {
+        tensor.m_dtype = "<f8";
+        tensor.m_shape = { shape.m_y, shape.m_x, 1 };
+        tensor.m_data.resize(length * sizeof(double));
+        double* data = reinterpret_cast<double*>(tensor.m_data.data());
+
+        for(std::size_t i = 0; i < length; ++i)
+          {
+            data[i] = values[i];
+          }
+      }
+      break;
+    case PathType::U8:
+      tensor.m_dtype = "|u1";
+      tensor.m_shape = { shape.m_y, shape.m_x, 1 };
+      tensor.m_data.assign(reinterpret_cast<const char*>(values), reinterpret_cast<const char*>(values) + length);
+      break;
+    case PathType::BITS:
+      {
+        const std::size_t row_size = (shape.m_x + 7) / 8;
+
+        tensor.m_dtype             = "bits";
+        tensor.m_shape             = { 2, shape.m_y, row_size };
+        tensor.m_data.assign(2 * shape.m_y * row_size, 0);
+
+        char* wires = tensor.m_data.data();
+        char* vias  = tensor.m_data.data() + shape.m_y * row_size;
+
+        for(std::size_t y = 0; y < shape.m_y; ++y)
+          {
+            for(std::size_t x = 0; x < shape.m_x; ++x)
+              {
+                const uint8_t value = values[y * shape.m_x + x];
+                const char    bit   = static_cast<char>(0x80 >> (x % 8));
+
+                if(value != 0)
+                  {
+                    wires[y * row_size + x / 8] |= bit;
+                  }
+
+                if(value == 2)
+                  {
+                    vias[y * row_size + x / 8] |= bit;
+                  }
+              }
+          }
+      }
+      break;
+    }
+
+  return tensor;
+}
+
+} // namespace dataset::details
+
+namespace dataset
+{
+
+Format
+to_format(const std::string& name)
+{
+  if(name == "npy")
+    {
+      return Format::NPY;
+    }
+
+  if(name == "shard")
+    {
+      return Format::SHARD;
+    }
+
+  throw std::invalid_argument("Dataset Error: Unknown dataset format - \"" + name + "\".");
+}
+
+CostType
+to_cost_type(const std::string& name)
+{
+  if(name == "f64")
+    {
+      return CostType::F64;
+    }
+
+  if(name == "f32")
+    {
+      return CostType::F32;
+    }
+
+  if(name == "f16")
+    {
+      return CostType::F16;
+    }
+
+  if(name == "u8")
+    {
+      return CostType::U8;
+    }
+
+  throw std::invalid_argument("Dataset Error: Unknown cost type - \"" + name + "\".");
+}
+
+PathType
+to_path_type(const std::string& name)
+{
+  if(name == "f64")
+    {
+      return PathType::F64;
+    }
+
+  if(name == "u8")
+    {
+      return PathType::U8;
+    }
+
+  if(name == "bits")
+    {
+      return PathType::BITS;
+    }
+
+  throw std::invalid_argument("Dataset Error: Unknown path type - \"" + name + "\".");
+}
+
+/** =============================== JOURNAL ====================================== */
+
+Journal::Journal(const std::filesystem::path& path)
+    : m_path(path)
+{
+  std::size_t valid_size = 0;
+
+  {
+    std::ifstream     file(m_path, std::ios::binary);
+    const std::string content((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+    /** Entries are read until the first incomplete one, it's the tail of a write interrupted by a kill */
+    std::size_t pos = 0;
+
+    while(pos < content.size())
+      {
+        const std::size_t line_end = content.find('\n', pos);
+
+        if(line_end == std::string::npos)
+          {
+            break;
+          }
+
+        std::size_t count    = 0;
+        const auto [ptr, ec] = std::from_chars(content.data() + pos, content.data() + line_end, count);
+
+        if(ec != std::errc() || ptr == content.data() + line_end || *ptr != ' ')
+          {
+            break;
+          }
+
+        std::vector<std::string> rows;
+        std::size_t              row_pos = line_end + 1;
+
+        for(std::size_t i = 0; i < count; ++i)
+          {
+            const std::size_t row_end = content.find('\n', row_pos);
+
+            if(row_end == std::string::npos)
+              {
+                break;
+              }
+
+            rows.emplace_back(content, row_pos, row_end - row_pos);
+            row_pos = row_end + 1;
+          }
+
+        if(rows.size() != count)
+          {
+            break;
+          }
+
+        m_keys.emplace(content, ptr + 1 - content.data(), line_end - (ptr + 1 - content.data()));
+        m_rows.insert(m_rows.end(), std::make_move_iterator(rows.begin()), std::make_move_iterator(rows.end()));
+
+        pos        = row_pos;
+        valid_size = pos;
+      }
+  }
+
+  m_file = open(m_path.c_str(), O_WRONLY | O_CREAT | O_APPEND, 0644);
+
+  if(m_file < 0)
+    {
+      throw std::runtime_error("Dataset Error: Can't open the journal - \"" + m_path.string() + "\".");
+    }
+
+  if(ftruncate(m_file, valid_size) != 0)
+    {
+      close(m_file);
+      throw std::runtime_error("Dataset Error: Can't truncate the journal - \"" + m_path.string() + "\".");
+    }
+}
+
+Journal::~Journal()
+{
+  if(m_file >= 0)
+    {
+      close(m_file);
+    }
+}
+
+bool
+Journal::contains(const std::string& key) const
+{
+  return m_keys.count(key) != 0;
+}
+
+const std::vector<std::string>&
+Journal::rows() const noexcept(true)
+{
+  return m_rows;
+}
+
+void
+Journal::append(const std::vector<std::pair<std::string, std::vector<std::string>>>& entries)
+{
+  if(entries.empty())
+    {
+      return;
+    }
+
+  std::string content;
+
+  for(const auto& [key, rows] : entries)
+    {
+      content += std::to_string(rows.size()) + " " + key + "\n";
+
+      for(const auto& row : rows)
+        {
+          content += row + "\n";
+        }
+    }
+
+  for(std::size_t written = 0; written < content.size();)
+    {
+      const ssize_t size = write(m_file, content.data() + written, content.size() - written);
+
+      if(size < 0)
+        {
+          if(errno == EINTR)
+            {
+              continue;
+            }
+
+          throw std::runtime_error("Dataset Error: Can't write the journal - \"" + m_path.string() + "\".");
+        }
+
+      written += size;
+    }
+
+  if(fsync(m_file) != 0)
+    {
+      throw std::runtime_error("Dataset Error: Can't sync the journal - \"" + m_path.string() + "\".");
+    }
+
+  for(const auto& entry : entries)
+    {
+      m_keys.insert(entry.first);
+    }
+}
+
+/** =============================== SHARD WRITER ================================= */
+
+ShardWriter::ShardWriter(const std::filesystem::path& folder, const std::size_t max_size)
+    : m_folder(folder), m_max_size(max_size)
+{
+  std::filesystem::create_directories(m_folder);
+
+  /** Shards of a resumed dataset are kept, records of completed tasks are referenced by the data.csv */
+  while(std::filesystem::exists(m_folder / shard_name(m_shard)))
+    {
+      ++m_shard;
+    }
+
+  open_next();
+}
+
+std::pair<std::string, std::size_t>
+ShardWriter::append(const details::Record& record)
+{
+  const std::vector<std::size_t>& shape  = record.m_cost_h.m_shape;
+  details::RecordHeader           header = {};
+
+  std::memcpy(header.m_magic, "FLRC", 4);
+  std::memcpy(header.m_cost_dtype, record.m_cost_h.m_dtype.data(), std::min<std::size_t>(record.m_cost_h.m_dtype.size(), 4));
+  std::memcpy(header.m_path_dtype, record.m_path.m_dtype.data(), std::min<std::size_t>(record.m_path.m_dtype.size(), 4));
+
+  header.m_version              = details::RECORD_VERSION;
+  header.m_x                    = shape[1];
+  header.m_y                    = shape[0];
+  header.m_z                    = shape[2];
+  header.m_pins_count           = record.m_pins_count;
+  header.m_nets_count           = record.m_nets_count;
+  header.m_name_size            = record.m_name.size();
+  header.m_nets_size            = record.m_nets.size();
+  header.m_cost_size            = record.m_cost_h.m_data.size();
+  header.m_path_size            = record.m_path.m_data.size();
+
+  const std::size_t text_size   = details::align_up(sizeof(header) + header.m_name_size + header.m_nets_size);
+  const std::size_t record_size = details::align_up(text_size + 2 * header.m_cost_size + header.m_path_size);
+
+  if(m_records != 0 && m_offset + record_size > m_max_size)
+    {
+      open_next();
+    }
+
+  const char padding[8] = {};
+
+  m_data.write(reinterpret_cast<const char*>(&header), sizeof(header));
+  m_data.write(record.m_name.data(), header.m_name_size);
+  m_data.write(record.m_nets.data(), header.m_nets_size);
+  m_data.write(padding, text_size - sizeof(header) - header.m_name_size - header.m_nets_size);
+  m_data.write(record.m_cost_h.m_data.data(), header.m_cost_size);
+  m_data.write(record.m_cost_v.m_data.data(), header.m_cost_size);
+  m_data.write(record.m_path.m_data.data(), header.m_path_size);
+  m_data.write(padding, record_size - text_size - 2 * header.m_cost_size - header.m_path_size);
+
+  const uint64_t offset = m_offset;
+  m_index.write(reinterpret_cast<const char*>(&offset), sizeof(offset));
+
+  if(!m_data.good() || !m_index.good())
+    {
+      throw std::runtime_error("Dataset Error: Unable to write a record to the shard - \"" + shard_name(m_shard) + "\".");
+    }
+
+  m_offset += record_size;
+
+  return { shard_name(m_shard), m_records++ };
+}
+
+void
+ShardWriter::flush()
+{
+  const std::filesystem::path data_path = m_folder / shard_name(m_shard);
+
+  m_data.flush();
+  m_index.flush();
+
+  if(!m_data.good() || !m_index.good())
+    {
+      throw std::runtime_error("Dataset Error: Unable to flush the shard - \"" + data_path.string() + "\".");
+    }
+
+  details::sync_file(data_path);
+  details::sync_file(std::filesystem::path(data_path).replace_extension(".idx"));
+}
+
+std::string
+ShardWriter::shard_name(const std::size_t shard)
+{
+  std::string number = std::to_string(shard);
+  return "shard_" + std::string(number.size() < 4 ? 4 - number.size() : 0, '0') + number + ".bin";
+}
+
+void
+ShardWriter::open_next()
+{
+  if(m_data.is_open())
+    {
+      /** The journal may reference records of a closed shard only after they reached the disk */
+      flush();
+
+      m_data.close();
+      m_index.close();
+      ++m_shard;
+    }
+
+  const std::filesystem::path data_path = m_folder / shard_name(m_shard);
+
+  m_data.open(data_path, std::ios::binary);
+  m_index.open(std::filesystem::path(data_path).replace_extension(".idx"), std::ios::binary);
+
+  if(!m_data.is_open() || !m_index.is_open())
+    {
+      throw std::runtime_error("Dataset Error: Can't open the shard - \"" + data_path.string() + "\".");
+    }
+
+  m_offset  = 0;
+  m_records = 0;
+}
+
+/** =============================== SHARD READER ================================= */
+
+ShardReader::ShardReader(const std::filesystem::path& shard_path)
+{
+  {
+    std::ifstream index(std::filesystem::path(shard_path).replace_extension(".idx"), std::ios::binary | std::ios::ate);
+
+    if(!index.is_open())
+      {
+        throw std::runtime_error("Dataset Error: Can't open the index of the shard - \"" + shard_path.string() + "\".");
+      }
+
+    m_offsets.resize(static_cast<std::size_t>(index.tellg()) / sizeof(uint64_t));
+    index.seekg(0);
+    index.read(reinterpret_cast<char*>(m_offsets.data()), m_offsets.size() * sizeof(uint64_t));
+  }
+
+  const int file = open(shard_path.c_str(), O_RDONLY);
+
+  if(file < 0)
+    {
+      throw std::runtime_error("Dataset Error: Can't open the shard - \"" + shard_path.string() + "\".");
+    }
+
+  struct stat info;
+  fstat(file, &info);
+  m_size = info.st_size;
+
+  if(m_size != 0)
+    {
+      void* data = mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, file, 0);
+
+      if(data == MAP_FAILED)
+        {
+          close(file);
+          throw std::runtime_error("Dataset Error: Can't map the shard - \"" + shard_path.string() + "\".");
+        }
+
+      m_data = static_cast<const char*>(data);
+    }
+
+  close(file);
+}
+
+ShardReader::~ShardReader()
+{
+  if(m_data != nullptr)
+    {
+      munmap(const_cast<char*>(m_data), m_size);
+    }
+}
+
+std::size_t
+ShardReader::size() const noexcept(true)
+{
+  return m_offsets.size();
+}
+
+RecordView
+ShardReader::at(const std::size_t idx) const
+{
+  if(idx >= m_offsets.size() || m_offsets[idx] + sizeof(details::RecordHeader) > m_size)
+    {
+      throw std::out_of_range("Dataset Error: Record is out of range.");
+    }
+
+  const char*           record = m_data + m_offsets[idx];
+  details::RecordHeader header;
+  std::memcpy(&header, record, sizeof(header));
+
+  if(std::memcmp(header.m_magic, "FLRC", 4) != 0 || header.m_version != details::RECORD_VERSION)
+    {
+      throw std::runtime_error("Dataset Error: Invalid record header.");
+    }
+
+  const std::size_t text_size = details::align_up(sizeof(header) + header.m_name_size + header.m_nets_size);
+
+  if(m_offsets[idx] + text_size + 2 * header.m_cost_size + header.m_path_size > m_size)
+    {
+      throw std::runtime_error("Dataset Error: Truncated record.");
+    }
+
+  RecordView view;
+  view.m_name       = { record + sizeof(header), header.m_name_size };
+  view.m_nets       = { record + sizeof(header) + header.m_name_size, header.m_nets_size };
+  view.m_shape      = { header.m_x, header.m_y, header.m_z };
+  view.m_cost_dtype = { record + offsetof(details::RecordHeader, m_cost_dtype), strnlen(header.m_cost_dtype, 4) };
+  view.m_path_dtype = { record + offsetof(details::RecordHeader, m_path_dtype), strnlen(header.m_path_dtype, 4) };
+  view.m_cost_h     = record + text_size;
+  view.m_cost_v     = record + text_size + header.m_cost_size;
+  view.m_path       = record + text_size + 2 * header.m_cost_size;
+  view.m_pins_count = header.m_pins_count;
+  view.m_nets_count = header.m_nets_count;
+
+  return view;
+}
+
+/** =============================== WRITER ======================================= */
+
+Writer::Writer(const std::filesystem::path& root_folder, const std::size_t capacity, const Options& options)
+    : m_options(options), m_source_folder(root_folder / "source"), m_target_folder(root_folder / "target"), m_capacity(std::max<std::size_t>(capacity, 1)), m_queue(capacity)
+{
+  /** Readers of a dataset need element types to decode tensors */
+  const std::string ini_content = std::string("[FORMAT]\n")
+                                  + "TYPE = " + details::FORMAT_NAMES[static_cast<std::size_t>(m_options.m_format)] + "\n"
+                                  + "COST = " + details::COST_NAMES[static_cast<std::size_t>(m_options.m_cost)] + "\n"
+                                  + "PATH = " + details::PATH_NAMES[static_cast<std::size_t>(m_options.m_path)] + "\n";
+
+  if(m_options.m_resume && std::filesystem::exists(root_folder / "dataset.ini"))
+    {
+      std::ifstream     ini_file(root_folder / "dataset.ini");
+      const std::string content((std::istreambuf_iterator<char>(ini_file)), std::istreambuf_iterator<char>());
+
+      if(content != ini_content)
+        {
+          throw std::runtime_error("Dataset Error: Options differ from options of the resumed dataset - \"" + root_folder.string() + "\".");
+        }
+    }
+
+  if(m_options.m_format == Format::SHARD)
+    {
+      m_shards = std::make_unique<ShardWriter>(root_folder, details::MAX_SHARD_SIZE);
+    }
+  else
+    {
+      std::filesystem::create_directories(m_source_folder);
+      std::filesystem::create_directories(m_target_folder);
+    }
+
+  {
+    std::ofstream ini_file(root_folder / "dataset.ini");
+    ini_file << ini_content;
+
+    if(!ini_file.good())
+      {
+        throw std::runtime_error("Dataset Error: Can't write the file - \"" + (root_folder / "dataset.ini").string() + "\".");
+      }
+  }
+
+  if(!m_options.m_resume)
+    {
+      std::filesystem::remove(root_folder / "journal.txt");
+    }
+
+  m_journal = std::make_unique<Journal>(root_folder / "journal.txt");
+
+  /** The data.csv is rebuilt from the journal, rows of tasks interrupted before their journal entry are dropped */
+  m_csv_file.open(root_folder / "data.csv");
+
+  if(!m_csv_file.is_open())
+    {
+      throw std::runtime_error("Dataset Error: Can't open the file - \"" + (root_folder / "data.csv").string() + "\".");
+    }
+
+  if(m_options.m_format == Format::SHARD)
+    {
+      m_csv_file << "shard,record,name,chunk,pins_count,nets_count" << std::endl;
+    }
+  else
+    {
+      m_csv_file << "source_h,source_v,net,target_path,pins_count,nets_count" << std::endl;
+    }
+
+  for(const auto& row : m_journal->rows())
+    {
+      m_csv_file << row << '\n';
+    }
+
+  m_csv_file.flush();
+
+  m_thread = std::thread(&Writer::work_loop, this);
+}
+
+Writer::~Writer()
+{
+  if(m_thread.joinable())
+    {
+      m_queue.close();
+      m_thread.join();
+    }
+}
+
+bool
+Writer::is_completed(const std::string& key) const
+{
+  return m_journal->contains(key);
+}
+
+void
+Writer::push(Batch&& batch)
+{
+  if(m_is_failed.load(std::memory_order_acquire))
+    {
+      throw std::runtime_error("Dataset Error: The writer has been stopped.");
+    }
+
+  /** Tensors are encoded by the calling thread, so the writer thread isn't a bottleneck */
+  details::EncodedBatch encoded;
+  encoded.m_task = batch.m_task;
+  encoded.m_key  = std::move(batch.m_key);
+  encoded.m_records.reserve(batch.m_samples.size());
+
+  for(auto& sample : batch.m_samples)
+    {
+      encoded.m_records.emplace_back(encode(sample));
+
+      /** Tensors aren't needed after encoding, their buffers are reused by the next samples of this thread */
+      matrix::Pool<>::local().release(std::move(sample.m_cost_h));
+      matrix::Pool<>::local().release(std::move(sample.m_cost_v));
+      matrix::Pool<uint8_t>::local().release(std::move(sample.m_path));
+    }
+
+  batch.m_samples.clear();
+
+  if(!m_queue.push(std::move(encoded)))
+    {
+      throw std::runtime_error("Dataset Error: The writer has been stopped.");
+    }
+}
+
+void
+Writer::finish()
+{
+  if(m_thread.joinable())
+    {
+      m_queue.close();
+      m_thread.join();
+    }
+
+  if(m_error)
+    {
+      std::rethrow_exception(m_error);
+    }
+
+  m_csv_file.close();
+}
+
+void
+Writer::work_loop()
+{
+  std::vector<details::EncodedBatch> batches;
+
+  while(m_queue.pop_all(batches, m_capacity))
+    {
+      /** Keep draining the queue after an error, so producers are never blocked */
+      if(!m_is_failed.load(std::memory_order_relaxed))
+        {
+          try
+            {
+              create_folders(batches);
+
+              for(auto& batch : batches)
+                {
+                  auto& [key, rows] = m_pending_rows[batch.m_task];
+                  key               = std::move(batch.m_key);
+
+                  for(const auto& record : batch.m_records)
+                    {
+                      rows.emplace_back(write(record));
+                    }
+                }
+
+              /** Rows are flushed only when all previous tasks are written, so data.csv doesn't depend on the scheduling */
+              std::vector<std::pair<std::string, std::vector<std::string>>> entries;
+
+              for(auto itr = m_pending_rows.find(m_next_task); itr != m_pending_rows.end(); itr = m_pending_rows.find(++m_next_task))
+                {
+                  for(const auto& row : itr->second.second)
+                    {
+                      m_csv_file << row << '\n';
+                    }
+
+                  entries.emplace_back(std::move(itr->second));
+                  m_pending_rows.erase(itr);
+                }
+
+              if(m_shards)
+                {
+                  m_shards->flush();
+                }
+
+              m_csv_file.flush();
+
+              /** Tasks are journaled last, so a completed task always has its records on the disk */
+              m_journal->append(entries);
+            }
+          catch(...)
+            {
+              m_error = std::current_exception();
+              m_is_failed.store(true, std::memory_order_release);
+            }
+        }
+
+      batches.clear();
+    }
+}
+
+details::Record
+Writer::encode(const Sample& sample) const
+{
+  return { sample.m_name,
+           sample.m_chunk,
+           sample.m_nets,
+           details::encode_cost(sample.m_cost_h, m_options.m_cost),
+           details::encode_cost(sample.m_cost_v, m_options.m_cost),
+           details::encode_path(sample.m_path, m_options.m_path),
+           sample.m_pins_count,
+           sample.m_nets_count };
+}
+
+void
+Writer::create_folders(const std::vector<details::EncodedBatch>& batches)
+{
+  if(m_options.m_format == Format::SHARD)
+    {
+      return;
+    }
+
+  for(const auto& batch : batches)
+    {
+      for(const auto& record : batch.m_records)
+        {
+          if(m_created_folders.insert(record.m_name).second)
+            {
+              std::filesystem::create_directory(m_source_folder / record.m_name);
+              std::filesystem::create_directory(m_target_folder / record.m_name);
+            }
+        }
+    }
+}
+
+std::string
+Writer::write(const details::Record& record)
+{
+  if(m_options.m_format == Format::SHARD)
+    {
+      const auto [shard, idx] = m_shards->append(record);
+
+      return shard + ","
+             + std::to_string(idx) + ","
+             + record.m_name + ","
+             + std::to_string(record.m_chunk) + ","
+             + std::to_string(record.m_pins_count) + ","
+             + std::to_string(record.m_nets_count);
+    }
+
+  const std::string           prefix        = std::to_string(record.m_chunk);
+  const std::filesystem::path source_folder = m_source_folder / record.m_name;
+  const std::filesystem::path target_folder = m_target_folder / record.m_name;
+
+  {
+    std::ofstream nets_file(source_folder / (prefix + "_nets.txt"));
+    nets_file << record.m_nets;
+  }
+
+  /** Bit-packed planes are saved as uint8 arrays, dataset.ini tells readers to unpack them */
+  const std::string path_dtype = record.m_path.m_dtype == "bits" ? "|u1" : record.m_path.m_dtype;
+
+  numpy::save_raw(source_folder / (prefix + "_h.npy"), record.m_cost_h.m_dtype, record.m_cost_h.m_data.data(), record.m_cost_h.m_data.size(), record.m_cost_h.m_shape);
+  numpy::save_raw(source_folder / (prefix + "_v.npy"), record.m_cost_v.m_dtype, record.m_cost_v.m_data.data(), record.m_cost_v.m_data.size(), record.m_cost_v.m_shape);
+  numpy::save_raw(target_folder / (prefix + "_path.npy"), path_dtype, record.m_path.m_data.data(), record.m_path.m_data.size(), record.m_path.m_shape);
+
+  return (source_folder / (prefix + "_h.npy")).string() + ","
+         + (source_folder / (prefix + "_v.npy")).string() + ","
+         + (source_folder / (prefix + "_nets.txt")).string() + ","
+         + (target_folder / (prefix + "_path.npy")).string() + ","
+         + std::to_string(record.m_pins_count) + ","
+         + std::to_string(record.m_nets_count);
+}
+
+} // namespace dataset
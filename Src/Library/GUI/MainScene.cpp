@@ -156,11 +156,19 @@ Scene::paintGL()
   m_is_gcell_hovered                                = false;
   std::pair<std::size_t, std::size_t> hovered_gcell = { 0, 0 };
 
+  /** GCells keep their positions in the grid after empty ones are removed, so the cell under the cursor is found once by the index */
+  std::optional<std::pair<std::size_t, std::size_t>> hovered_cell;
+
+  if(m_cursor_mode == CursorMode::SELECT)
+    {
+      hovered_cell = m_data->m_gcell_index.find_cell({ m_last_mouse_scene_position.x(), m_last_mouse_scene_position.y() });
+    }
+
   for(std::size_t y = 0, end_y = gcells.size(); y < end_y; ++y)
     {
       for(std::size_t x = 0, end_x = gcells[y].size(); x < end_x; ++x)
         {
-          if(m_cursor_mode == CursorMode::SELECT && gcells[y][x]->m_box.probe_point({ m_last_mouse_scene_position.x(), m_last_mouse_scene_position.y() }))
+          if(hovered_cell && gcells[y][x]->m_x == hovered_cell->first && gcells[y][x]->m_y == hovered_cell->second)
             {
               glColor4f(0.0, 1.0, 0.0, 1.00f);
               m_is_gcell_hovered = true;
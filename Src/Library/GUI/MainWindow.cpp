@@ -86,16 +86,22 @@ MainWindow::create_menu()
 }
 
 void
-MainWindow::apply_global_routing()
+MainWindow::apply_global_routing(const std::filesystem::path& project_folder)
 {
   m_proc.set_path_pdk(m_settings.m_pdk_folder);
   m_proc.set_path_design(m_settings.m_def_file);
   m_proc.set_path_guide(m_settings.m_guide_file);
+  m_proc.set_path_snapshot(project_folder / (m_settings.m_name + ".snapshot"));
 
-  m_proc.prepare_data();
-  m_proc.collect_overlaps();
-  m_proc.apply_guide();
-  m_proc.remove_empty_gcells();
+  /** Reopened projects are restored from the snapshot, until the pdk, design or guide change */
+  if(!m_proc.load_snapshot())
+    {
+      m_proc.prepare_data();
+      m_proc.collect_overlaps();
+      m_proc.apply_guide();
+      m_proc.remove_empty_gcells();
+      m_proc.save_snapshot();
+    }
 
   emit send_viewer_data(&m_proc.get_def_data());
   emit send_design(&m_proc.get_def_data());
@@ -108,8 +114,10 @@ MainWindow::open_project()
 
   if(!file_name.isEmpty())
     {
-      m_settings.read_from(file_name.toStdString());
-      apply_global_routing();
+      const std::filesystem::path project_file = file_name.toStdString();
+
+      m_settings.read_from(project_file);
+      apply_global_routing(project_file.parent_path());
     }
 }
 
@@ -132,7 +140,7 @@ MainWindow::create_project()
           m_settings.save_to(project_file);
         }
 
-      apply_global_routing();
+      apply_global_routing(project_folder);
     }
 }
 
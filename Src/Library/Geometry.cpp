@@ -1,4 +1,6 @@
+#include <algorithm>
 #include <array>
+#include <numeric>
 
 #include <clipper2/clipper.h>
 
@@ -10,13 +12,51 @@ namespace geom
 namespace details
 {
 
+/** Integer coordinates are exact, double ones are compared with a tolerance */
+constexpr Coord EPSILON = std::is_integral_v<Coord> ? Coord(0) : Coord(1e-4);
+
+/** Clipper works on integer paths natively, double paths are scaled inside Clipper by the precision */
+constexpr int32_t PRECISION = 8;
+
+using Paths = std::vector<std::vector<Point>>;
+
+Paths
+unite(const std::vector<Point>& lhs, const std::vector<Point>& rhs)
+{
+#ifdef FASTLINK_INTEGER_DBU
+  return Clipper2Lib::Union(Paths{ lhs }, Paths{ rhs }, Clipper2Lib::FillRule::NonZero);
+#else
+  return Clipper2Lib::Union(Paths{ lhs }, Paths{ rhs }, Clipper2Lib::FillRule::NonZero, PRECISION);
+#endif
+}
+
+Paths
+unite(const Paths& paths)
+{
+#ifdef FASTLINK_INTEGER_DBU
+  return Clipper2Lib::Union(paths, Clipper2Lib::FillRule::NonZero);
+#else
+  return Clipper2Lib::Union(paths, Clipper2Lib::FillRule::NonZero, PRECISION);
+#endif
+}
+
+Paths
+intersect(const std::vector<Point>& lhs, const std::vector<Point>& rhs)
+{
+#ifdef FASTLINK_INTEGER_DBU
+  return Clipper2Lib::Intersect(Paths{ lhs }, Paths{ rhs }, Clipper2Lib::FillRule::NonZero);
+#else
+  return Clipper2Lib::Intersect(Paths{ lhs }, Paths{ rhs }, Clipper2Lib::FillRule::NonZero, PRECISION);
+#endif
+}
+
 bool
 do_edges_intersect(const Point& p1, const Point& q1, const Point& p2, const Point& q2)
 {
   auto orientation = [](const Point& p, const Point& q, const Point& r) {
-    double val = (q.y - p.y) * (r.x - q.x) - (q.x - p.x) * (r.y - q.y);
+    Coord val = (q.y - p.y) * (r.x - q.x) - (q.x - p.x) * (r.y - q.y);
 
-    if(std::fabs(val) < 1e-4)
+    if((val < 0 ? -val : val) <= EPSILON)
       {
         return 0;
       }
@@ -58,6 +98,152 @@ do_edges_intersect(const Point& p1, const Point& q1, const Point& p2, const Poin
   return false;
 }
 
+/** Bounds of an axis-aligned box */
+struct Box
+{
+  Point m_min;
+  Point m_max;
+};
+
+/** Gets bounds of a polygon that is a box, opposite corners of a box are always its first and third points */
+Box
+to_box(const Polygon& polygon)
+{
+  const Point& first = polygon.m_points[0];
+  const Point& third = polygon.m_points[2];
+
+  return { Point{ std::min(first.x, third.x), std::min(first.y, third.y) }, Point{ std::max(first.x, third.x), std::max(first.y, third.y) } };
+}
+
+/** Checks if closed boxes have at least one common point, so boxes touching by an edge or a corner are intersected */
+bool
+do_boxes_intersect(const Box& lhs, const Box& rhs)
+{
+  return lhs.m_min.x <= rhs.m_max.x && rhs.m_min.x <= lhs.m_max.x && lhs.m_min.y <= rhs.m_max.y && rhs.m_min.y <= lhs.m_max.y;
+}
+
+/** Intersects two boxes, a result with zero area is empty the same way as Clipper has it */
+std::vector<Point>
+intersect_boxes(const Box& lhs, const Box& rhs)
+{
+  const Coord min_x = std::max(lhs.m_min.x, rhs.m_min.x);
+  const Coord min_y = std::max(lhs.m_min.y, rhs.m_min.y);
+  const Coord max_x = std::min(lhs.m_max.x, rhs.m_max.x);
+  const Coord max_y = std::min(lhs.m_max.y, rhs.m_max.y);
+
+  if(min_x >= max_x || min_y >= max_y)
+    {
+      return {};
+    }
+
+  return { Point{ max_x, max_y }, Point{ min_x, max_y }, Point{ min_x, min_y }, Point{ max_x, min_y } };
+}
+
+/** Unites two boxes if the union is a box as well, i.e. one box contains another or they are aligned and touch */
+bool
+unite_boxes(const Box& lhs, const Box& rhs, std::vector<Point>& result)
+{
+  const bool is_lhs_inside  = lhs.m_min.x >= rhs.m_min.x && lhs.m_max.x <= rhs.m_max.x && lhs.m_min.y >= rhs.m_min.y && lhs.m_max.y <= rhs.m_max.y;
+  const bool is_rhs_inside  = rhs.m_min.x >= lhs.m_min.x && rhs.m_max.x <= lhs.m_max.x && rhs.m_min.y >= lhs.m_min.y && rhs.m_max.y <= lhs.m_max.y;
+  const bool is_same_by_x   = lhs.m_min.x == rhs.m_min.x && lhs.m_max.x == rhs.m_max.x;
+  const bool is_same_by_y   = lhs.m_min.y == rhs.m_min.y && lhs.m_max.y == rhs.m_max.y;
+  const bool is_intersected = do_boxes_intersect(lhs, rhs);
+
+  if(!is_lhs_inside && !is_rhs_inside && !(is_intersected && (is_same_by_x || is_same_by_y)))
+    {
+      return false;
+    }
+
+  const Coord min_x = std::min(lhs.m_min.x, rhs.m_min.x);
+  const Coord min_y = std::min(lhs.m_min.y, rhs.m_min.y);
+  const Coord max_x = std::max(lhs.m_max.x, rhs.m_max.x);
+  const Coord max_y = std::max(lhs.m_max.y, rhs.m_max.y);
+
+  result            = { Point{ max_x, max_y }, Point{ min_x, max_y }, Point{ min_x, min_y }, Point{ max_x, min_y } };
+
+  return true;
+}
+
+/** Disjoint sets over indices with path halving */
+class DisjointSets
+{
+public:
+  explicit DisjointSets(const std::size_t size)
+      : m_parents(size)
+  {
+    std::iota(m_parents.begin(), m_parents.end(), 0);
+  }
+
+public:
+  std::size_t
+  find(std::size_t idx) noexcept(true)
+  {
+    while(m_parents[idx] != idx)
+      {
+        m_parents[idx] = m_parents[m_parents[idx]];
+        idx            = m_parents[idx];
+      }
+
+    return idx;
+  }
+
+  void
+  unite(const std::size_t lhs, const std::size_t rhs) noexcept(true)
+  {
+    const std::size_t lhs_root = find(lhs);
+    const std::size_t rhs_root = find(rhs);
+
+    /** The smaller root wins, so a root is always the first polygon of a group */
+    m_parents[std::max(lhs_root, rhs_root)] = std::min(lhs_root, rhs_root);
+  }
+
+private:
+  std::vector<std::size_t> m_parents; ///> Parent of each index, roots point to themselves.
+};
+
+/** Unites a group of polygons, boxes are folded by min/max from left to right while the union stays a box, the rest goes to Clipper at once */
+Polygon
+unite_group(const std::vector<Polygon>& polygons, const std::vector<std::size_t>& group)
+{
+  std::vector<std::size_t> sorted = group;
+
+  std::sort(sorted.begin(), sorted.end(), [&polygons](const std::size_t lhs, const std::size_t rhs) {
+    const Point lhs_min = polygons[lhs].get_extrem_points().first;
+    const Point rhs_min = polygons[rhs].get_extrem_points().first;
+
+    return lhs_min.x < rhs_min.x || (lhs_min.x == rhs_min.x && lhs_min.y < rhs_min.y);
+  });
+
+  Polygon     result = polygons[sorted.front()];
+  std::size_t folded = 1;
+
+  for(; folded < sorted.size() && result.is_box() && polygons[sorted[folded]].is_box(); ++folded)
+    {
+      if(!unite_boxes(to_box(result), to_box(polygons[sorted[folded]]), result.m_points))
+        {
+          break;
+        }
+    }
+
+  if(folded == group.size())
+    {
+      return result;
+    }
+
+  Paths paths;
+  paths.reserve(group.size());
+
+  for(const std::size_t idx : group)
+    {
+      paths.push_back(polygons[idx].m_points);
+    }
+
+  Paths solution  = unite(paths);
+  result.m_points = solution.empty() ? polygons[sorted.front()].m_points : std::move(solution[0]);
+
+  return result;
+}
+
 } // namespace details
 
 Polygon::Polygon()
@@ -66,12 +252,12 @@ Polygon::Polygon()
 Polygon::Polygon(const std::array<double, 4> ver, types::Metal metal)
     : m_metal(metal)
 {
-  double min_x = std::min(ver[0], ver[2]);
-  double max_x = std::max(ver[0], ver[2]);
-  double min_y = std::min(ver[1], ver[3]);
-  double max_y = std::max(ver[1], ver[3]);
+  Coord min_x = to_coord(std::min(ver[0], ver[2]));
+  Coord max_x = to_coord(std::max(ver[0], ver[2]));
+  Coord min_y = to_coord(std::min(ver[1], ver[3]));
+  Coord max_y = to_coord(std::max(ver[1], ver[3]));
 
-  m_points     = { Point{ max_x, max_y }, Point{ min_x, max_y }, Point{ min_x, min_y }, Point{ max_x, min_y } };
+  m_points    = { Point{ max_x, max_y }, Point{ min_x, max_y }, Point{ min_x, min_y }, Point{ max_x, min_y } };
 }
 
 Polygon
@@ -87,14 +273,21 @@ operator+(const Polygon& lhs, const Polygon& rhs)
       return rhs;
     }
 
-  std::vector<std::vector<Point>> solution = Clipper2Lib::Union({ lhs.m_points }, { rhs.m_points }, Clipper2Lib::FillRule::NonZero, 8);
+  Polygon polygon;
+
+  if(lhs.is_box() && rhs.is_box() && details::unite_boxes(details::to_box(lhs), details::to_box(rhs), polygon.m_points))
+    {
+      polygon.m_metal = lhs.m_metal;
+      return polygon;
+    }
+
+  details::Paths solution = details::unite(lhs.m_points, rhs.m_points);
 
   if(solution.empty())
     {
       return {};
     }
 
-  Polygon polygon;
   polygon.m_metal  = lhs.m_metal;
   polygon.m_points = solution[0];
 
@@ -114,7 +307,21 @@ operator-(const Polygon& lhs, const Polygon& rhs)
       return rhs;
     }
 
-  std::vector<std::vector<Point>> solution = Clipper2Lib::Intersect({ lhs.m_points }, { rhs.m_points }, Clipper2Lib::FillRule::NonZero, 8);
+  if(lhs.is_box() && rhs.is_box())
+    {
+      Polygon polygon;
+      polygon.m_points = details::intersect_boxes(details::to_box(lhs), details::to_box(rhs));
+
+      if(polygon.m_points.empty())
+        {
+          return {};
+        }
+
+      polygon.m_metal = lhs.m_metal;
+      return polygon;
+    }
+
+  details::Paths solution = details::intersect(lhs.m_points, rhs.m_points);
 
   if(solution.empty())
     {
@@ -131,7 +338,12 @@ operator-(const Polygon& lhs, const Polygon& rhs)
 bool
 operator/(const Polygon& lhs, const Polygon& rhs)
 {
-  std::vector<std::vector<Point>> solution = Clipper2Lib::Intersect({ lhs.m_points }, { rhs.m_points }, Clipper2Lib::FillRule::NonZero, 8);
+  if(lhs.is_box() && rhs.is_box())
+    {
+      return details::do_boxes_intersect(details::to_box(lhs), details::to_box(rhs));
+    }
+
+  details::Paths solution = details::intersect(lhs.m_points, rhs.m_points);
 
   if(!solution.empty())
     {
@@ -166,9 +378,14 @@ Polygon::operator+=(const Polygon& rhs)
       return *this;
     }
 
-  std::vector<std::vector<Point>> solution = Clipper2Lib::Union({ m_points }, { rhs.m_points }, Clipper2Lib::FillRule::NonZero, 8);
+  if(is_box() && rhs.is_box() && details::unite_boxes(details::to_box(*this), details::to_box(rhs), m_points))
+    {
+      return *this;
+    }
+
+  details::Paths solution = details::unite(m_points, rhs.m_points);
 
-  m_points                                 = std::move(solution[0]);
+  m_points                = std::move(solution[0]);
 
   return *this;
 }
@@ -181,9 +398,15 @@ Polygon::operator-=(const Polygon& rhs)
       return *this;
     }
 
-  std::vector<std::vector<Point>> solution = Clipper2Lib::Intersect({ m_points }, { rhs.m_points }, Clipper2Lib::FillRule::NonZero, 8);
+  if(is_box() && rhs.is_box())
+    {
+      m_points = details::intersect_boxes(details::to_box(*this), details::to_box(rhs));
+      return *this;
+    }
+
+  details::Paths solution = details::intersect(m_points, rhs.m_points);
 
-  m_points                                 = std::move(solution[0]);
+  m_points                = std::move(solution[0]);
 
   return *this;
 }
@@ -193,8 +416,8 @@ Polygon::scale_by(const double factor)
 {
   for(auto& point : m_points)
     {
-      point.x *= factor;
-      point.y *= factor;
+      point.x = to_coord(point.x * factor);
+      point.y = to_coord(point.y * factor);
     }
 }
 
@@ -265,19 +488,138 @@ Polygon::get_center() const
   // center.y /= (6.0 * signed_area);
 
   const auto [left_top, right_bottom] = get_extrem_points();
-  return { (left_top.x + right_bottom.x) / 2.0, (left_top.y + right_bottom.y) / 2.0 };
+  return { to_coord((left_top.x + right_bottom.x) / 2.0), to_coord((left_top.y + right_bottom.y) / 2.0) };
+}
+
+bool
+Polygon::is_box() const noexcept(true)
+{
+  if(m_points.size() != 4)
+    {
+      return false;
+    }
+
+  const Point& p0 = m_points[0];
+  const Point& p1 = m_points[1];
+  const Point& p2 = m_points[2];
+  const Point& p3 = m_points[3];
+
+  return (p0.y == p1.y && p1.x == p2.x && p2.y == p3.y && p3.x == p0.x) || (p0.x == p1.x && p1.y == p2.y && p2.x == p3.x && p3.y == p0.y);
 }
 
 bool
 Polygon::probe_point(const Point& point) const
 {
+  if(is_box())
+    {
+      const details::Box box = details::to_box(*this);
+      return point.x >= box.m_min.x && point.x <= box.m_max.x && point.y >= box.m_min.y && point.y <= box.m_max.y;
+    }
+
   return Clipper2Lib::PointInPolygon(point, m_points) != Clipper2Lib::PointInPolygonResult::IsOutside;
 }
 
 double
 Polygon::get_area() const
 {
-  return Clipper2Lib::Area<double>(m_points);
+  if(is_box())
+    {
+      const details::Box box = details::to_box(*this);
+      return static_cast<double>(box.m_max.x - box.m_min.x) * static_cast<double>(box.m_max.y - box.m_min.y);
+    }
+
+  return Clipper2Lib::Area<Coord>(m_points);
+}
+
+void
+merge_overlapping(std::vector<Polygon>& polygons)
+{
+  if(polygons.size() < 2)
+    {
+      return;
+    }
+
+  std::vector<std::pair<Point, Point>> bounds(polygons.size());
+  std::vector<std::size_t>             order;
+  order.reserve(polygons.size());
+
+  for(std::size_t i = 0; i < polygons.size(); ++i)
+    {
+      if(!polygons[i].m_points.empty())
+        {
+          bounds[i] = polygons[i].get_extrem_points();
+          order.push_back(i);
+        }
+    }
+
+  std::sort(order.begin(), order.end(), [&bounds](const std::size_t lhs, const std::size_t rhs) { return bounds[lhs].first.x < bounds[rhs].first.x; });
+
+  /** Sweep by x, only polygons with intersected bounds are tested exactly */
+  details::DisjointSets    sets(polygons.size());
+  std::vector<std::size_t> active;
+
+  for(const std::size_t idx : order)
+    {
+      const auto& [left_top, right_bottom] = bounds[idx];
+
+      std::erase_if(active, [&bounds, &left_top](const std::size_t other) { return bounds[other].second.x < left_top.x; });
+
+      for(const std::size_t other : active)
+        {
+          if(bounds[other].first.y > right_bottom.y || bounds[other].second.y < left_top.y || sets.find(other) == sets.find(idx))
+            {
+              continue;
+            }
+
+          if(polygons[idx] / polygons[other])
+            {
+              sets.unite(idx, other);
+            }
+        }
+
+      active.push_back(idx);
+    }
+
+  std::vector<std::vector<std::size_t>> groups;
+  std::vector<std::size_t>              group_of_root(polygons.size(), polygons.size());
+
+  for(std::size_t i = 0; i < polygons.size(); ++i)
+    {
+      const std::size_t root = sets.find(i);
+
+      if(group_of_root[root] == polygons.size())
+        {
+          group_of_root[root] = groups.size();
+          groups.emplace_back();
+        }
+
+      groups[group_of_root[root]].push_back(i);
+    }
+
+  if(groups.size() == polygons.size())
+    {
+      return;
+    }
+
+  /** Members of a group are in ascending order, groups are ordered by their last members as pins were merged one rectangle at a time */
+  std::sort(groups.begin(), groups.end(), [](const auto& lhs, const auto& rhs) { return lhs.back() < rhs.back(); });
+
+  std::vector<Polygon> merged;
+  merged.reserve(groups.size());
+
+  for(const auto& group : groups)
+    {
+      if(group.size() == 1)
+        {
+          merged.push_back(std::move(polygons[group.front()]));
+        }
+      else
+        {
+          merged.push_back(details::unite_group(polygons, group));
+        }
+    }
+
+  polygons = std::move(merged);
 }
 
 } // namespace geom
@@ -1,7 +1,6 @@
 #include <algorithm>
 #include <numeric>
-#include <queue>
-#include <unordered_map>
+#include <stdexcept>
 
 #include "Include/Graph.hpp"
 
@@ -26,102 +25,283 @@ operator==(const Edge& lhs, const Edge& rhs)
   return lhs.m_source == rhs.m_source && rhs.m_destination == lhs.m_destination;
 }
 
+/** =============================== BUILDING ===================================== */
+
 void
 Graph::place_node()
 {
-  m_adj.push_back({});
+  ++m_nodes_count;
 }
 
 void
 Graph::add_edge(uint32_t weight, uint32_t source, uint32_t destination)
 {
-  auto&      source_v = m_adj.at(source);
-  const Edge source_edge{ weight, source, destination };
+  if(source >= m_nodes_count || destination >= m_nodes_count)
+    {
+      throw std::out_of_range("Graph Error: A node of an edge doesn't exist.");
+    }
+
+  if(!is_frozen())
+    {
+      m_pending.emplace_back(weight, source, destination);
+      m_pending.emplace_back(weight, destination, source);
+      return;
+    }
 
-  if(std::find(source_v.begin(), source_v.end(), source_edge) == source_v.end())
+  if(find_edge(source, destination) != NONE)
     {
-      m_adj[source].emplace_back(std::move(source_edge));
+      return;
     }
 
-  auto&      destination_v = m_adj.at(destination);
-  const Edge destination_edge{ weight, destination, source };
+  /** Both directions of an overlay edge are appended next to each other, so they are dropped by truncating arrays */
+  const uint32_t edge = m_destinations.size();
 
-  if(std::find(destination_v.begin(), destination_v.end(), destination_edge) == destination_v.end())
+  m_destinations.insert(m_destinations.end(), { destination, source });
+  m_reverse.insert(m_reverse.end(), { edge + 1, edge });
+  m_disabled.insert(m_disabled.end(), 2, 0);
+  m_weights.insert(m_weights.end(), 2, weight);
+  m_base_costs.insert(m_base_costs.end(), 2, weight);
+
+  if(m_overlay_rows.size() < m_nodes_count)
     {
-      m_adj[destination].emplace_back(std::move(destination_edge));
+      m_overlay_rows.resize(m_nodes_count);
     }
+
+  const auto push_row = [this](uint32_t node, uint32_t row_edge) {
+    if(m_overlay_rows[node].empty())
+      {
+        m_overlay_touched.push_back(node);
+      }
+
+    m_overlay_rows[node].push_back(row_edge);
+  };
+
+  push_row(source, edge);
+  push_row(destination, edge + 1);
 }
 
 void
-Graph::add_cost(uint32_t cost, uint32_t source, uint32_t destination)
+Graph::freeze()
+{
+  if(is_frozen())
+    {
+      throw std::runtime_error("Graph Error: A graph is frozen already.");
+    }
+
+  const std::size_t pending_count = m_pending.size();
+
+  /** Rows are counted first and then filled in order of addition, so the first of duplicated edges is in front of its row */
+  m_offsets.assign(m_nodes_count + 1, 0);
+
+  for(const Edge& edge : m_pending)
+    {
+      ++m_offsets[edge.m_source + 1];
+    }
+
+  std::partial_sum(m_offsets.begin(), m_offsets.end(), m_offsets.begin());
+
+  std::vector<uint32_t> positions(m_offsets.begin(), m_offsets.end() - 1);
+  std::vector<uint32_t> destinations(pending_count);
+  std::vector<uint32_t> weights(pending_count);
+
+  for(const Edge& edge : m_pending)
+    {
+      const uint32_t pos = positions[edge.m_source]++;
+
+      destinations[pos]  = edge.m_destination;
+      weights[pos]       = edge.m_weight;
+    }
+
+  /** Duplicates are dropped row by row, rows are as short as degrees of nodes */
+  m_destinations.clear();
+  m_weights.clear();
+  m_destinations.reserve(pending_count);
+  m_weights.reserve(pending_count);
+
+  for(std::size_t node = 0; node < m_nodes_count; ++node)
+    {
+      const uint32_t begin = m_offsets[node];
+      const uint32_t end   = m_offsets[node + 1];
+
+      m_offsets[node]      = m_destinations.size();
+
+      for(uint32_t i = begin; i < end; ++i)
+        {
+          if(std::find(m_destinations.begin() + m_offsets[node], m_destinations.end(), destinations[i]) == m_destinations.end())
+            {
+              m_destinations.push_back(destinations[i]);
+              m_weights.push_back(weights[i]);
+            }
+        }
+    }
+
+  m_offsets[m_nodes_count]      = m_destinations.size();
+
+  const std::size_t edges_count = m_destinations.size();
+
+  m_base_costs = m_weights;
+
+  m_base_nodes_count = m_nodes_count;
+  m_base_edges_count = edges_count;
+  m_disabled.assign(edges_count, 0);
+  m_reverse.resize(edges_count);
+
+  for(uint32_t node = 0; node < m_nodes_count; ++node)
+    {
+      for(uint32_t edge = m_offsets[node], end = m_offsets[node + 1]; edge < end; ++edge)
+        {
+          m_reverse[edge] = find_edge(m_destinations[edge], node);
+        }
+    }
+
+  /** The buffer of pending edges is kept, graphs of chunks are rebuilt many times */
+  m_pending.clear();
+}
+
+bool
+Graph::disable_edge(uint32_t source, uint32_t destination)
 {
-  std::vector<graph::Edge>& source_v   = m_adj.at(source);
-  auto                      source_itr = std::find_if(source_v.begin(), source_v.end(), [destination](const graph::Edge& edge) { return destination == edge.m_destination; });
-  source_itr.base()->m_weight += cost;
+  const uint32_t edge = find_edge(source, destination);
 
-  std::vector<graph::Edge>& destination_v   = m_adj.at(destination);
-  auto                      destination_itr = std::find_if(destination_v.begin(), destination_v.end(), [source](const graph::Edge& edge) { return source == edge.m_destination; });
-  destination_itr.base()->m_weight += cost;
+  if(edge == NONE || edge >= m_base_edges_count)
+    {
+      return false;
+    }
+
+  m_disabled[edge]            = 1;
+  m_disabled[m_reverse[edge]] = 1;
+
+  m_disabled_edges.push_back(edge);
+
+  return true;
 }
 
 void
-Graph::zero_cost(uint32_t source, uint32_t destination)
+Graph::discard_overlay()
 {
-  std::vector<graph::Edge>& source_v        = m_adj.at(source);
-  auto                      source_itr      = std::find_if(source_v.begin(), source_v.end(), [destination](const graph::Edge& edge) { return destination == edge.m_destination; });
-  source_itr.base()->m_weight               = 0;
+  for(const uint32_t node : m_overlay_touched)
+    {
+      m_overlay_rows[node].clear();
+    }
+
+  for(const uint32_t edge : m_disabled_edges)
+    {
+      m_disabled[edge]            = 0;
+      m_disabled[m_reverse[edge]] = 0;
+    }
 
-  std::vector<graph::Edge>& destination_v   = m_adj.at(destination);
-  auto                      destination_itr = std::find_if(destination_v.begin(), destination_v.end(), [source](const graph::Edge& edge) { return source == edge.m_destination; });
-  destination_itr.base()->m_weight          = 0;
+  m_overlay_touched.clear();
+  m_disabled_edges.clear();
+
+  m_nodes_count = m_base_nodes_count;
+
+  m_destinations.resize(m_base_edges_count);
+  m_reverse.resize(m_base_edges_count);
+  m_disabled.resize(m_base_edges_count);
+  m_weights.resize(m_base_edges_count);
+  m_base_costs.resize(m_base_edges_count);
 }
 
 void
-Graph::restore_cost(uint32_t source, uint32_t destination)
+Graph::clear()
+{
+  m_nodes_count      = 0;
+  m_base_nodes_count = 0;
+  m_base_edges_count = 0;
+
+  m_pending.clear();
+  m_offsets.clear();
+  m_destinations.clear();
+  m_reverse.clear();
+  m_disabled.clear();
+  m_overlay_rows.clear();
+  m_overlay_touched.clear();
+  m_disabled_edges.clear();
+  m_weights.clear();
+  m_base_costs.clear();
+}
+
+/** =============================== TOPOLOGY ===================================== */
+
+uint32_t
+Graph::find_edge(uint32_t source, uint32_t destination) const
+{
+  if(source < m_base_nodes_count)
+    {
+      for(uint32_t edge = m_offsets[source], end = m_offsets[source + 1]; edge < end; ++edge)
+        {
+          if(m_destinations[edge] == destination && m_disabled[edge] == 0)
+            {
+              return edge;
+            }
+        }
+    }
+
+  if(source < m_overlay_rows.size())
+    {
+      for(const uint32_t edge : m_overlay_rows[source])
+        {
+          if(m_destinations[edge] == destination)
+            {
+              return edge;
+            }
+        }
+    }
+
+  return NONE;
+}
+
+/** =============================== COSTS ======================================== */
+
+void
+Graph::add_cost(uint32_t cost, uint32_t source, uint32_t destination)
 {
-  std::vector<graph::Edge>& source_v        = m_adj.at(source);
-  auto                      source_itr      = std::find_if(source_v.begin(), source_v.end(), [destination](const graph::Edge& edge) { return destination == edge.m_destination; });
-  source_itr.base()->m_weight               = source_itr.base()->m_base_cost;
+  const auto [edge, reverse] = get_edges(source, destination);
 
-  std::vector<graph::Edge>& destination_v   = m_adj.at(destination);
-  auto                      destination_itr = std::find_if(destination_v.begin(), destination_v.end(), [source](const graph::Edge& edge) { return source == edge.m_destination; });
-  destination_itr.base()->m_weight          = destination_itr.base()->m_base_cost;
+  m_weights[edge]    += cost;
+  m_weights[reverse] += cost;
 }
 
 void
-Graph::update_usage(int32_t delta, uint32_t source, uint32_t destination)
+Graph::zero_cost(uint32_t source, uint32_t destination)
 {
-  std::vector<graph::Edge>& source_v   = m_adj.at(source);
-  auto                      source_itr = std::find_if(source_v.begin(), source_v.end(), [destination](const graph::Edge& edge) { return destination == edge.m_destination; });
-  source_itr.base()->m_usage += delta;
+  const auto [edge, reverse] = get_edges(source, destination);
 
-  std::vector<graph::Edge>& destination_v   = m_adj.at(destination);
-  auto                      destination_itr = std::find_if(destination_v.begin(), destination_v.end(), [source](const graph::Edge& edge) { return source == edge.m_destination; });
-  destination_itr.base()->m_usage += delta;
+  m_weights[edge]    = 0;
+  m_weights[reverse] = 0;
 }
 
 void
-Graph::remove_cost(uint32_t cost, uint32_t source, uint32_t destination)
+Graph::restore_cost(uint32_t source, uint32_t destination)
 {
-  std::vector<graph::Edge>& source_v   = m_adj.at(source);
-  auto                      source_itr = std::find_if(source_v.begin(), source_v.end(), [destination](const graph::Edge& edge) { return destination == edge.m_destination; });
-  source_itr.base()->m_weight -= cost;
+  const auto [edge, reverse] = get_edges(source, destination);
 
-  std::vector<graph::Edge>& destination_v   = m_adj.at(destination);
-  auto                      destination_itr = std::find_if(destination_v.begin(), destination_v.end(), [source](const graph::Edge& edge) { return source == edge.m_destination; });
-  destination_itr.base()->m_weight -= cost;
+  m_weights[edge]    = m_base_costs[edge];
+  m_weights[reverse] = m_base_costs[reverse];
 }
 
-std::vector<std::vector<Edge>>&
-Graph::get_adj()
+void
+Graph::remove_cost(uint32_t cost, uint32_t source, uint32_t destination)
 {
-  return m_adj;
+  const auto [edge, reverse] = get_edges(source, destination);
+
+  m_weights[edge]    -= cost;
+  m_weights[reverse] -= cost;
 }
 
-const std::vector<std::vector<Edge>>&
-Graph::get_adj() const
+/** =============================== PRIVATE METHODS ============================== */
+
+std::pair<uint32_t, uint32_t>
+Graph::get_edges(uint32_t source, uint32_t destination) const
 {
-  return m_adj;
+  const uint32_t edge = find_edge(source, destination);
+
+  if(edge == NONE)
+    {
+      throw std::out_of_range("Graph Error: There is no edge between the nodes.");
+    }
+
+  return { edge, m_reverse[edge] };
 }
 
 } // namespace graph
@@ -1,175 +1,374 @@
-#include <fstream>
-#include <iostream>
+#include <algorithm>
+#include <charconv>
+#include <stdexcept>
+#include <string_view>
+#include <unordered_map>
 #include <unordered_set>
 
-#include "Include/Guide.hpp"
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
 #include "Include/GlobalUtils.hpp"
+#include "Include/Guide.hpp"
+#include "Include/Parallel.hpp"
 
-namespace guide
+namespace guide::details
 {
 
-std::vector<Tree>
-read(const std::filesystem::path& path)
+constexpr double      GCELL_SIZE    = 6900.0;  ///> The size of a gcell in a guide.
+constexpr std::size_t MIN_PART_SIZE = 1 << 20; ///> Smaller parts aren't worth a separate task.
+constexpr std::size_t PARTS_FACTOR  = 4;       ///> Parts per thread, so uneven nets get balanced between threads.
+
+/** Read-only mapping of a whole file */
+class MappedFile
 {
-  if(!std::filesystem::exists(path) || path.extension() != ".guide")
+public:
+  explicit MappedFile(const std::filesystem::path& path)
+  {
+    const int32_t fd = open(path.c_str(), O_RDONLY);
+
+    if(fd == -1)
+      {
+        throw std::runtime_error("Guide Error: Can't open the file - \"" + path.string() + "\".");
+      }
+
+    struct stat info;
+
+    if(fstat(fd, &info) != 0)
+      {
+        close(fd);
+        throw std::runtime_error("Guide Error: Can't get the size of the file - \"" + path.string() + "\".");
+      }
+
+    m_size = static_cast<std::size_t>(info.st_size);
+
+    if(m_size != 0)
+      {
+        void* data = mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, fd, 0);
+
+        if(data == MAP_FAILED)
+          {
+            close(fd);
+            throw std::runtime_error("Guide Error: Can't map the file - \"" + path.string() + "\".");
+          }
+
+        madvise(data, m_size, MADV_SEQUENTIAL);
+        m_data = static_cast<const char*>(data);
+      }
+
+    close(fd);
+  }
+
+  ~MappedFile()
+  {
+    if(m_data != nullptr)
+      {
+        munmap(const_cast<char*>(m_data), m_size);
+      }
+  }
+
+  MappedFile(const MappedFile&) = delete;
+
+  MappedFile&
+  operator=(const MappedFile&)
+      = delete;
+
+public:
+  std::string_view
+  view() const noexcept(true)
+  {
+    return { m_data, m_size };
+  }
+
+private:
+  const char* m_data = nullptr; ///> The mapped data.
+  std::size_t m_size = 0;       ///> The size of the data.
+};
+
+struct EdgeKey
+{
+  uint32_t     m_source;
+  uint32_t     m_destination;
+  types::Metal m_metal;
+
+  bool
+  operator==(const EdgeKey& other) const noexcept(true)
+  {
+    return m_source == other.m_source && m_destination == other.m_destination && m_metal == other.m_metal;
+  }
+
+  struct Hash
+  {
+    std::size_t
+    operator()(const EdgeKey& key) const noexcept(true)
     {
-      throw std::runtime_error("Guide Error: Can't locate guide file by the path - \"" + path.string() + "\".");
+      const uint64_t nodes = (uint64_t(key.m_source) << 32) | key.m_destination;
+      return std::hash<uint64_t>{}(nodes ^ (uint64_t(key.m_metal) << 58));
     }
+  };
+};
 
-  std::ifstream in_file(path);
+/** Builds a tree without duplicates of nodes and edges, lookup tables are reused by all trees of a part */
+class TreeBuilder
+{
+public:
+  void
+  start(Tree& tree)
+  {
+    m_tree = &tree;
+    m_nodes.clear();
+    m_edges.clear();
+  }
+
+  uint32_t
+  add_node(const uint32_t x, const uint32_t y)
+  {
+    const auto [itr, is_inserted] = m_nodes.try_emplace((uint64_t(x) << 32) | y, uint32_t(m_tree->m_nodes.size()));
+
+    if(is_inserted)
+      {
+        m_tree->m_nodes.push_back(Node{ x, y });
+      }
+
+    return itr->second;
+  }
+
+  void
+  add_edge(const uint32_t source, const uint32_t destination, const types::Metal metal)
+  {
+    if(m_edges.emplace(EdgeKey{ source, destination, metal }).second)
+      {
+        m_tree->m_edges.push_back(Edge{ source, destination, metal });
+
+        ++m_tree->m_nodes[source].m_connections;
+        ++m_tree->m_nodes[destination].m_connections;
+      }
+  }
+
+private:
+  Tree*                                      m_tree = nullptr; ///> The current tree.
+  std::unordered_map<uint64_t, uint32_t>     m_nodes;          ///> Maps a position of a node to its index.
+  std::unordered_set<EdgeKey, EdgeKey::Hash> m_edges;          ///> All edges of the current tree.
+};
+
+/** Returns the line at a position without a line break and moves the position to the next line */
+std::string_view
+next_line(const std::string_view text, std::size_t& pos)
+{
+  const std::size_t end  = std::min(text.find('\n', pos), text.size());
+  std::string_view  line = text.substr(pos, end - pos);
+  pos                    = end + 1;
 
-  if(!in_file.is_open() || !in_file.good())
+  if(!line.empty() && line.back() == '\r')
     {
-      throw std::runtime_error("Guide Error: Can't open the file - \"" + path.string() + "\".");
+      line.remove_suffix(1);
     }
 
-  std::string       line;
-  std::vector<Tree> trees;
+  return line;
+}
 
-  Tree*             current_tree = nullptr;
+/** Returns the position of the first net that starts after a position */
+std::size_t
+find_net_start(const std::string_view text, const std::size_t pos)
+{
+  std::size_t line_pos = text.find('\n', pos);
 
-  while(std::getline(in_file, line))
+  if(line_pos == std::string_view::npos)
     {
-      if(trees.empty())
-        {
-          current_tree = &trees.emplace_back(line);
-          continue;
-        }
+      return text.size();
+    }
 
-      if(line == "(")
+  for(++line_pos; line_pos < text.size();)
+    {
+      if(next_line(text, line_pos) == ")")
         {
-          continue;
+          return std::min(line_pos, text.size());
         }
+    }
 
-      if(line == ")" && std::getline(in_file, line))
-        {
-          current_tree = &trees.emplace_back(line);
-          continue;
-        }
+  return text.size();
+}
 
-      if(line.empty())
-        {
-          break;
-        }
+double
+read_number(const std::string_view line, std::size_t& pos)
+{
+  while(pos < line.size() && line[pos] == ' ')
+    {
+      ++pos;
+    }
 
-      std::size_t  pos          = 0;
-      std::size_t  next_pos     = line.find(' ');
-      const double x1           = std::stod(line.substr(pos, next_pos - pos));
+  double     value;
+  const auto [end, error] = std::from_chars(line.data() + pos, line.data() + line.size(), value);
 
-      pos                       = next_pos + 1;
-      next_pos                  = line.find(' ', pos);
-      const double y1           = std::stod(line.substr(pos, next_pos - pos));
+  if(error != std::errc())
+    {
+      throw std::runtime_error("Guide Error: Wrong format of the line - \"" + std::string(line) + "\".");
+    }
 
-      pos                       = next_pos + 1;
-      next_pos                  = line.find(' ', pos);
-      const double x2           = std::stod(line.substr(pos, next_pos - pos));
+  pos = end - line.data();
 
-      pos                       = next_pos + 1;
-      next_pos                  = line.find(' ', pos);
-      const double       y2     = std::stod(line.substr(pos, next_pos - pos));
+  return value;
+}
 
-      const std::size_t  left   = std::min(x1, x2) / 6900;
-      const std::size_t  top    = std::min(y1, y2) / 6900;
-      const std::size_t  right  = std::max(x1, x2) / 6900;
-      const std::size_t  bottom = std::max(y1, y2) / 6900;
-      const types::Metal metal  = utils::get_skywater130_metal(line.substr(next_pos + 1));
+void
+add_segment(const std::string_view line, TreeBuilder& builder)
+{
+  std::size_t    pos    = 0;
+  const double   x1     = read_number(line, pos);
+  const double   y1     = read_number(line, pos);
+  const double   x2     = read_number(line, pos);
+  const double   y2     = read_number(line, pos);
+
+  const uint32_t left   = static_cast<uint32_t>(std::min(x1, x2) / GCELL_SIZE);
+  const uint32_t top    = static_cast<uint32_t>(std::min(y1, y2) / GCELL_SIZE);
+  const uint32_t right  = static_cast<uint32_t>(std::max(x1, x2) / GCELL_SIZE);
+  const uint32_t bottom = static_cast<uint32_t>(std::max(y1, y2) / GCELL_SIZE);
+
+  const std::size_t      name_begin = line.find_first_not_of(' ', pos);
+  const std::size_t      name_end   = line.find_last_not_of(' ');
+  const std::string_view name       = name_begin == std::string_view::npos ? std::string_view() : line.substr(name_begin, name_end - name_begin + 1);
+  const types::Metal     metal      = utils::get_skywater130_metal(name);
+
+  if(bottom - top == 1 && right - left == 1)
+    {
+      builder.add_node(left, top);
+    }
 
-      if(bottom - top == 1 && right - left == 1)
+  if(bottom - top > 1)
+    {
+      uint32_t prev_node = builder.add_node(left, top);
+
+      for(uint32_t y = top + 1; y < bottom; ++y)
         {
-          Node* new_node = new Node(left, top);
-
-          if(current_tree->m_nodes.count(new_node) == 0)
-            {
-              current_tree->m_nodes.emplace(new_node);
-            }
-          else
-            {
-              delete new_node;
-            }
+          const uint32_t new_node = builder.add_node(left, y);
+          builder.add_edge(prev_node, new_node, metal);
+          prev_node = new_node;
         }
+    }
+
+  if(right - left > 1)
+    {
+      uint32_t prev_node = builder.add_node(left, top);
 
-      if(bottom - top > 1)
+      for(uint32_t x = left + 1; x < right; ++x)
         {
-          Node* prev_node = nullptr;
-
-          for(std::size_t y = top; y < bottom; ++y)
-            {
-              Node* new_node = new Node(left, y);
-
-              if(current_tree->m_nodes.count(new_node) == 0)
-                {
-                  current_tree->m_nodes.emplace(new_node);
-                }
-              else
-                {
-                  Node* tmp = *current_tree->m_nodes.find(new_node);
-                  delete new_node;
-                  new_node = tmp;
-                }
-
-              if(prev_node != nullptr)
-                {
-                  auto [_, is_inserted] = current_tree->m_edges.emplace(prev_node, new_node, metal);
-
-                  if(is_inserted)
-                    {
-                      ++prev_node->m_connections;
-                      ++new_node->m_connections;
-                    }
-                }
-
-              prev_node = new_node;
-            }
+          const uint32_t new_node = builder.add_node(x, top);
+          builder.add_edge(prev_node, new_node, metal);
+          prev_node = new_node;
         }
+    }
+}
+
+/** Parses nets within [begin, end) of a text */
+std::vector<Tree>
+parse_part(const std::string_view text, const std::size_t begin, const std::size_t end)
+{
+  enum class State
+  {
+    NAME = 0,
+    OPEN,
+    SEGMENTS
+  } state = State::NAME;
+
+  std::vector<Tree> trees;
+  TreeBuilder       builder;
+
+  for(std::size_t pos = begin; pos < end;)
+    {
+      const std::string_view line = next_line(text, pos);
 
-      if(right - left > 1)
+      switch(state)
         {
-          Node* prev_node = nullptr;
-
-          for(std::size_t x = left; x < right; ++x)
-            {
-              Node* new_node = new Node(x, top);
-
-              if(current_tree->m_nodes.count(new_node) == 0)
-                {
-                  current_tree->m_nodes.emplace(new_node);
-                }
-              else
-                {
-                  Node* tmp = *current_tree->m_nodes.find(new_node);
-                  delete new_node;
-                  new_node = tmp;
-                }
-
-              if(prev_node != nullptr)
-                {
-                  auto [_, is_inserted] = current_tree->m_edges.emplace(prev_node, new_node, metal);
-
-                  if(is_inserted)
-                    {
-                      ++prev_node->m_connections;
-                      ++new_node->m_connections;
-                    }
-                }
-
-              prev_node = new_node;
-            }
+        case State::NAME:
+          {
+            if(!line.empty())
+              {
+                trees.emplace_back().m_name = line;
+                builder.start(trees.back());
+                state = State::OPEN;
+              }
+
+            break;
+          }
+        case State::OPEN:
+          {
+            if(line != "(")
+              {
+                throw std::runtime_error("Guide Error: Expected \"(\" after the net - \"" + trees.back().m_name + "\".");
+              }
+
+            state = State::SEGMENTS;
+            break;
+          }
+        case State::SEGMENTS:
+          {
+            if(line == ")")
+              {
+                state = State::NAME;
+              }
+            else if(!line.empty())
+              {
+                add_segment(line, builder);
+              }
+
+            break;
+          }
         }
     }
 
   return trees;
 }
 
-void
-cleanup(const std::vector<Tree>& trees)
+} // namespace guide::details
+
+namespace guide
 {
-  for(auto tree : trees)
+
+std::vector<Tree>
+read(const std::filesystem::path& path, const std::size_t threads)
+{
+  if(!std::filesystem::exists(path) || path.extension() != ".guide")
     {
-      for(auto node : tree.m_nodes)
-        {
-          delete node;
-        }
+      throw std::runtime_error("Guide Error: Can't locate guide file by the path - \"" + path.string() + "\".");
+    }
+
+  const details::MappedFile file(path);
+  const std::string_view    text = file.view();
+
+  /** Nets don't depend on each other, so the file is split at net boundaries and parts are parsed in parallel */
+  const std::size_t         parts_count = std::clamp<std::size_t>(text.size() / details::MIN_PART_SIZE, 1, parallel::resolve_threads(threads) * details::PARTS_FACTOR);
+  std::vector<std::size_t>  bounds(parts_count + 1, text.size());
+  bounds[0]                             = 0;
+
+  for(std::size_t i = 1; i < parts_count; ++i)
+    {
+      bounds[i] = std::max(bounds[i - 1], details::find_net_start(text, text.size() / parts_count * i));
     }
+
+  std::vector<std::vector<Tree>> parts(parts_count);
+
+  parallel::for_each_task(parts_count, threads, [&](const std::size_t part, const std::size_t) {
+    parts[part] = details::parse_part(text, bounds[part], bounds[part + 1]);
+  });
+
+  std::vector<Tree> trees;
+  std::size_t       total = 0;
+
+  for(const auto& part : parts)
+    {
+      total += part.size();
+    }
+
+  trees.reserve(total);
+
+  for(auto& part : parts)
+    {
+      std::move(part.begin(), part.end(), std::back_inserter(trees));
+    }
+
+  return trees;
 }
 
 } // namespace guide
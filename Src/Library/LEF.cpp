@@ -1,10 +1,17 @@
+#include <algorithm>
 #include <cstdio>
+#include <fstream>
 #include <iostream>
+#include <sstream>
 #include <string_view>
+#include <type_traits>
 #include <vector>
 
-#include "Include/LEF.hpp"
+#include <unistd.h>
+
 #include "Include/GlobalUtils.hpp"
+#include "Include/LEF.hpp"
+#include "Include/Serialize.hpp"
 
 #define DEFINE_LEF_CALLBACK(callback_type, callback_name)                   \
   {                                                                         \
@@ -36,6 +43,81 @@
     return 0;                                                               \
   }
 
+namespace lef::details
+{
+
+void
+write_data(serialize::Writer& writer, const Data& data)
+{
+  writer.write(data.m_database_number);
+  writer.write<uint64_t>(data.m_layers.size());
+
+  for(const auto& [metal, layer] : data.m_layers)
+    {
+      writer.write(metal);
+      writer.write(layer);
+    }
+
+  writer.write<uint64_t>(data.m_macros.size());
+
+  for(const auto& [name, macro] : data.m_macros)
+    {
+      writer.write(name);
+      writer.write(macro.m_width);
+      writer.write(macro.m_height);
+      serialize::write_polygons(writer, macro.m_obs);
+      writer.write<uint64_t>(macro.m_pins.size());
+
+      for(const auto& [pin_name, pin] : macro.m_pins)
+        {
+          writer.write(pin_name);
+          writer.write(pin.m_is_placed);
+          writer.write(pin.m_name);
+          writer.write(pin.m_use);
+          writer.write(pin.m_direction);
+          writer.write(pin.m_center.x);
+          writer.write(pin.m_center.y);
+          serialize::write_polygons(writer, pin.m_ports);
+          serialize::write_polygons(writer, pin.m_obs);
+        }
+    }
+}
+
+void
+read_data(serialize::Reader& reader, Data& data)
+{
+  reader.read(data.m_database_number);
+
+  for(std::size_t i = 0, end = reader.read<uint64_t>(); i < end; ++i)
+    {
+      const auto metal = reader.read<types::Metal>();
+      reader.read(data.m_layers[metal]);
+    }
+
+  for(std::size_t i = 0, end = reader.read<uint64_t>(); i < end; ++i)
+    {
+      Macro& macro = data.m_macros[reader.read<std::string>()];
+      reader.read(macro.m_width);
+      reader.read(macro.m_height);
+      serialize::read_polygons(reader, macro.m_obs);
+
+      for(std::size_t j = 0, end_j = reader.read<uint64_t>(); j < end_j; ++j)
+        {
+          pin::Pin& pin = macro.m_pins[reader.read<std::string>()];
+          reader.read(pin.m_is_placed);
+          reader.read(pin.m_name);
+          reader.read(pin.m_use);
+          reader.read(pin.m_direction);
+          reader.read(pin.m_center.x);
+          reader.read(pin.m_center.y);
+          serialize::read_polygons(reader, pin.m_ports);
+          serialize::read_polygons(reader, pin.m_obs);
+        }
+    }
+}
+
+} // namespace lef::details
+
 namespace lef
 {
 
@@ -66,41 +148,35 @@ LEF::~LEF()
 /** =============================== PUBLIC METHODS ==================================== */
 
 Data
-LEF::parse(const std::filesystem::path& dir_path) const
+LEF::parse(const std::filesystem::path& dir_path, const std::filesystem::path& cache_folder) const
 {
-  if(!std::filesystem::exists(dir_path))
-    {
-      throw std::invalid_argument("Can't find directory with pdk by path - \"" + dir_path.string() + "\".");
-    }
+  const std::vector<std::filesystem::path> files = find_files(dir_path);
 
-  std::vector<std::filesystem::path> lef_files;
-  std::vector<std::filesystem::path> tech_lef_files;
+  std::filesystem::path cache_path;
+  uint64_t              key = 0;
 
-  for(auto& itr : std::filesystem::recursive_directory_iterator(dir_path))
+  if(!cache_folder.empty())
     {
-      if(itr.is_regular_file())
+      key = serialize::fnv1a(&details::CACHE_VERSION, sizeof(details::CACHE_VERSION));
+
+      for(const auto& path : files)
         {
-          const std::filesystem::path file_path      = itr.path();
-          const std::string_view      file_path_view = file_path.c_str();
-          const std::size_t           extension_pos  = file_path_view.find_first_of('.');
+          key = serialize::hash_file(path, key);
+        }
 
-          if(extension_pos != std::string::npos)
-            {
-              const std::string_view extension = file_path_view.substr(extension_pos);
+      std::ostringstream name;
+      name << "lef_" << std::hex << key << ".cache";
+      cache_path = cache_folder / name.str();
 
-              if(extension == ".lef")
-                {
-                  lef_files.emplace_back(std::move(file_path));
-                }
-              else if(extension == ".tlef")
-                {
-                  tech_lef_files.emplace_back(std::move(file_path));
-                }
-            }
+      Data data;
+
+      if(load_cache(cache_path, key, data))
+        {
+          return data;
         }
     }
 
-  for(const auto& path : tech_lef_files)
+  for(const auto& path : files)
     {
       FILE* file = fopen(path.c_str(), "r");
 
@@ -119,27 +195,66 @@ LEF::parse(const std::filesystem::path& dir_path) const
         }
     }
 
-  for(const auto& path : lef_files)
+  if(!cache_path.empty())
     {
-      FILE* file = fopen(path.c_str(), "r");
-
-      if(file == nullptr)
+      try
         {
-          throw std::runtime_error("Lef Error: Can't open the file = \"" + path.string() + "\"");
+          store_cache(cache_path, key, m_data);
+        }
+      catch(const std::exception& e)
+        {
+          /** A read-only cache folder only costs the parsing time of the next run */
+          std::cout << "LEF Warning: " << e.what() << std::endl;
         }
+    }
 
-      int32_t status = lefrRead(file, path.c_str(), (void*)this);
+  return m_data;
+};
 
-      fclose(file);
+std::vector<std::filesystem::path>
+LEF::find_files(const std::filesystem::path& dir_path)
+{
+  if(!std::filesystem::exists(dir_path))
+    {
+      throw std::invalid_argument("Can't find directory with pdk by path - \"" + dir_path.string() + "\".");
+    }
 
-      if(status != 0)
+  std::vector<std::filesystem::path> lef_files;
+  std::vector<std::filesystem::path> tech_lef_files;
+
+  for(auto& itr : std::filesystem::recursive_directory_iterator(dir_path))
+    {
+      if(itr.is_regular_file())
         {
-          std::cout << "LEF Error: Unable to parse the file - \"" + path.string() + "\"" << std::endl;
+          const std::filesystem::path file_path      = itr.path();
+          const std::string_view      file_path_view = file_path.c_str();
+          const std::size_t           extension_pos  = file_path_view.find_first_of('.');
+
+          if(extension_pos != std::string::npos)
+            {
+              const std::string_view extension = file_path_view.substr(extension_pos);
+
+              if(extension == ".lef")
+                {
+                  lef_files.emplace_back(std::move(file_path));
+                }
+              else if(extension == ".tlef")
+                {
+                  tech_lef_files.emplace_back(std::move(file_path));
+                }
+            }
         }
     }
 
-  return m_data;
-};
+  /** The order of a directory iteration is unspecified, sorted files make the parsing and the cache key stable */
+  std::sort(lef_files.begin(), lef_files.end());
+  std::sort(tech_lef_files.begin(), tech_lef_files.end());
+
+  /** Technology files go first, they define layers used by cells */
+  std::move(lef_files.begin(), lef_files.end(), std::back_inserter(tech_lef_files));
+
+  return tech_lef_files;
+}
 
 /** =============================== PRIVATE METHODS =================================== */
 
@@ -260,6 +375,7 @@ LEF::pin_callback(lefiPin* param, Data& data)
 
   std::unordered_map<types::Metal, std::vector<geom::Polygon>> polygons;
   types::Metal                                                 top_metal = types::Metal::NONE;
+  const double                                                 dbu       = data.m_database_number;
 
   for(std::size_t i = 0, end = param->numPorts(); i < end; ++i)
     {
@@ -289,25 +405,7 @@ LEF::pin_callback(lefiPin* param, Data& data)
                   }
 
                 const lefiGeomRect* rect = geometries->getRect(j);
-                geom::Polygon       target({ rect->xl, rect->yl, rect->xh, rect->yh }, metal);
-
-                // TODO Find a way to optimize this part
-                auto                remove_itr = std::remove_if(polygons[metal].begin(), polygons[metal].end(), [&target](const auto& polygon) {
-                  if(!(target / polygon))
-                    {
-                      return false;
-                    }
-
-                  target += polygon;
-                  return true;
-                });
-
-                if(remove_itr != polygons[metal].end())
-                  {
-                    polygons[metal].erase(remove_itr, polygons[metal].end());
-                  }
-
-                polygons[metal].emplace_back(std::move(target));
+                polygons[metal].emplace_back(geom::Polygon({ rect->xl * dbu, rect->yl * dbu, rect->xh * dbu, rect->yh * dbu }, metal));
                 break;
               }
             default: break;
@@ -315,6 +413,12 @@ LEF::pin_callback(lefiPin* param, Data& data)
         }
     }
 
+  /** Rectangles of all ports are merged per layer at once */
+  for(auto& [metal, v_polygons] : polygons)
+    {
+      geom::merge_overlapping(v_polygons);
+    }
+
   if(polygons.size() == 0)
     {
       return;
@@ -343,6 +447,7 @@ LEF::obstruction_callback(lefiObstruction* param, Data& data)
 {
   lefiGeometries* geometries = param->geometries();
   geom::Polygon   polygon;
+  const double    dbu        = data.m_database_number;
 
   for(std::size_t i = 0, end = geometries->numItems(); i < end; ++i)
     {
@@ -367,7 +472,7 @@ LEF::obstruction_callback(lefiObstruction* param, Data& data)
         case lefiGeomEnum::lefiGeomRectE:
           {
             lefiGeomRect* rect = geometries->getRect(i);
-            polygon += geom::Polygon({ rect->xl, rect->yl, rect->xh, rect->yh }, polygon.m_metal);
+            polygon += geom::Polygon({ rect->xl * dbu, rect->yl * dbu, rect->xh * dbu, rect->yh * dbu }, polygon.m_metal);
             break;
           }
         case lefiGeomEnum::lefiGeomPolygonE:
@@ -382,6 +487,86 @@ LEF::obstruction_callback(lefiObstruction* param, Data& data)
 
 /** =============================== PRIVATE STATIC METHODS =================================== */
 
+bool
+LEF::load_cache(const std::filesystem::path& cache_path, const uint64_t key, Data& data)
+{
+  std::ifstream file(cache_path, std::ios::binary | std::ios::ate);
+
+  if(!file.is_open())
+    {
+      return false;
+    }
+
+  std::string content(static_cast<std::size_t>(file.tellg()), '\0');
+  file.seekg(0);
+  file.read(content.data(), content.size());
+
+  if(!file.good())
+    {
+      return false;
+    }
+
+  try
+    {
+      serialize::Reader reader(content.data(), content.size());
+
+      if(reader.read<uint32_t>() != details::CACHE_VERSION || reader.read<uint64_t>() != key)
+        {
+          return false;
+        }
+
+      details::read_data(reader, data);
+
+      if(reader.is_end())
+        {
+          return true;
+        }
+    }
+  catch(const std::exception& e)
+    {
+      std::cout << "LEF Warning: Invalid cache - \"" << cache_path.string() << "\". " << e.what() << std::endl;
+    }
+
+  data = Data();
+
+  return false;
+}
+
+void
+LEF::store_cache(const std::filesystem::path& cache_path, const uint64_t key, const Data& data)
+{
+  serialize::Writer writer;
+  writer.write(details::CACHE_VERSION);
+  writer.write(key);
+  details::write_data(writer, data);
+
+  std::filesystem::create_directories(cache_path.parent_path());
+
+  const std::filesystem::path temp_path = cache_path.string() + "." + std::to_string(getpid()) + ".tmp";
+
+  {
+    std::ofstream file(temp_path, std::ios::binary);
+    file.write(writer.buffer().data(), writer.buffer().size());
+
+    if(!file.good())
+      {
+        file.close();
+        std::filesystem::remove(temp_path);
+
+        throw std::runtime_error("Unable to write the cache - \"" + cache_path.string() + "\".");
+      }
+  }
+
+  std::error_code error;
+  std::filesystem::rename(temp_path, cache_path, error);
+
+  if(error)
+    {
+      std::filesystem::remove(temp_path, error);
+      throw std::runtime_error("Unable to replace the cache - \"" + cache_path.string() + "\".");
+    }
+}
+
 void
 LEF::error_callback(const char* msg)
 {
@@ -1,10 +1,17 @@
+#include <cstring>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <new>
+
 #include "Include/Matrix.hpp"
 
 namespace matrix
 {
 /** =============================== CONSTRUCTORS ================================= */
 
-Matrix::Matrix(const Shape& shape)
+template <typename Tp>
+Matrix<Tp>::Matrix(const Shape& shape)
     : m_shape(shape), m_data(nullptr)
 {
   if(m_shape.m_x == 0 || m_shape.m_y == 0 || m_shape.m_z == 0)
@@ -14,29 +21,29 @@ Matrix::Matrix(const Shape& shape)
 
   const std::size_t length = allocate();
 
-  for(std::size_t i = 0; i < length; ++i)
-    {
-      m_data[i] = 0;
-    }
+  std::memset(m_data, 0, length * sizeof(Tp));
 };
 
-Matrix::~Matrix()
+template <typename Tp>
+Matrix<Tp>::~Matrix()
 {
-  delete[] m_data;
+  release();
 }
 
-Matrix::Matrix(const Matrix& matrix)
+template <typename Tp>
+Matrix<Tp>::Matrix(const Matrix& matrix)
     : m_shape(matrix.m_shape), m_data(nullptr)
 {
   const std::size_t length = allocate();
 
-  for(std::size_t i = 0; i < length; ++i)
+  if(length != 0)
     {
-      m_data[i] = matrix.m_data[i];
+      std::memcpy(m_data, matrix.m_data, length * sizeof(Tp));
     }
 }
 
-Matrix::Matrix(Matrix&& matrix)
+template <typename Tp>
+Matrix<Tp>::Matrix(Matrix&& matrix) noexcept(true)
     : m_shape(matrix.m_shape), m_data(matrix.m_data)
 {
   matrix.m_data  = nullptr;
@@ -45,26 +52,40 @@ Matrix::Matrix(Matrix&& matrix)
 
 /** =============================== OPERATORS ==================================== */
 
-Matrix&
-Matrix::operator=(const Matrix& matrix)
+template <typename Tp>
+Matrix<Tp>&
+Matrix<Tp>::operator=(const Matrix& matrix)
 {
+  if(this == &matrix)
+    {
+      return *this;
+    }
+
   clear();
 
   m_shape                  = matrix.m_shape;
 
   const std::size_t length = allocate();
 
-  for(std::size_t i = 0; i < length; ++i)
+  if(length != 0)
     {
-      m_data[i] = matrix.m_data[i];
+      std::memcpy(m_data, matrix.m_data, length * sizeof(Tp));
     }
 
   return *this;
 }
 
-Matrix&
-Matrix::operator=(Matrix&& matrix)
+template <typename Tp>
+Matrix<Tp>&
+Matrix<Tp>::operator=(Matrix&& matrix) noexcept(true)
 {
+  if(this == &matrix)
+    {
+      return *this;
+    }
+
+  release();
+
   m_shape        = matrix.m_shape;
   m_data         = matrix.m_data;
   matrix.m_data  = nullptr;
@@ -73,19 +94,22 @@ Matrix::operator=(Matrix&& matrix)
   return *this;
 }
 
-Matrix&
-Matrix::operator+=(const Matrix& matrix)
+template <typename Tp>
+Matrix<Tp>&
+Matrix<Tp>::operator+=(const Matrix& matrix)
 {
   if(m_shape != matrix.m_shape)
     {
       throw std::runtime_error("Matrix Error: Invalid shape of the left hand value.");
     }
 
-  const std::size_t length = m_shape.m_z * m_shape.m_y * m_shape.m_x;
+  Tp*               lhs    = std::assume_aligned<ALIGNMENT>(m_data);
+  const Tp*         rhs    = std::assume_aligned<ALIGNMENT>(matrix.m_data);
+  const std::size_t length = size();
 
   for(std::size_t i = 0; i < length; ++i)
     {
-      m_data[i] += matrix.m_data[i];
+      lhs[i] += rhs[i];
     }
 
   return *this;
@@ -93,90 +117,214 @@ Matrix::operator+=(const Matrix& matrix)
 
 /** =============================== PUBLIC STATIC METHODS =============================== */
 
+template <typename Tp>
 void
-Matrix::mask(Matrix& matrix, const Matrix& mask)
+Matrix<Tp>::mask(Matrix& matrix, const Matrix& mask)
 {
   if(matrix.m_shape != mask.m_shape)
     {
       throw std::runtime_error("Matrix Error: Invalid shape of the mask.");
     }
 
-  const std::size_t length = matrix.m_shape.m_z * matrix.m_shape.m_y * matrix.m_shape.m_x;
+  Tp*               values = std::assume_aligned<ALIGNMENT>(matrix.m_data);
+  const Tp*         masks  = std::assume_aligned<ALIGNMENT>(mask.m_data);
+  const std::size_t length = matrix.size();
 
+  /** A select instead of a branch, so the loop is vectorized */
   for(std::size_t i = 0; i < length; ++i)
     {
-      if(mask.m_data[i] != 0)
-        {
-          matrix.m_data[i] = 0;
-        }
+      values[i] = masks[i] != 0 ? Tp(0) : values[i];
     }
 }
 
 /** =============================== PUBLIC METHODS =============================== */
 
-double*
-Matrix::data()
+template <typename Tp>
+Tp*
+Matrix<Tp>::data()
 {
   return m_data;
 }
 
-const double*
-Matrix::data() const
+template <typename Tp>
+const Tp*
+Matrix<Tp>::data() const
 {
   return m_data;
 }
 
+template <typename Tp>
 const Shape&
-Matrix::shape() const
+Matrix<Tp>::shape() const
 {
   return m_shape;
 }
 
-const double&
-Matrix::get_at(const uint32_t x, const uint32_t y, const uint32_t z) const
+template <typename Tp>
+const Tp&
+Matrix<Tp>::get_at(const uint32_t x, const uint32_t y, const uint32_t z) const
 {
   if(x >= m_shape.m_x || y >= m_shape.m_y || z >= m_shape.m_z)
     {
       throw std::out_of_range("Out of range");
     }
 
-  const std::size_t index = y * (m_shape.m_x * m_shape.m_z) + x * m_shape.m_z + z;
-  return m_data[index];
+  return m_data[index(x, y, z)];
 }
 
+template <typename Tp>
 void
-Matrix::set_at(const double value, const uint32_t x, const uint32_t y, const uint32_t z)
+Matrix<Tp>::set_at(const Tp value, const uint32_t x, const uint32_t y, const uint32_t z)
 {
   if(x >= m_shape.m_x || y >= m_shape.m_y || z >= m_shape.m_z)
     {
       throw std::out_of_range("Out of range");
     }
 
-  const std::size_t index = y * (m_shape.m_x * m_shape.m_z) + x * m_shape.m_z + z;
-  m_data[index]           = value;
+  m_data[index(x, y, z)] = value;
+}
+
+template <typename Tp>
+void
+Matrix<Tp>::fill(const Tp value) noexcept(true)
+{
+  Tp*               values = std::assume_aligned<ALIGNMENT>(m_data);
+  const std::size_t length = size();
+
+  for(std::size_t i = 0; i < length; ++i)
+    {
+      values[i] = value;
+    }
+}
+
+template <typename Tp>
+std::pair<Tp, Tp>
+Matrix<Tp>::min_max(const Tp ignored) const noexcept(true)
+{
+  const Tp*         values  = std::assume_aligned<ALIGNMENT>(m_data);
+  const std::size_t length  = size();
+
+  constexpr Tp      HIGHEST = std::numeric_limits<Tp>::max();
+  constexpr Tp      LOWEST  = std::numeric_limits<Tp>::lowest();
+
+  Tp                min     = HIGHEST;
+  Tp                max     = LOWEST;
+
+  /** Ignored elements are replaced by the neutral values of reductions, so there are no branches in the loop */
+  for(std::size_t i = 0; i < length; ++i)
+    {
+      const Tp value   = values[i];
+      const Tp for_min = value != ignored ? value : HIGHEST;
+      const Tp for_max = value != ignored ? value : LOWEST;
+
+      min              = for_min < min ? for_min : min;
+      max              = for_max > max ? for_max : max;
+    }
+
+  return { min, max };
 }
 
+template <typename Tp>
 void
-Matrix::clear() noexcept(true)
+Matrix<Tp>::normalize_inverse(const Tp min, const Tp max, const Tp scale, const Tp ignored) noexcept(true)
+{
+  Tp*               values   = std::assume_aligned<ALIGNMENT>(m_data);
+  const std::size_t length   = size();
+
+  const bool        is_empty = !(max > min);
+  const Tp          range    = max - min;
+
+  /** Both results are computed and one is selected, so the loop is vectorized */
+  for(std::size_t i = 0; i < length; ++i)
+    {
+      const Tp value      = values[i];
+      const Tp normalized = is_empty ? scale : Tp(scale * (Tp(1) - (value - min) / range));
+
+      values[i]           = value == ignored ? Tp(0) : normalized;
+    }
+}
+
+template <typename Tp>
+void
+Matrix<Tp>::clear() noexcept(true)
 {
   m_shape = Shape{ 0, 0, 0 };
-  delete[] m_data;
+  release();
 }
 
 /** =============================== PRIVATE METHODS ============================== */
 
+template <typename Tp>
 std::size_t
-Matrix::allocate()
+Matrix<Tp>::allocate()
 {
-  const std::size_t length = m_shape.m_z * m_shape.m_y * m_shape.m_x;
-  m_data                   = new double[length];
+  const std::size_t length = size();
+
+  /** The size is rounded up to the alignment, so vectorized loops may safely read a whole last vector */
+  const std::size_t bytes  = (length * sizeof(Tp) + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT;
+  m_data                   = length == 0 ? nullptr : static_cast<Tp*>(::operator new[](bytes, std::align_val_t(ALIGNMENT)));
+
+  return length;
+}
 
-  if(m_data == nullptr)
+template <typename Tp>
+void
+Matrix<Tp>::release() noexcept(true)
+{
+  if(m_data != nullptr)
     {
-      throw std::runtime_error("Failed to allocate " + std::to_string(length) + " bytes");
+      ::operator delete[](m_data, std::align_val_t(ALIGNMENT));
+      m_data = nullptr;
     }
+}
 
-  return length;
+/** =============================== POOL ========================================= */
+
+template <typename Tp>
+Matrix<Tp>
+Pool<Tp>::acquire(const Shape& shape)
+{
+  for(auto itr = m_free.rbegin(); itr != m_free.rend(); ++itr)
+    {
+      if(itr->m_shape == shape)
+        {
+          Matrix<Tp> matrix = std::move(*itr);
+          m_free.erase(std::next(itr).base());
+
+          matrix.fill(Tp(0));
+
+          return matrix;
+        }
+    }
+
+  return Matrix<Tp>(shape);
+}
+
+template <typename Tp>
+void
+Pool<Tp>::release(Matrix<Tp>&& matrix)
+{
+  if(matrix.size() == 0)
+    {
+      return;
+    }
+
+  if(m_free.size() == MAX_SIZE)
+    {
+      m_free.erase(m_free.begin());
+    }
+
+  m_free.push_back(std::move(matrix));
 }
 
+/** =============================== INSTANTIATIONS =============================== */
+
+template class Matrix<double>;
+template class Matrix<float>;
+template class Matrix<uint8_t>;
+template class Matrix<uint16_t>;
+
+template class Pool<double>;
+template class Pool<uint8_t>;
+
 } // namespace matrix
@@ -0,0 +1,209 @@
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <thread>
+#include <vector>
+
+#include "Include/Parallel.hpp"
+
+namespace parallel::details
+{
+
+void
+TaskDeque::push_back(const std::size_t task)
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  m_tasks.push_back(task);
+}
+
+bool
+TaskDeque::pop_front(std::size_t& task)
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+
+  if(m_tasks.empty())
+    {
+      return false;
+    }
+
+  task = m_tasks.front();
+  m_tasks.pop_front();
+
+  return true;
+}
+
+bool
+TaskDeque::steal_back(std::size_t& task)
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+
+  if(m_tasks.empty())
+    {
+      return false;
+    }
+
+  task = m_tasks.back();
+  m_tasks.pop_back();
+
+  return true;
+}
+
+} // namespace parallel::details
+
+namespace parallel
+{
+
+std::size_t
+resolve_threads(const std::size_t requested) noexcept(true)
+{
+  if(requested != 0)
+    {
+      return requested;
+    }
+
+  return std::max<std::size_t>(1, std::thread::hardware_concurrency());
+}
+
+std::size_t
+ThreadBudget::acquire(const std::size_t requested) noexcept(true)
+{
+  std::size_t available = m_available.load();
+  std::size_t taken     = std::min(available, requested);
+
+  while(taken != 0 && !m_available.compare_exchange_weak(available, available - taken))
+    {
+      taken = std::min(available, requested);
+    }
+
+  return taken;
+}
+
+void
+ThreadBudget::release(const std::size_t count) noexcept(true)
+{
+  m_available.fetch_add(count);
+}
+
+void
+for_each_task(const std::size_t count, const std::size_t threads, const std::function<void(std::size_t, std::size_t)>& task, ThreadBudget* budget)
+{
+  const std::size_t requested = resolve_threads(threads);
+  const std::size_t workers   = std::min(requested, count);
+
+  if(budget != nullptr && requested > std::max<std::size_t>(workers, 1))
+    {
+      budget->release(requested - std::max<std::size_t>(workers, 1));
+    }
+
+  if(workers <= 1)
+    {
+      for(std::size_t i = 0; i < count; ++i)
+        {
+          task(i, 0);
+        }
+
+      if(budget != nullptr)
+        {
+          budget->release(1);
+        }
+
+      return;
+    }
+
+  std::vector<details::TaskDeque> deques(workers);
+
+  for(std::size_t w = 0; w < workers; ++w)
+    {
+      for(std::size_t i = count * w / workers, end = count * (w + 1) / workers; i < end; ++i)
+        {
+          deques[w].push_back(i);
+        }
+    }
+
+  std::atomic<bool>  is_failed = false;
+  std::exception_ptr error;
+  std::mutex         error_mutex;
+
+  const auto         work_loop = [&](const std::size_t worker) {
+    std::size_t current;
+
+    while(!is_failed.load(std::memory_order_relaxed))
+      {
+        if(!deques[worker].pop_front(current))
+          {
+            bool is_stolen = false;
+
+            /** Tasks are never added after the start, so if every deque is empty there is nothing left to do */
+            for(std::size_t i = 1; i < workers && !is_stolen; ++i)
+              {
+                is_stolen = deques[(worker + i) % workers].steal_back(current);
+              }
+
+            if(!is_stolen)
+              {
+                break;
+              }
+          }
+
+        try
+          {
+            task(current, worker);
+          }
+        catch(...)
+          {
+            std::lock_guard<std::mutex> lock(error_mutex);
+
+            if(!error)
+              {
+                error = std::current_exception();
+              }
+
+            is_failed = true;
+          }
+      }
+
+    /** The thread of a worker stays idle until the pool is joined */
+    if(budget != nullptr)
+      {
+        budget->release(1);
+      }
+  };
+
+  std::vector<std::thread> pool;
+  pool.reserve(workers - 1);
+
+  for(std::size_t w = 1; w < workers; ++w)
+    {
+      pool.emplace_back(work_loop, w);
+    }
+
+  work_loop(0);
+
+  for(auto& thread : pool)
+    {
+      thread.join();
+    }
+
+  if(error)
+    {
+      std::rethrow_exception(error);
+    }
+}
+
+std::size_t
+shards_count(const std::size_t count, const std::size_t threads) noexcept(true)
+{
+  return std::min(resolve_threads(threads), count);
+}
+
+void
+for_each_shard(const std::size_t count, const std::size_t threads, const std::function<void(std::size_t, std::size_t, std::size_t)>& shard)
+{
+  const std::size_t shards = shards_count(count, threads);
+
+  for_each_task(shards, threads, [&](const std::size_t idx, const std::size_t) {
+    shard(count * idx / shards, count * (idx + 1) / shards, idx);
+  });
+}
+
+} // namespace parallel
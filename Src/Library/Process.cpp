@@ -1,17 +1,27 @@
 #include <algorithm>
+#include <atomic>
 #include <cmath>
+#include <future>
 #include <iostream>
+#include <iterator>
+#include <mutex>
+#include <numeric>
 #include <queue>
 #include <set>
+#include <sstream>
 #include <stack>
+#include <stop_token>
 #include <unordered_set>
 
 #include <clipper2/clipper.h>
 
 #include "Include/Algorithms.hpp"
+#include "Include/CostMap.hpp"
 #include "Include/GlobalUtils.hpp"
 #include "Include/Numpy.hpp"
+#include "Include/Parallel.hpp"
 #include "Include/Process.hpp"
+#include "Include/Snapshot.hpp"
 
 namespace process::details
 {
@@ -38,7 +48,7 @@ is_ignore_metal(const types::Metal metal)
 }
 
 void
-apply_orientation(geom::Polygon& poly, types::Orientation orientation, double width, double height)
+apply_orientation(geom::Polygon& poly, types::Orientation orientation, geom::Coord width, geom::Coord height)
 {
   if(poly.m_points.size() < 4)
     {
@@ -47,8 +57,8 @@ apply_orientation(geom::Polygon& poly, types::Orientation orientation, double wi
 
   for(size_t i = 0; i < poly.m_points.size(); ++i)
     {
-      double x = poly.m_points[i].x;
-      double y = poly.m_points[i].y;
+      geom::Coord x = poly.m_points[i].x;
+      geom::Coord y = poly.m_points[i].y;
 
       switch(orientation)
         {
@@ -98,6 +108,90 @@ apply_orientation(geom::Polygon& poly, types::Orientation orientation, double wi
     }
 }
 
+/** Overlaps found by a single shard of the collect_overlaps */
+struct OverlapsShard
+{
+  std::vector<std::pair<def::GCell*, geom::Polygon>>             m_obstacles; ///> Overlaps of obstacles with gcells.
+  std::vector<std::tuple<def::GCell*, pin::Pin*, geom::Polygon>> m_pins;      ///> Overlaps of pins with gcells.
+  std::vector<pin::Pin*>                                         m_new_pins;  ///> Pins created from macros of components.
+};
+
+/** Support function for printing errors from worker threads without interleaving */
+void
+print_error(const std::string& name, const std::string& message)
+{
+  static std::mutex           mutex;
+  std::lock_guard<std::mutex> lock(mutex);
+
+  std::cout << "Error: " << name << " - " << message << std::endl;
+}
+
+/** Orders of nets tried by the solve_nets, the first one is the order of a stack and the rest are sorted by the difficulty of nets */
+std::vector<std::vector<std::size_t>>
+make_net_orders(const def::Stack& stack, const std::vector<std::unordered_set<uint32_t>>& nets)
+{
+  const std::size_t        count = nets.size();
+
+  std::vector<std::size_t> pins(count);
+  std::vector<std::size_t> areas(count);
+  std::vector<std::size_t> blockages(count);
+
+  const matrix::Shape&     shape   = stack.m_matrix.m_shape;
+
+  const auto               is_open = [&](const int64_t x, const int64_t y, const uint32_t z) {
+    return x >= 0 && y >= 0 && x < int64_t(shape.m_x) && y < int64_t(shape.m_y) && stack.m_matrix(x, y, z) != 0;
+  };
+
+  for(std::size_t i = 0; i < count; ++i)
+    {
+      uint32_t min_x = std::numeric_limits<uint32_t>::max();
+      uint32_t min_y = std::numeric_limits<uint32_t>::max();
+      uint32_t max_x = 0;
+      uint32_t max_y = 0;
+
+      for(const uint32_t terminal : nets[i])
+        {
+          const matrix::Node& node = stack.m_nodes[terminal];
+
+          min_x                    = std::min(min_x, node.m_x);
+          min_y                    = std::min(min_y, node.m_y);
+          max_x                    = std::max(max_x, node.m_x);
+          max_y                    = std::max(max_y, node.m_y);
+
+          /** Blocked cells around a terminal leave fewer ways to reach it */
+          for(const auto& [dx, dy] : { std::pair{ -1, 0 }, std::pair{ 1, 0 }, std::pair{ 0, -1 }, std::pair{ 0, 1 } })
+            {
+              blockages[i] += !is_open(int64_t(node.m_x) + dx, int64_t(node.m_y) + dy, node.m_z);
+            }
+        }
+
+      pins[i]  = nets[i].size();
+      areas[i] = nets[i].empty() ? 0 : std::size_t(max_x - min_x + 1) * (max_y - min_y + 1);
+    }
+
+  std::vector<std::size_t> order(count);
+  std::iota(order.begin(), order.end(), 0);
+
+  std::vector<std::vector<std::size_t>> orders    = { order };
+
+  const auto                            add_order = [&](const auto& compare) {
+    std::stable_sort(order.begin(), order.end(), compare);
+
+    if(std::find(orders.begin(), orders.end(), order) == orders.end())
+      {
+        orders.push_back(order);
+      }
+
+    std::iota(order.begin(), order.end(), 0);
+  };
+
+  add_order([&](const std::size_t lhs, const std::size_t rhs) { return pins[lhs] > pins[rhs]; });
+  add_order([&](const std::size_t lhs, const std::size_t rhs) { return areas[lhs] < areas[rhs]; });
+  add_order([&](const std::size_t lhs, const std::size_t rhs) { return blockages[lhs] > blockages[rhs]; });
+
+  return orders;
+}
+
 } // namespace process::details::global_routing
 
 namespace process
@@ -105,8 +199,6 @@ namespace process
 
 Process::~Process()
 {
-  guide::cleanup(m_guide);
-
   for(std::size_t y = 0, end_y = m_def_data.m_gcells.size(); y < end_y; ++y)
     {
       for(std::size_t x = 0, end_x = m_def_data.m_gcells[y].size(); x < end_x; ++x)
@@ -134,140 +226,263 @@ Process::~Process()
 void
 Process::prepare_data()
 {
-  const lef::LEF lef;
-  const def::DEF def;
+  /** LEF, DEF and guide files don't depend on each other, the only barrier is the overlaps collecting that needs all of them */
+  const std::launch  policy       = parallel::resolve_threads(m_threads_count) > 1 ? std::launch::async : std::launch::deferred;
+
+  auto               lef_future   = std::async(policy, [this]() {
+    const lef::LEF lef;
+    return lef.parse(m_path_pdk, m_path_cache.empty() ? m_path_pdk : m_path_cache);
+  });
+
+  auto               def_future   = std::async(policy, [this]() {
+    const def::DEF def;
+    return def.parse(m_path_design);
+  });
+
+  auto               guide_future = std::async(policy, [this]() { return guide::read(m_path_guide, m_threads_count); });
+
+  /** Join all readers before rethrowing, so the already read data is owned and released by the process */
+  std::exception_ptr error;
+
+  const auto         join         = [&error](auto& future, auto& target) {
+    try
+      {
+        target = future.get();
+      }
+    catch(...)
+      {
+        if(!error)
+          {
+            error = std::current_exception();
+          }
+      }
+  };
+
+  join(lef_future, m_lef_data);
+  join(def_future, m_def_data);
+  join(guide_future, m_guide);
 
-  m_lef_data = lef.parse(m_path_pdk);
-  m_def_data = def.parse(m_path_design);
-  m_guide    = guide::read(m_path_guide);
+  if(error)
+    {
+      std::rethrow_exception(error);
+    }
 }
 
 void
 Process::collect_overlaps()
 {
   /** GCells with overlaps */
-  using GWO = std::vector<std::pair<def::GCell*, geom::Polygon>>;
+  using GWO                               = std::vector<std::pair<def::GCell*, geom::Polygon>>;
 
-  for(auto& poly : m_def_data.m_obstacles)
-    {
-      if(details::is_ignore_metal(poly.m_metal) || poly.m_metal == types::Metal::L1)
-        {
-          continue;
-        }
+  const std::vector<def::GCell*>& last_row = m_def_data.m_gcells.back();
 
-      GWO gwo = def::GCell::find_overlaps(poly, m_def_data.m_gcells, m_def_data.m_max_gcell_x, m_def_data.m_max_gcell_y);
+  /** Shards only read the design and the gcell grid, all writes go to the shard buffers and are merged in the shards order */
+  const auto merge = [this](std::vector<details::OverlapsShard>& shards) {
+    for(auto& shard : shards)
+      {
+        for(auto& [gcell, overlap] : shard.m_obstacles)
+          {
+            gcell->m_obstacles.emplace_back(std::move(overlap));
+          }
 
-      for(auto& [gcell, overlap] : gwo)
-        {
-          gcell->m_obstacles.emplace_back(overlap);
-        }
-    }
+        for(auto& [gcell, pin, overlap] : shard.m_pins)
+          {
+            m_gcell_to_pins[gcell][pin] = std::move(overlap);
+            m_pin_to_gcells[pin].emplace(gcell);
+          }
 
-  for(auto& [_, pin] : m_def_data.m_pins)
-    {
-      geom::Polygon port = pin->m_ports.at(0);
+        for(auto pin : shard.m_new_pins)
+          {
+            m_def_data.m_pins[pin->m_name] = pin;
+          }
+      }
+  };
 
-      if(details::is_ignore_metal(port.m_metal))
-        {
-          continue;
-        }
+  /** Wires of special nets, they were only recorded by the DEF parser */
+  {
+    const std::vector<def::WireTemplate>& wires = m_def_data.m_wires;
+    std::vector<details::OverlapsShard>   shards(parallel::shards_count(wires.size(), m_threads_count));
 
-      if(port.m_points[1].x >= m_def_data.m_max_gcell_x)
-        {
-          port.m_points[1].x = m_def_data.m_gcells.back().back()->m_box.m_points[0].x * .999;
-          port.m_points[2].x = m_def_data.m_gcells.back().back()->m_box.m_points[0].x * .999;
-        }
+    parallel::for_each_shard(wires.size(), m_threads_count, [&](const std::size_t begin, const std::size_t end, const std::size_t shard_idx) {
+      details::OverlapsShard& shard = shards[shard_idx];
 
-      if(port.m_points[2].y >= m_def_data.m_max_gcell_y)
+      for(std::size_t i = begin; i < end; ++i)
         {
-          port.m_points[2].y = m_def_data.m_gcells.back().back()->m_box.m_points[0].y * .999;
-          port.m_points[3].y = m_def_data.m_gcells.back().back()->m_box.m_points[0].y * .999;
+          const auto&         box = wires[i].m_box;
+          const geom::Polygon wire({ double(box[0]), double(box[1]), double(box[2]), double(box[3]) }, wires[i].m_metal);
+
+          GWO gwo = def::GCell::find_overlaps(wire, m_def_data.m_gcells, m_def_data.m_gcell_index);
+          std::move(gwo.begin(), gwo.end(), std::back_inserter(shard.m_obstacles));
         }
+    });
 
-      GWO gwo = def::GCell::find_overlaps(port, m_def_data.m_gcells, m_def_data.m_max_gcell_x, m_def_data.m_max_gcell_y);
+    merge(shards);
 
-      for(auto& [gcell, overlap] : gwo)
-        {
-          m_gcell_to_pins[gcell][pin] = std::move(overlap);
-          m_pin_to_gcells[pin].emplace(gcell);
-        }
-    }
+    /** Wires are only needed to fill gcells */
+    m_def_data.m_wires.clear();
+    m_def_data.m_wires.shrink_to_fit();
+  }
 
-  for(auto& component : m_def_data.m_components)
-    {
-      if(m_lef_data.m_macros.count(component.m_name) == 0)
-        {
-          throw std::runtime_error("Process Error: Couldn't find a macro with the name - \"" + component.m_name + "\".");
-        }
+  /** Design obstacles */
+  {
+    std::vector<details::OverlapsShard> shards(parallel::shards_count(m_def_data.m_obstacles.size(), m_threads_count));
 
-      lef::Macro   macro  = m_lef_data.m_macros.at(component.m_name);
-      const double width  = macro.m_width * m_lef_data.m_database_number;
-      const double height = macro.m_height * m_lef_data.m_database_number;
+    parallel::for_each_shard(m_def_data.m_obstacles.size(), m_threads_count, [&](const std::size_t begin, const std::size_t end, const std::size_t shard_idx) {
+      details::OverlapsShard& shard = shards[shard_idx];
 
-      for(auto& obs : macro.m_obs)
+      for(std::size_t i = begin; i < end; ++i)
         {
-          if(details::is_ignore_metal(obs.m_metal) || obs.m_metal == types::Metal::L1)
+          const geom::Polygon& poly = m_def_data.m_obstacles[i];
+
+          if(details::is_ignore_metal(poly.m_metal) || poly.m_metal == types::Metal::L1)
             {
               continue;
             }
 
-          obs.scale_by(m_lef_data.m_database_number);
-          details::apply_orientation(obs, component.m_orientation, width, height);
-          obs.move_by({ component.m_x, component.m_y });
+          GWO gwo = def::GCell::find_overlaps(poly, m_def_data.m_gcells, m_def_data.m_gcell_index);
+          std::move(gwo.begin(), gwo.end(), std::back_inserter(shard.m_obstacles));
+        }
+    });
+
+    merge(shards);
+  }
 
-          GWO gwo = def::GCell::find_overlaps(obs, m_def_data.m_gcells, m_def_data.m_max_gcell_x, m_def_data.m_max_gcell_y);
+  /** Design pins */
+  {
+    std::vector<pin::Pin*> pins;
+    pins.reserve(m_def_data.m_pins.size());
 
-          for(auto& [gcell, overlap] : gwo)
-            {
-              gcell->m_obstacles.emplace_back(overlap);
-            }
-        }
+    for(auto& [_, pin] : m_def_data.m_pins)
+      {
+        pins.emplace_back(pin);
+      }
 
-      for(auto& [name, pin] : macro.m_pins)
+    std::vector<details::OverlapsShard> shards(parallel::shards_count(pins.size(), m_threads_count));
+
+    parallel::for_each_shard(pins.size(), m_threads_count, [&](const std::size_t begin, const std::size_t end, const std::size_t shard_idx) {
+      details::OverlapsShard& shard = shards[shard_idx];
+
+      for(std::size_t i = begin; i < end; ++i)
         {
-          pin::Pin*     new_pin = new pin::Pin(pin);
-          geom::Polygon port    = new_pin->m_ports.at(0);
+          pin::Pin*     pin  = pins[i];
+          geom::Polygon port = pin->m_ports.at(0);
 
           if(details::is_ignore_metal(port.m_metal))
             {
               continue;
             }
 
-          port.scale_by(m_lef_data.m_database_number);
-          details::apply_orientation(port, component.m_orientation, width, height);
-          port.move_by({ component.m_x, component.m_y });
+          /** Gcells are half-open, so ports on the far edge of the die are moved just inside the last gcell */
+          if(port.m_points[1].x >= m_def_data.m_max_gcell_x)
+            {
+              port.m_points[1].x = geom::prev_coord(last_row.back()->m_box.m_points[0].x);
+              port.m_points[2].x = geom::prev_coord(last_row.back()->m_box.m_points[0].x);
+            }
+
+          if(port.m_points[2].y >= m_def_data.m_max_gcell_y)
+            {
+              port.m_points[2].y = geom::prev_coord(last_row.back()->m_box.m_points[0].y);
+              port.m_points[3].y = geom::prev_coord(last_row.back()->m_box.m_points[0].y);
+            }
 
-          GWO gwo = def::GCell::find_overlaps(port, m_def_data.m_gcells, m_def_data.m_max_gcell_x, m_def_data.m_max_gcell_y);
+          GWO gwo = def::GCell::find_overlaps(port, m_def_data.m_gcells, m_def_data.m_gcell_index);
 
           for(auto& [gcell, overlap] : gwo)
             {
-              m_gcell_to_pins[gcell][new_pin] = std::move(overlap);
-              m_pin_to_gcells[new_pin].emplace(gcell);
+              shard.m_pins.emplace_back(gcell, pin, std::move(overlap));
             }
+        }
+    });
+
+    merge(shards);
+  }
+
+  /** Components */
+  {
+    std::vector<details::OverlapsShard> shards(parallel::shards_count(m_def_data.m_components.size(), m_threads_count));
 
-          for(auto& poly : new_pin->m_obs)
+    try
+      {
+        parallel::for_each_shard(m_def_data.m_components.size(), m_threads_count, [&](const std::size_t begin, const std::size_t end, const std::size_t shard_idx) {
+          details::OverlapsShard& shard = shards[shard_idx];
+
+          for(std::size_t i = begin; i < end; ++i)
             {
-              if(details::is_ignore_metal(poly.m_metal))
+              const auto& component = m_def_data.m_components[i];
+
+              if(m_lef_data.m_macros.count(component.m_name) == 0)
                 {
-                  continue;
+                  throw std::runtime_error("Process Error: Couldn't find a macro with the name - \"" + component.m_name + "\".");
                 }
 
-              poly.scale_by(m_lef_data.m_database_number);
-              details::apply_orientation(poly, component.m_orientation, width, height);
-              poly.move_by({ component.m_x, component.m_y });
+              lef::Macro        macro  = m_lef_data.m_macros.at(component.m_name);
+              const geom::Coord width  = geom::to_coord(macro.m_width * m_lef_data.m_database_number);
+              const geom::Coord height = geom::to_coord(macro.m_height * m_lef_data.m_database_number);
+
+              for(auto& obs : macro.m_obs)
+                {
+                  if(details::is_ignore_metal(obs.m_metal) || obs.m_metal == types::Metal::L1)
+                    {
+                      continue;
+                    }
+
+                  details::apply_orientation(obs, component.m_orientation, width, height);
+                  obs.move_by({ component.m_x, component.m_y });
 
-              GWO gwo = def::GCell::find_overlaps(poly, m_def_data.m_gcells, m_def_data.m_max_gcell_x, m_def_data.m_max_gcell_y);
+                  GWO gwo = def::GCell::find_overlaps(obs, m_def_data.m_gcells, m_def_data.m_gcell_index);
+                  std::move(gwo.begin(), gwo.end(), std::back_inserter(shard.m_obstacles));
+                }
 
-              for(auto& [gcell, overlap] : gwo)
+              for(auto& [name, pin] : macro.m_pins)
                 {
-                  gcell->m_obstacles.emplace_back(overlap);
+                  geom::Polygon port = pin.m_ports.at(0);
+
+                  if(details::is_ignore_metal(port.m_metal))
+                    {
+                      continue;
+                    }
+
+                  pin::Pin* new_pin = new pin::Pin(pin);
+
+                  details::apply_orientation(port, component.m_orientation, width, height);
+                  port.move_by({ component.m_x, component.m_y });
+
+                  GWO gwo = def::GCell::find_overlaps(port, m_def_data.m_gcells, m_def_data.m_gcell_index);
+
+                  for(auto& [gcell, overlap] : gwo)
+                    {
+                      shard.m_pins.emplace_back(gcell, new_pin, std::move(overlap));
+                    }
+
+                  for(auto& poly : new_pin->m_obs)
+                    {
+                      if(details::is_ignore_metal(poly.m_metal))
+                        {
+                          continue;
+                        }
+
+                      details::apply_orientation(poly, component.m_orientation, width, height);
+                      poly.move_by({ component.m_x, component.m_y });
+
+                      GWO gwo = def::GCell::find_overlaps(poly, m_def_data.m_gcells, m_def_data.m_gcell_index);
+                      std::move(gwo.begin(), gwo.end(), std::back_inserter(shard.m_obstacles));
+                    }
+
+                  new_pin->m_name = component.m_id + ":" + name;
+                  shard.m_new_pins.emplace_back(new_pin);
                 }
             }
-
-          new_pin->m_name                    = component.m_id + ":" + name;
-          m_def_data.m_pins[new_pin->m_name] = new_pin;
-        }
-    }
+        });
+      }
+    catch(...)
+      {
+        /** Hand over already created pins, so they are released together with the design */
+        merge(shards);
+        throw;
+      }
+
+    merge(shards);
+  }
 }
 
 void
@@ -288,11 +503,11 @@ Process::apply_guide()
       std::unordered_set<def::GCell*>                         inner_nodes;
       std::unordered_map<def::GCell*, std::vector<pin::Pin*>> all_pins;
 
-      for(auto node : net.m_nodes)
+      for(const auto& node : net.m_nodes)
         {
-          def::GCell* gcell = m_def_data.m_gcells[node->m_y][node->m_x];
+          def::GCell* gcell = m_def_data.m_gcells[node.m_y][node.m_x];
 
-          if(node->m_connections == 1)
+          if(node.m_connections == 1)
             {
               leaf_nodes.emplace(gcell);
             }
@@ -396,11 +611,11 @@ Process::apply_guide()
 
       for(const auto& edge : net.m_edges)
         {
-          guide::Node* source     = edge.m_source;
-          guide::Node* dest       = edge.m_destination;
+          const guide::Node& source     = net.m_nodes[edge.m_source];
+          const guide::Node& dest       = net.m_nodes[edge.m_destination];
 
-          def::GCell*  gcell      = m_def_data.m_gcells[source->m_y][source->m_x];
-          def::GCell*  next_gcell = m_def_data.m_gcells[dest->m_y][dest->m_x];
+          def::GCell*        gcell      = m_def_data.m_gcells[source.m_y][source.m_x];
+          def::GCell*        next_gcell = m_def_data.m_gcells[dest.m_y][dest.m_x];
 
           if(!(leaf_nodes.count(gcell) != 0 || inner_nodes.count(gcell) != 0) || !(leaf_nodes.count(next_gcell) != 0 || inner_nodes.count(next_gcell) != 0))
             {
@@ -446,9 +661,9 @@ Process::apply_guide()
           m_def_data.m_cross_pins.emplace_back(cross_pin);
         }
 
-      for(auto node : net.m_nodes)
+      for(const auto& node : net.m_nodes)
         {
-          def::GCell* gcell = m_def_data.m_gcells[node->m_y][node->m_x];
+          def::GCell* gcell = m_def_data.m_gcells[node.m_y][node.m_x];
 
           if(all_pins.count(gcell) != 0 && all_pins[gcell].size() > 1)
             {
@@ -505,31 +720,69 @@ Process::remove_empty_gcells()
   m_def_data.m_gcells.erase(itr, m_def_data.m_gcells.end());
 }
 
+bool
+Process::load_snapshot()
+{
+  if(m_path_snapshot.empty() || !std::filesystem::exists(m_path_snapshot))
+    {
+      return false;
+    }
+
+  if(!snapshot::load(m_path_snapshot, make_snapshot_key(), m_def_data))
+    {
+      return false;
+    }
+
+  for(const auto& row : m_def_data.m_gcells)
+    {
+      for(auto gcell : row)
+        {
+          const std::string name  = "GCell_x_" + std::to_string(gcell->m_x) + "_y_" + std::to_string(gcell->m_y);
+          m_gcells_by_names[name] = gcell;
+        }
+    }
+
+  return true;
+}
+
 void
-Process::make_dataset()
+Process::save_snapshot() const
 {
-  const std::size_t           size              = 32;
-  const std::size_t           step              = 2;
-  const std::size_t           max_net_per_stack = 50;
+  if(m_path_snapshot.empty())
+    {
+      return;
+    }
 
+  try
+    {
+      snapshot::save(m_path_snapshot, make_snapshot_key(), m_def_data);
+    }
+  catch(const std::exception& e)
+    {
+      /** A failed snapshot only costs the processing time of the next run */
+      std::cout << "Process Warning: " << e.what() << std::endl;
+    }
+}
+
+void
+Process::make_dataset()
+{
   /** Preapare folders */
   const std::string           design_name       = m_path_design.filename().replace_extension("").string() + "_max";
   const std::filesystem::path root_folder       = std::filesystem::current_path() / design_name / "gcells";
 
-  if(std::filesystem::exists(root_folder))
+  /** A resumed dataset keeps files of completed tasks */
+  if(std::filesystem::exists(root_folder) && !m_dataset_options.m_resume)
     {
       std::filesystem::remove_all(root_folder);
     }
 
-  const std::filesystem::path csv_file_path = root_folder / "data.csv";
-  const std::filesystem::path source_folder = root_folder / "source";
-  const std::filesystem::path target_folder = root_folder / "target";
-
-  std::filesystem::create_directories(source_folder);
-  std::filesystem::create_directories(target_folder);
+  /** Stacks don't share any state, so each of them is solved by its own task and files are written by the writer thread */
+  dataset::Writer writer(root_folder, 2 * parallel::resolve_threads(m_threads_count), m_dataset_options);
 
-  std::ofstream csv_file(csv_file_path);
-  csv_file << "source_h,source_v,net,target_path,pins_count,nets_count" << std::endl;
+  /** Collect tasks in a fixed order, so the data.csv doesn't depend on the scheduling */
+  std::vector<std::tuple<std::string, std::string, def::GCell*, std::size_t>> tasks;
+  std::size_t                                                                 completed_count = 0;
 
   for(auto [name, gcell] : m_gcells_by_names)
     {
@@ -538,314 +791,419 @@ Process::make_dataset()
           continue;
         }
 
-      std::size_t counter = 0;
-
-      while(true)
+      for(std::size_t i = 0, end = gcell->m_stacks.size(); i < end; ++i)
         {
-          auto [stack, is_last] = gcell->get_next_stack();
+          if(gcell->m_stacks[i].is_empty())
+            {
+              continue;
+            }
+
+          std::string key = name + "_stack_" + std::to_string(i + 1);
 
-          if(!stack.is_empty())
+          if(writer.is_completed(key))
             {
-              const auto all_nets       = stack.m_nets;
-              auto       left_nets_itr  = all_nets.begin();
-              auto       right_nets_itr = all_nets.begin();
+              ++completed_count;
+              continue;
+            }
 
-              /** Create task by steps */
-              for(std::size_t i = 0, end = all_nets.size(); i < end; i += max_net_per_stack)
-                {
-                  if(i != 0)
-                    {
-                      std::advance(left_nets_itr, std::min(max_net_per_stack, end - i));
-                    }
+          tasks.emplace_back(std::move(key), name, gcell, i);
+        }
+    }
 
-                  std::advance(right_nets_itr, std::min(max_net_per_stack, end - i));
+  if(completed_count != 0)
+    {
+      std::cout << "Resuming the dataset, " << completed_count << " stacks are already completed." << std::endl;
+    }
 
-                  const std::string save_name = name + "_stack_" + std::to_string(counter + 1) + "_" + std::to_string(i + 1);
+  std::sort(tasks.begin(), tasks.end(), [](const auto& lhs, const auto& rhs) {
+    const auto& [lhs_key, lhs_name, lhs_gcell, lhs_idx] = lhs;
+    const auto& [rhs_key, rhs_name, rhs_gcell, rhs_idx] = rhs;
 
-                  stack.m_terminals.clear();
-                  stack.m_nets.clear();
+    return std::tie(lhs_gcell->m_y, lhs_gcell->m_x, lhs_idx) < std::tie(rhs_gcell->m_y, rhs_gcell->m_x, rhs_idx);
+  });
 
-                  stack.m_nets.insert(left_nets_itr, right_nets_itr);
+  /** Workers that run out of stacks lend their threads to the searches of stacks that are still being solved */
+  parallel::ThreadBudget budget;
 
-                  for(const auto& [_, local_net] : stack.m_nets)
-                    {
-                      for(const auto& terminal : local_net.m_terminals)
-                        {
-                          stack.m_terminals.insert(terminal);
-                        }
-                    }
+  try
+    {
+      parallel::for_each_task(
+          tasks.size(), m_threads_count, [&](const std::size_t idx, const std::size_t) {
+            auto& [key, name, gcell, stack_idx] = tasks[idx];
+            writer.push({ idx, key, make_stack_samples(name, gcell->m_stacks[stack_idx], stack_idx, stack_idx + 1 == gcell->m_stacks.size(), budget) });
+          },
+          &budget);
+    }
+  catch(...)
+    {
+      /** An error of the writer is the cause of a failed push, so it is rethrown first */
+      writer.finish();
+      throw;
+    }
 
-                  stack.m_node_map.clear();
-                  stack.m_nodes.clear();
-                  stack.m_graph.get_adj().clear();
+  writer.finish();
+}
 
-                  stack.create_matrix(size, step);
-                  stack.create_graph();
+std::vector<dataset::Sample>
+Process::make_stack_samples(const std::string& name, def::Stack& stack, const std::size_t stack_idx, const bool is_last, parallel::ThreadBudget& budget)
+{
+  const std::size_t              size              = 32;
+  const std::size_t              step              = 2;
+  const std::size_t              max_net_per_stack = 50;
 
-                  if(stack.m_graph.get_adj().empty())
-                    {
-                      if(is_last)
-                        {
-                          break;
-                        }
+  std::vector<dataset::Sample>   samples;
 
-                      continue;
-                    }
+  /** Nets are split into chunks in order they were added to the stack, so chunks are the same for a loaded snapshot */
+  std::vector<def::details::Net> all_nets;
 
-                  /** Setup dirs */
-                  std::filesystem::create_directories(source_folder / save_name);
-                  std::filesystem::create_directories(target_folder / save_name);
+  for(const def::details::Net* net : stack.get_ordered_nets())
+    {
+      all_nets.push_back(*net);
+    }
 
-                  const auto [responses, is_any_solved, errors, iterations] = solve_nets(stack);
+  /** Create task by steps */
+  for(std::size_t i = 0, end = all_nets.size(); i < end; i += max_net_per_stack)
+    {
+      const std::string save_name = name + "_stack_" + std::to_string(stack_idx + 1) + "_" + std::to_string(i + 1);
 
-                  for(const auto& message : errors)
-                    {
-                      std::cout << "Error: " << save_name << " - " << message << std::endl;
-                    }
+      stack.m_terminals.clear();
+      stack.m_nets.clear();
 
-                  if(!is_any_solved)
-                    {
-                      continue;
-                    }
+      for(std::size_t j = i, end_j = std::min(i + max_net_per_stack, end); j < end_j; ++j)
+        {
+          stack.m_nets.emplace(all_nets[j].m_ptr, all_nets[j]);
+        }
 
-                  std::ofstream  nets_file(source_folder / save_name / (std::to_string(i + 1) + "_nets.txt"));
+      for(const auto& [_, local_net] : stack.m_nets)
+        {
+          for(const auto& terminal : local_net.m_terminals)
+            {
+              stack.m_terminals.insert(terminal);
+            }
+        }
 
-                  matrix::Matrix path{ { stack.m_matrix.m_shape.m_x, stack.m_matrix.m_shape.m_y, 1 } };
-                  matrix::Matrix distance_matrix_h{ { stack.m_matrix.m_shape.m_x, stack.m_matrix.m_shape.m_y, responses.size() } };
-                  matrix::Matrix distance_matrix_v{ { stack.m_matrix.m_shape.m_x, stack.m_matrix.m_shape.m_y, responses.size() } };
+      stack.create_matrix(size, step);
+      stack.create_graph();
 
-                  std::size_t    pins_counter = 0;
-                  std::size_t    nets_counter = 0;
+      if(stack.m_graph.empty())
+        {
+          if(is_last)
+            {
+              break;
+            }
 
-                  for(std::size_t j = 0, end_j = responses.size(); j < end_j; ++j)
-                    {
-                      const auto res              = responses.at(j);
-                      const auto [net, local_net] = *std::find_if(stack.m_nets.begin(), stack.m_nets.end(), [res](const auto& pair) { return res.m_ptr->m_name == pair.first->m_name; });
+          continue;
+        }
 
-                      pins_counter += local_net.m_terminals.size();
-                      nets_counter += 1;
+      const auto [responses, is_any_solved, errors, iterations] = solve_nets(stack, budget);
 
-                      const auto [h_matrix, v_matrix] = distance_cost_map(stack.m_matrix, local_net.m_terminals, stack.m_terminals);
+      for(const auto& message : errors)
+        {
+          details::print_error(save_name, message);
+        }
 
-                      for(std::size_t y = 0; y < stack.m_matrix.m_shape.m_y; ++y)
-                        {
-                          for(std::size_t x = 0; x < stack.m_matrix.m_shape.m_x; ++x)
-                            {
-                              for(std::size_t z = 0; z < 2; ++z)
-                                {
-                                  distance_matrix_h.set_at(h_matrix.get_at(x, y, 0), x, y, j);
-                                  distance_matrix_v.set_at(v_matrix.get_at(x, y, 0), x, y, j);
-                                }
-                            }
-                        }
+      if(!is_any_solved)
+        {
+          continue;
+        }
 
-                      for(const auto& line : res.m_paths)
-                        {
-                          const std::size_t metal_idx = (uint8_t(line.m_metal) - 1) / 2 - 1;
-
-                          if(line.m_start.x == line.m_end.x)
-                            {
-                              for(std::size_t y = line.m_start.y; y <= line.m_end.y; ++y)
-                                {
-                                  if(path.get_at(line.m_start.x, y, 0) == 0)
-                                    {
-                                      path.set_at(1, line.m_start.x, y, 0);
-                                    }
-                                  else
-                                    {
-                                      path.set_at(1, line.m_start.x, y, 0);
-                                    }
-                                }
-                            }
-                        }
+      std::ostringstream nets_file;
 
-                      for(const auto& line : res.m_paths)
-                        {
-                          const std::size_t metal_idx = (uint8_t(line.m_metal) - 1) / 2 - 1;
-
-                          if(line.m_start.y == line.m_end.y)
-                            {
-                              for(std::size_t x = line.m_start.x; x <= line.m_end.x; ++x)
-                                {
-                                  if(path.get_at(x, line.m_start.y, 0) == 0)
-                                    {
-                                      path.set_at(1, x, line.m_start.y, 0);
-                                    }
-                                  else
-                                    {
-                                      path.set_at(1, x, line.m_start.y, 0);
-                                    }
-                                }
-                            }
-                        }
+      /** Buffers of samples are returned to the pool of this thread after encoding, so stacks of the same size reuse them */
+      const matrix::Shape     shape{ stack.m_matrix.m_shape.m_x, stack.m_matrix.m_shape.m_y, responses.size() };
 
-                      for(const auto& via : res.m_inner_via)
-                        {
-                          path.set_at(2, via.x, via.y, 0);
-                          path.set_at(2, via.x, via.y, 0);
-                        }
+      matrix::Matrix<uint8_t> path              = matrix::Pool<uint8_t>::local().acquire({ shape.m_x, shape.m_y, 1 });
+      matrix::Matrix<>        distance_matrix_h = matrix::Pool<>::local().acquire(shape);
+      matrix::Matrix<>        distance_matrix_v = matrix::Pool<>::local().acquire(shape);
 
-                      {
-                        nets_file << "BEGIN" << std::endl;
-                        nets_file << res.m_ptr->m_name << std::endl;
+      /** Obstacles are the same for all nets of a chunk, so they are prepared once */
+      algorithms::CostMap     cost_map(stack.m_matrix, stack.m_terminals);
 
-                        for(auto& pin : local_net.m_terminals)
-                          {
-                            nets_file << int32_t(pin.m_x) << ", " << int32_t(pin.m_y) << ", " << int32_t(pin.m_z) << std::endl;
-                          }
+      std::size_t             pins_counter = 0;
+      std::size_t             nets_counter = 0;
 
-                        nets_file << "END" << std::endl;
-                      }
-                    }
+      for(std::size_t j = 0, end_j = responses.size(); j < end_j; ++j)
+        {
+          const auto res              = responses.at(j);
+          const auto [net, local_net] = *std::find_if(stack.m_nets.begin(), stack.m_nets.end(), [res](const auto& pair) { return res.m_ptr->m_name == pair.first->m_name; });
 
-                  nets_file << "\n"
-                            << pins_counter << "\n"
-                            << nets_counter << std::endl;
+          pins_counter += local_net.m_terminals.size();
+          nets_counter += 1;
 
-                  nets_file.close();
+          cost_map.compute(local_net.m_terminals, distance_matrix_h.slice(j), distance_matrix_v.slice(j));
 
-                  numpy::save_as<double>(source_folder / save_name / (std::to_string(i + 1) + "_h.npy"), distance_matrix_h.data(), { stack.m_matrix.m_shape.m_y, stack.m_matrix.m_shape.m_x, responses.size() });
-                  numpy::save_as<double>(source_folder / save_name / (std::to_string(i + 1) + "_v.npy"), distance_matrix_v.data(), { stack.m_matrix.m_shape.m_y, stack.m_matrix.m_shape.m_x, responses.size() });
-                  numpy::save_as<double>(target_folder / save_name / (std::to_string(i + 1) + "_path.npy"), path.data(), { stack.m_matrix.m_shape.m_y, stack.m_matrix.m_shape.m_x, 1 });
+          for(const auto& line : res.m_paths)
+            {
+              const std::size_t metal_idx = (uint8_t(line.m_metal) - 1) / 2 - 1;
 
-                  csv_file << (source_folder / save_name / (std::to_string(i + 1) + "_h.npy")).string() << ","
-                           << (source_folder / save_name / (std::to_string(i + 1) + "_v.npy")).string() << ","
-                           << (source_folder / save_name / (std::to_string(i + 1) + "_nets.txt")).string() << ","
-                           << (target_folder / save_name / (std::to_string(i + 1) + "_path.npy")).string() << ","
-                           << pins_counter << ","
-                           << nets_counter
-                           << std::endl;
+              if(line.m_start.x == line.m_end.x)
+                {
+                  for(std::size_t y = line.m_start.y; y <= line.m_end.y; ++y)
+                    {
+                      if(path(line.m_start.x, y, 0) == 0)
+                        {
+                          path(line.m_start.x, y, 0) = 1;
+                        }
+                      else
+                        {
+                          path(line.m_start.x, y, 0) = 1;
+                        }
+                    }
                 }
             }
 
-          if(is_last)
+          for(const auto& line : res.m_paths)
             {
-              break;
+              const std::size_t metal_idx = (uint8_t(line.m_metal) - 1) / 2 - 1;
+
+              if(line.m_start.y == line.m_end.y)
+                {
+                  for(std::size_t x = line.m_start.x; x <= line.m_end.x; ++x)
+                    {
+                      if(path(x, line.m_start.y, 0) == 0)
+                        {
+                          path(x, line.m_start.y, 0) = 1;
+                        }
+                      else
+                        {
+                          path(x, line.m_start.y, 0) = 1;
+                        }
+                    }
+                }
+            }
+
+          for(const auto& via : res.m_inner_via)
+            {
+              path(via.x, via.y, 0) = 2;
+              path(via.x, via.y, 0) = 2;
             }
 
-          ++counter;
+          {
+            nets_file << "BEGIN" << std::endl;
+            nets_file << res.m_ptr->m_name << std::endl;
+
+            for(auto& pin : local_net.m_terminals)
+              {
+                nets_file << int32_t(pin.m_x) << ", " << int32_t(pin.m_y) << ", " << int32_t(pin.m_z) << std::endl;
+              }
+
+            nets_file << "END" << std::endl;
+          }
         }
+
+      nets_file << "\n"
+                << pins_counter << "\n"
+                << nets_counter << std::endl;
+
+      samples.push_back({ save_name, i + 1, nets_file.str(), std::move(distance_matrix_h), std::move(distance_matrix_v), std::move(path), pins_counter, nets_counter });
     }
 
-  csv_file.close();
+  /** The base matrix and graph are kept by chunks of the stack only */
+  stack.release();
+
+  return samples;
+}
+
+uint64_t
+Process::make_snapshot_key() const
+{
+  std::vector<std::filesystem::path> files = lef::LEF::find_files(m_path_pdk);
+  files.emplace_back(m_path_design);
+  files.emplace_back(m_path_guide);
+
+  return snapshot::make_key(files);
 }
 
 std::tuple<std::vector<def::Response>, bool, std::vector<std::string>, std::size_t>
-Process::solve_nets(def::Stack& stack) const
+Process::solve_nets(def::Stack& stack, parallel::ThreadBudget& budget) const
 {
-  const std::size_t                                      max_iterations = 10;
-  std::size_t                                            itr            = 0;
+  const std::size_t                         max_iterations = 10;
 
-  std::vector<std::reference_wrapper<def::details::Net>> local_nets;
-  std::vector<std::size_t>                               nets_idx;
+  std::vector<def::Net*>                    nets;
+  std::vector<std::unordered_set<uint32_t>> nets_terminals;
 
-  for(auto& [net, local_net] : stack.m_nets)
-    {
-      nets_idx.emplace_back(local_nets.size());
-      local_nets.push_back(local_net);
-    }
+  std::vector<def::Net*>                    failed_nets;
+  std::vector<std::string>                  failed_messages;
 
-  do
+  for(const def::details::Net* local_net : stack.get_ordered_nets())
     {
-      algorithms::AStar          a_start(stack.m_graph, stack.m_terminals, stack.m_nodes);
+      std::unordered_set<uint32_t> local_terminals;
+      bool                         is_blocked_terminal = false;
+
+      for(const auto& terminal : local_net->m_terminals)
+        {
+          const uint32_t node = stack.find_node(terminal);
 
-      std::vector<def::Net*>     failed_nets;
-      std::vector<std::string>   failed_messages;
+          if(node == graph::Graph::NONE)
+            {
+              is_blocked_terminal = true;
+              break;
+            }
 
-      std::vector<def::Response> responses;
+          local_terminals.emplace(node);
+        }
 
-      for(const auto& idx : nets_idx)
+      if(is_blocked_terminal)
         {
-          const auto&                  local_net = local_nets.at(idx).get();
+          failed_messages.emplace_back("Unable to find graph node associated with pin in net - " + local_net->m_ptr->m_name);
+          failed_nets.emplace_back(local_net->m_ptr);
+          continue;
+        }
 
-          std::unordered_set<uint32_t> local_terminals;
-          bool                         is_blocked_terminal = false;
+      nets.emplace_back(local_net->m_ptr);
+      nets_terminals.emplace_back(std::move(local_terminals));
+    }
 
-          for(const auto& terminal : local_net.m_terminals)
-            {
-              if(stack.m_node_map.count(terminal) == 0)
-                {
-                  is_blocked_terminal = true;
-                  break;
-                }
+  /** Nets share nodes while they are negotiating, so only nets that are still sharing are ripped up and routed again */
+  const std::vector<std::vector<std::size_t>> orders = details::make_net_orders(stack, nets_terminals);
+  std::vector<algorithms::PathFinder::Result> results(orders.size());
 
-              local_terminals.emplace(stack.m_node_map[terminal]);
-            }
+  const auto                                  route_order = [&](const std::size_t idx, const std::stop_token& token) {
+    std::vector<std::unordered_set<uint32_t>> ordered_terminals;
 
-          if(is_blocked_terminal)
-            {
-              failed_messages.emplace_back("Unable to find graph node associated with pin in net - " + local_net.m_ptr->m_name);
-              failed_nets.emplace_back(local_net.m_ptr);
-              continue;
-            }
+    for(const std::size_t net : orders[idx])
+      {
+        ordered_terminals.push_back(nets_terminals[net]);
+      }
 
-          const std::vector<graph::Edge> mst = a_start.multi_terminal_path(local_terminals);
-          def::Response                  res = { local_net.m_ptr, mst.empty(), "" };
+    algorithms::PathFinder                path_finder(stack.m_graph, stack.m_terminals, stack.m_nodes);
+    algorithms::PathFinder::Result        result = path_finder.route(ordered_terminals, max_iterations, token);
 
-          if(res.m_is_failed)
-            {
-              failed_messages.emplace_back("Unable to solve net - " + local_net.m_ptr->m_name);
-              failed_nets.emplace_back(local_net.m_ptr);
-              continue;
-            }
-          else
-            {
-              for(const auto& edge : mst)
-                {
-                  const auto&  source      = stack.m_nodes[edge.m_source];
-                  const auto&  destination = stack.m_nodes[edge.m_destination];
+    std::vector<std::vector<graph::Edge>> trees(result.m_trees.size());
 
-                  uint8_t      s_x         = std::min(source.m_x, destination.m_x);
-                  uint8_t      s_y         = std::min(source.m_y, destination.m_y);
-                  uint8_t      s_z         = std::min(source.m_z, destination.m_z);
+    for(std::size_t i = 0, end = trees.size(); i < end; ++i)
+      {
+        trees[orders[idx][i]] = std::move(result.m_trees[i]);
+      }
 
-                  uint8_t      d_x         = std::max(source.m_x, destination.m_x);
-                  uint8_t      d_y         = std::max(source.m_y, destination.m_y);
-                  uint8_t      d_z         = std::max(source.m_z, destination.m_z);
+    result.m_trees = std::move(trees);
+    results[idx]   = std::move(result);
+  };
 
-                  geom::PointS start_point = { s_x, s_y };
-                  geom::PointS end_point   = { d_x, d_y };
+  route_order(0, {});
 
-                  if(d_z == stack.m_matrix.m_shape.m_z)
-                    {
-                      res.m_outer_via.emplace_back(end_point);
-                    }
-                  else if(s_z != d_z)
-                    {
-                      res.m_inner_via.emplace_back(start_point);
-                    }
+  /** Other orders run on their own searches at once, as soon as an order routes all nets every later order is stopped. The earliest
+   * complete order wins, so the result doesn't depend on the scheduling. Searches run on the current thread and on threads borrowed from
+   * workers that are idle, so stacks never take more threads than the dataset was given */
+  if(!results[0].is_complete() && orders.size() > 1)
+    {
+      std::vector<std::stop_source> stops(orders.size());
+      std::atomic<std::size_t>      winner      = orders.size();
+      const std::size_t             borrowed    = budget.acquire(orders.size() - 2);
 
-                  if(s_z == d_z)
-                    {
-                      const types::Metal metal_layer = types::Metal((s_z + 1) * 2 + 1);
-                      res.m_paths.emplace_back(start_point, end_point, metal_layer);
-                    }
-                }
-            }
+      const auto                    route_other = [&](const std::size_t task, const std::size_t) {
+        const std::size_t idx = task + 1;
+
+        if(idx > winner.load())
+          {
+            results[idx].m_is_cancelled = true;
+            return;
+          }
+
+        route_order(idx, stops[idx].get_token());
 
-          responses.emplace_back(std::move(res));
+        if(!results[idx].is_complete())
+          {
+            return;
+          }
+
+        std::size_t current = winner.load();
+
+        while(idx < current && !winner.compare_exchange_weak(current, idx))
+          {
+          }
+
+        for(std::size_t i = idx + 1, end = orders.size(); i < end; ++i)
+          {
+            stops[i].request_stop();
+          }
+      };
+
+      try
+        {
+          parallel::for_each_task(orders.size() - 1, borrowed + 1, route_other);
+        }
+      catch(...)
+        {
+          budget.release(borrowed);
+          throw;
         }
 
-      if(failed_nets.empty())
+      budget.release(borrowed);
+    }
+
+  const auto  failed_count = [](const algorithms::PathFinder::Result& result) { return std::count_if(result.m_trees.begin(), result.m_trees.end(), [](const auto& tree) { return tree.empty(); }); };
+
+  std::size_t best         = 0;
+
+  for(std::size_t i = 1, end = results.size(); i < end; ++i)
+    {
+      if(!results[i].m_is_cancelled && failed_count(results[i]) < failed_count(results[best]))
         {
-          return { std::move(responses), true, {}, itr };
+          best = i;
         }
+    }
+
+  const std::vector<std::vector<graph::Edge>>& trees = results[best].m_trees;
+  const std::size_t                            itr   = results[best].m_iterations;
 
-      if(++itr == max_iterations || !std::next_permutation(nets_idx.begin(), nets_idx.end()))
+  std::vector<def::Response>                   responses;
+
+  for(std::size_t i = 0, end = nets.size(); i < end; ++i)
+    {
+      const std::vector<graph::Edge>& mst = trees[i];
+      def::Response                   res = { nets[i], mst.empty(), "" };
+
+      if(res.m_is_failed)
+        {
+          failed_messages.emplace_back("Unable to solve net - " + nets[i]->m_name);
+          failed_nets.emplace_back(nets[i]);
+          continue;
+        }
+
+      for(const auto& edge : mst)
         {
-          bool is_all_failed = failed_nets.size() != stack.m_nets.size();
+          const auto&  source      = stack.m_nodes[edge.m_source];
+          const auto&  destination = stack.m_nodes[edge.m_destination];
+
+          uint32_t     s_x         = std::min(source.m_x, destination.m_x);
+          uint32_t     s_y         = std::min(source.m_y, destination.m_y);
+          uint32_t     s_z         = std::min(source.m_z, destination.m_z);
+
+          uint32_t     d_x         = std::max(source.m_x, destination.m_x);
+          uint32_t     d_y         = std::max(source.m_y, destination.m_y);
+          uint32_t     d_z         = std::max(source.m_z, destination.m_z);
+
+          geom::PointS start_point = { s_x, s_y };
+          geom::PointS end_point   = { d_x, d_y };
 
-          for(const auto& net : failed_nets)
+          if(d_z == stack.m_matrix.m_shape.m_z)
             {
-              stack.m_nets.erase(net);
+              res.m_outer_via.emplace_back(end_point);
+            }
+          else if(s_z != d_z)
+            {
+              res.m_inner_via.emplace_back(start_point);
             }
 
-          return { std::move(responses), is_all_failed, failed_messages, itr };
+          if(s_z == d_z)
+            {
+              const types::Metal metal_layer = types::Metal((s_z + 1) * 2 + 1);
+              res.m_paths.emplace_back(start_point, end_point, metal_layer);
+            }
         }
+
+      responses.emplace_back(std::move(res));
+    }
+
+  const bool is_any_solved = failed_nets.size() != stack.m_nets.size();
+
+  for(const auto& net : failed_nets)
+    {
+      stack.m_nets.erase(net);
     }
-  while(true);
 
-  return {};
+  return { std::move(responses), is_any_solved, failed_messages, itr };
 }
 
 } // namespace process
\ No newline at end of file
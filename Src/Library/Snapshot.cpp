@@ -0,0 +1,755 @@
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <type_traits>
+#include <unordered_map>
+
+#include <unistd.h>
+
+#include "Include/Serialize.hpp"
+#include "Include/Snapshot.hpp"
+
+namespace snapshot::details
+{
+
+/** Snapshot format version, must be increased with any change of the routing state layout, the highest bit marks integer coordinates */
+constexpr uint32_t VERSION = 3 | (std::is_integral_v<geom::Coord> ? 1u << 31 : 0u);
+constexpr uint32_t MAGIC   = 0x4E534C46; ///> "FLSN" in little-endian.
+constexpr uint64_t NONE    = UINT64_MAX; ///> The id of a nullptr.
+
+/** Numbers objects shared by pointers, so they are written once and referenced by ids */
+template <typename Tp>
+class Table
+{
+public:
+  void
+  add(const Tp* item)
+  {
+    if(item != nullptr && m_ids.emplace(item, m_items.size()).second)
+      {
+        m_items.emplace_back(item);
+      }
+  }
+
+  uint64_t
+  id(const Tp* item) const
+  {
+    return item == nullptr ? NONE : m_ids.at(item);
+  }
+
+  const std::vector<const Tp*>&
+  items() const noexcept(true)
+  {
+    return m_items;
+  }
+
+private:
+  std::vector<const Tp*>                  m_items; ///> Objects in order of ids.
+  std::unordered_map<const Tp*, uint64_t> m_ids;   ///> Maps an object to its id.
+};
+
+/** Owns objects read from a snapshot until all of them are read, so a broken snapshot leaks nothing */
+template <typename Tp>
+class Owner
+{
+public:
+  Tp*
+  add(std::unique_ptr<Tp> item)
+  {
+    m_items.emplace_back(std::move(item));
+    return m_items.back().get();
+  }
+
+  Tp*
+  at(const uint64_t id) const
+  {
+    if(id == NONE)
+      {
+        return nullptr;
+      }
+
+    if(id >= m_items.size())
+      {
+        throw std::runtime_error("Snapshot Error: Invalid reference.");
+      }
+
+    return m_items[id].get();
+  }
+
+  void
+  release() noexcept(true)
+  {
+    for(auto& item : m_items)
+      {
+        item.release();
+      }
+  }
+
+private:
+  std::vector<std::unique_ptr<Tp>> m_items;
+};
+
+/** Support functions for geometry */
+void
+write_point(serialize::Writer& writer, const geom::PointS& point)
+{
+  writer.write<uint64_t>(point.x);
+  writer.write<uint64_t>(point.y);
+}
+
+geom::PointS
+read_point(serialize::Reader& reader)
+{
+  const uint64_t x = reader.read<uint64_t>();
+  const uint64_t y = reader.read<uint64_t>();
+
+  return { x, y };
+}
+
+void
+write_grid(serialize::Writer& writer, const def::utils::MetalGrid& grid)
+{
+  writer.write(grid.m_start.x);
+  writer.write(grid.m_start.y);
+  writer.write(grid.m_end.x);
+  writer.write(grid.m_end.y);
+  writer.write(grid.m_step);
+}
+
+def::utils::MetalGrid
+read_grid(serialize::Reader& reader)
+{
+  def::utils::MetalGrid grid;
+  reader.read(grid.m_start.x);
+  reader.read(grid.m_start.y);
+  reader.read(grid.m_end.x);
+  reader.read(grid.m_end.y);
+  reader.read(grid.m_step);
+
+  return grid;
+}
+
+void
+write_grids(serialize::Writer& writer, const std::map<types::Metal, def::utils::MetalGrid, def::utils::MetalGrid::Compare>& grids)
+{
+  writer.write<uint64_t>(grids.size());
+
+  for(const auto& [metal, grid] : grids)
+    {
+      writer.write(metal);
+      write_grid(writer, grid);
+    }
+}
+
+void
+read_grids(serialize::Reader& reader, std::map<types::Metal, def::utils::MetalGrid, def::utils::MetalGrid::Compare>& grids)
+{
+  for(std::size_t i = 0, end = reader.read<uint64_t>(); i < end; ++i)
+    {
+      const auto metal = reader.read<types::Metal>();
+      grids[metal]     = read_grid(reader);
+    }
+}
+
+void
+write_edges(serialize::Writer& writer, const std::vector<double>& edges)
+{
+  writer.write<uint64_t>(edges.size());
+
+  for(const auto edge : edges)
+    {
+      writer.write(edge);
+    }
+}
+
+void
+read_edges(serialize::Reader& reader, std::vector<double>& edges)
+{
+  edges.resize(reader.read<uint64_t>());
+
+  for(auto& edge : edges)
+    {
+      reader.read(edge);
+    }
+}
+
+/** Support functions for the design */
+void
+write_pin(serialize::Writer& writer, const pin::Pin& pin)
+{
+  writer.write(pin.m_is_placed);
+  writer.write(pin.m_name);
+  writer.write(pin.m_use);
+  writer.write(pin.m_direction);
+  writer.write(pin.m_center.x);
+  writer.write(pin.m_center.y);
+  serialize::write_polygons(writer, pin.m_ports);
+  serialize::write_polygons(writer, pin.m_obs);
+}
+
+void
+read_pin(serialize::Reader& reader, pin::Pin& pin)
+{
+  reader.read(pin.m_is_placed);
+  reader.read(pin.m_name);
+  reader.read(pin.m_use);
+  reader.read(pin.m_direction);
+  reader.read(pin.m_center.x);
+  reader.read(pin.m_center.y);
+  serialize::read_polygons(reader, pin.m_ports);
+  serialize::read_polygons(reader, pin.m_obs);
+}
+
+void
+write_def_pin(serialize::Writer& writer, const def::Pin& pin, const Table<pin::Pin>& pins, const Table<def::Net>& nets)
+{
+  writer.write(pin.m_type);
+  writer.write(pins.id(pin.m_ptr));
+  writer.write(nets.id(pin.m_net));
+  write_point(writer, pin.m_center);
+  write_point(writer, pin.m_matrix_pos);
+  writer.write(pin.m_access_points.m_metal);
+  writer.write<uint64_t>(pin.m_access_points.m_points.size());
+
+  for(const auto& [point, proj] : pin.m_access_points.m_points)
+    {
+      writer.write(point.x);
+      writer.write(point.y);
+      write_point(writer, proj);
+    }
+}
+
+std::unique_ptr<def::Pin>
+read_def_pin(serialize::Reader& reader, const Owner<pin::Pin>& pins, const Owner<def::Net>& nets)
+{
+  const auto type = reader.read<def::Pin::Type>();
+  pin::Pin*  ptr  = pins.at(reader.read<uint64_t>());
+  def::Net*  net  = nets.at(reader.read<uint64_t>());
+
+  if(ptr == nullptr || ptr->m_ports.empty())
+    {
+      throw std::runtime_error("Snapshot Error: A pin without ports.");
+    }
+
+  auto pin          = std::make_unique<def::Pin>(ptr, net);
+  pin->m_type       = type;
+  pin->m_center     = read_point(reader);
+  pin->m_matrix_pos = read_point(reader);
+  reader.read(pin->m_access_points.m_metal);
+  pin->m_access_points.m_points.resize(reader.read<uint64_t>());
+
+  for(auto& [point, proj] : pin->m_access_points.m_points)
+    {
+      reader.read(point.x);
+      reader.read(point.y);
+      proj = read_point(reader);
+    }
+
+  return pin;
+}
+
+template <typename Tp>
+void
+write_ids(serialize::Writer& writer, const std::vector<Tp*>& items, const Table<Tp>& table)
+{
+  writer.write<uint64_t>(items.size());
+
+  for(const auto item : items)
+    {
+      writer.write(table.id(item));
+    }
+}
+
+template <typename Tp>
+void
+read_ids(serialize::Reader& reader, std::vector<Tp*>& items, const Owner<Tp>& owner)
+{
+  items.resize(reader.read<uint64_t>());
+
+  for(auto& item : items)
+    {
+      item = owner.at(reader.read<uint64_t>());
+    }
+}
+
+void
+write_stack(serialize::Writer& writer, const def::Stack& stack, const Table<def::Pin>& pins, const Table<def::Net>& nets)
+{
+  /** Nets are solved in chunks in order of their indices, so the snapshot keeps indices and doesn't depend on the hash map */
+  writer.write<uint64_t>(stack.m_nets.size());
+
+  for(const def::details::Net* details_net : stack.get_ordered_nets())
+    {
+      writer.write(nets.id(details_net->m_ptr));
+      writer.write<uint64_t>(details_net->m_idx);
+      write_ids(writer, details_net->m_pins, pins);
+    }
+
+  write_grids(writer, stack.get_all_grids());
+  writer.write<uint64_t>(stack.get_used_grids().size());
+
+  for(std::size_t i = 0, end = stack.get_used_grids().size(); i < end; ++i)
+    {
+      write_grid(writer, stack.get_used_grids()[i]);
+      writer.write(stack.get_used_metals()[i]);
+    }
+
+  writer.write<uint64_t>(stack.get_obstacles().size());
+
+  for(const auto& points : stack.get_obstacles())
+    {
+      writer.write<uint64_t>(points.size());
+
+      for(const auto& point : points)
+        {
+          write_point(writer, point);
+        }
+    }
+}
+
+void
+read_stack(serialize::Reader& reader, def::Stack& stack, const Owner<def::Pin>& pins, const Owner<def::Net>& nets)
+{
+  std::vector<def::details::Net> stack_nets(reader.read<uint64_t>());
+
+  for(auto& stack_net : stack_nets)
+    {
+      stack_net.m_ptr = nets.at(reader.read<uint64_t>());
+      reader.read(stack_net.m_idx);
+      read_ids(reader, stack_net.m_pins, pins);
+
+      if(stack_net.m_ptr == nullptr)
+        {
+          throw std::runtime_error("Snapshot Error: A stack net without a net.");
+        }
+    }
+
+  for(auto& stack_net : stack_nets)
+    {
+      if(!stack.m_nets.emplace(stack_net.m_ptr, std::move(stack_net)).second)
+        {
+          throw std::runtime_error("Snapshot Error: A stack has the same net twice.");
+        }
+    }
+
+  std::map<types::Metal, def::utils::MetalGrid, def::utils::MetalGrid::Compare> all_grids;
+  read_grids(reader, all_grids);
+  stack.set_all_grids(all_grids);
+
+  for(std::size_t i = 0, end = reader.read<uint64_t>(); i < end; ++i)
+    {
+      const def::utils::MetalGrid grid = read_grid(reader);
+      stack.add_grid(grid, reader.read<types::Metal>());
+    }
+
+  for(std::size_t i = 0, end = reader.read<uint64_t>(); i < end; ++i)
+    {
+      std::vector<geom::PointS> points(reader.read<uint64_t>());
+
+      for(auto& point : points)
+        {
+          point = read_point(reader);
+        }
+
+      stack.add_obstacle(points);
+    }
+}
+
+void
+write_data(serialize::Writer& writer, const def::Data& data)
+{
+  /** General */
+  writer.write(data.m_box);
+  writer.write<uint64_t>(data.m_components.size());
+
+  for(const auto& component : data.m_components)
+    {
+      writer.write(component.m_id);
+      writer.write(component.m_name);
+      writer.write(component.m_x);
+      writer.write(component.m_y);
+      writer.write(component.m_orientation);
+    }
+
+  serialize::write_polygons(writer, data.m_obstacles);
+  writer.write<uint64_t>(data.m_tracks.size());
+
+  for(const auto& track : data.m_tracks)
+    {
+      writer.write(track);
+    }
+
+  writer.write<uint64_t>(data.m_max_gcell_x);
+  writer.write<uint64_t>(data.m_max_gcell_y);
+  write_edges(writer, data.m_gcell_index.get_columns());
+  write_edges(writer, data.m_gcell_index.get_rows());
+
+  /** Shared objects */
+  Table<pin::Pin> pins;
+  Table<def::Net> nets;
+  Table<def::Pin> def_pins;
+
+  for(const auto& [_, pin] : data.m_pins)
+    {
+      pins.add(pin);
+    }
+
+  for(const auto pin : data.m_cross_pins)
+    {
+      pins.add(pin);
+    }
+
+  for(const auto& [_, net] : data.m_nets)
+    {
+      nets.add(net);
+    }
+
+  for(const auto& row : data.m_gcells)
+    {
+      for(const auto gcell : row)
+        {
+          for(const auto pin : gcell->m_inner_pins)
+            {
+              def_pins.add(pin);
+            }
+
+          for(const auto pin : gcell->m_cross_pins)
+            {
+              def_pins.add(pin);
+            }
+
+          for(const auto& [bottom_pin, top_pin] : gcell->m_between_stack_pins)
+            {
+              def_pins.add(bottom_pin);
+              def_pins.add(top_pin);
+            }
+
+          for(const auto& stack : gcell->m_stacks)
+            {
+              for(const auto& [_, stack_net] : stack.m_nets)
+                {
+                  for(const auto pin : stack_net.m_pins)
+                    {
+                      def_pins.add(pin);
+                    }
+                }
+            }
+        }
+    }
+
+  /** Between stack pins are owned only by def pins */
+  for(const auto pin : def_pins.items())
+    {
+      pins.add(pin->m_ptr);
+      nets.add(pin->m_net);
+    }
+
+  writer.write<uint64_t>(pins.items().size());
+
+  for(const auto pin : pins.items())
+    {
+      write_pin(writer, *pin);
+    }
+
+  writer.write<uint64_t>(nets.items().size());
+
+  for(const auto net : nets.items())
+    {
+      writer.write<uint64_t>(net->m_idx);
+      writer.write(net->m_name);
+      writer.write<uint64_t>(net->m_pins.size());
+
+      for(const auto& pin_name : net->m_pins)
+        {
+          writer.write(pin_name);
+        }
+    }
+
+  writer.write<uint64_t>(def_pins.items().size());
+
+  for(const auto pin : def_pins.items())
+    {
+      write_def_pin(writer, *pin, pins, nets);
+    }
+
+  writer.write<uint64_t>(data.m_pins.size());
+
+  for(const auto& [name, pin] : data.m_pins)
+    {
+      writer.write(name);
+      writer.write(pins.id(pin));
+    }
+
+  write_ids(writer, data.m_cross_pins, pins);
+  writer.write<uint64_t>(data.m_nets.size());
+
+  for(const auto& [name, net] : data.m_nets)
+    {
+      writer.write(name);
+      writer.write(nets.id(net));
+    }
+
+  /** GCells */
+  writer.write<uint64_t>(data.m_gcells.size());
+
+  for(const auto& row : data.m_gcells)
+    {
+      writer.write<uint64_t>(row.size());
+
+      for(const auto gcell : row)
+        {
+          writer.write<uint64_t>(gcell->m_x);
+          writer.write<uint64_t>(gcell->m_y);
+          writer.write(gcell->m_is_error);
+          serialize::write_polygon(writer, gcell->m_box);
+          serialize::write_polygons(writer, gcell->m_obstacles);
+          write_ids(writer, gcell->m_inner_pins, def_pins);
+          write_ids(writer, gcell->m_cross_pins, def_pins);
+          writer.write<uint64_t>(gcell->m_between_stack_pins.size());
+
+          for(const auto& [bottom_pin, top_pin] : gcell->m_between_stack_pins)
+            {
+              writer.write(def_pins.id(bottom_pin));
+              writer.write(def_pins.id(top_pin));
+            }
+
+          write_ids(writer, gcell->m_nets, nets);
+          write_grids(writer, gcell->m_grids);
+          writer.write<uint64_t>(gcell->m_stack_itr);
+          writer.write<uint64_t>(gcell->m_stacks.size());
+
+          for(const auto& stack : gcell->m_stacks)
+            {
+              write_stack(writer, stack, def_pins, nets);
+            }
+        }
+    }
+}
+
+void
+read_data(serialize::Reader& reader, def::Data& data)
+{
+  /** General */
+  reader.read(data.m_box);
+  data.m_components.resize(reader.read<uint64_t>());
+
+  for(auto& component : data.m_components)
+    {
+      reader.read(component.m_id);
+      reader.read(component.m_name);
+      reader.read(component.m_x);
+      reader.read(component.m_y);
+      reader.read(component.m_orientation);
+    }
+
+  serialize::read_polygons(reader, data.m_obstacles);
+  data.m_tracks.resize(reader.read<uint64_t>());
+
+  for(auto& track : data.m_tracks)
+    {
+      reader.read(track);
+    }
+
+  data.m_max_gcell_x = reader.read<uint64_t>();
+  data.m_max_gcell_y = reader.read<uint64_t>();
+
+  std::vector<double> columns;
+  std::vector<double> rows;
+  read_edges(reader, columns);
+  read_edges(reader, rows);
+  data.m_gcell_index = def::GCellIndex(std::move(columns), std::move(rows));
+
+  /** Shared objects */
+  Owner<pin::Pin>   pins;
+  Owner<def::Net>   nets;
+  Owner<def::Pin>   def_pins;
+  Owner<def::GCell> gcells;
+
+  for(std::size_t i = 0, end = reader.read<uint64_t>(); i < end; ++i)
+    {
+      read_pin(reader, *pins.add(std::make_unique<pin::Pin>()));
+    }
+
+  for(std::size_t i = 0, end = reader.read<uint64_t>(); i < end; ++i)
+    {
+      def::Net* net = nets.add(std::make_unique<def::Net>());
+      net->m_idx    = reader.read<uint64_t>();
+      reader.read(net->m_name);
+
+      for(std::size_t j = 0, end_j = reader.read<uint64_t>(); j < end_j; ++j)
+        {
+          net->m_pins.emplace(reader.read<std::string>());
+        }
+    }
+
+  for(std::size_t i = 0, end = reader.read<uint64_t>(); i < end; ++i)
+    {
+      def_pins.add(read_def_pin(reader, pins, nets));
+    }
+
+  for(std::size_t i = 0, end = reader.read<uint64_t>(); i < end; ++i)
+    {
+      const std::string name = reader.read<std::string>();
+      data.m_pins[name]      = pins.at(reader.read<uint64_t>());
+    }
+
+  read_ids(reader, data.m_cross_pins, pins);
+
+  for(std::size_t i = 0, end = reader.read<uint64_t>(); i < end; ++i)
+    {
+      const std::string name = reader.read<std::string>();
+      data.m_nets[name]      = nets.at(reader.read<uint64_t>());
+    }
+
+  /** GCells */
+  data.m_gcells.resize(reader.read<uint64_t>());
+
+  for(auto& row : data.m_gcells)
+    {
+      row.resize(reader.read<uint64_t>());
+
+      for(auto& gcell : row)
+        {
+          const std::size_t x = reader.read<uint64_t>();
+          const std::size_t y = reader.read<uint64_t>();
+
+          gcell               = gcells.add(std::make_unique<def::GCell>(x, y, geom::Polygon()));
+          reader.read(gcell->m_is_error);
+          serialize::read_polygon(reader, gcell->m_box);
+          serialize::read_polygons(reader, gcell->m_obstacles);
+          read_ids(reader, gcell->m_inner_pins, def_pins);
+          read_ids(reader, gcell->m_cross_pins, def_pins);
+          gcell->m_between_stack_pins.resize(reader.read<uint64_t>());
+
+          for(auto& [bottom_pin, top_pin] : gcell->m_between_stack_pins)
+            {
+              bottom_pin = def_pins.at(reader.read<uint64_t>());
+              top_pin    = def_pins.at(reader.read<uint64_t>());
+            }
+
+          read_ids(reader, gcell->m_nets, nets);
+          read_grids(reader, gcell->m_grids);
+          gcell->m_stack_itr = reader.read<uint64_t>();
+          gcell->m_stacks.resize(reader.read<uint64_t>());
+
+          for(auto& stack : gcell->m_stacks)
+            {
+              read_stack(reader, stack, def_pins, nets);
+            }
+        }
+    }
+
+  if(!reader.is_end())
+    {
+      throw std::runtime_error("Snapshot Error: Unexpected data after the end.");
+    }
+
+  /** All objects are read, from now on the data owns them in the same way as after processing */
+  pins.release();
+  nets.release();
+  def_pins.release();
+  gcells.release();
+}
+
+} // namespace snapshot::details
+
+namespace snapshot
+{
+
+uint64_t
+make_key(const std::vector<std::filesystem::path>& files)
+{
+  uint64_t key = serialize::fnv1a(&details::VERSION, sizeof(details::VERSION));
+
+  for(const auto& path : files)
+    {
+      key = serialize::hash_file(path, key);
+    }
+
+  return key;
+}
+
+void
+save(const std::filesystem::path& path, const uint64_t key, const def::Data& data)
+{
+  serialize::Writer writer;
+  writer.write(details::MAGIC);
+  writer.write(details::VERSION);
+  writer.write(key);
+  details::write_data(writer, data);
+
+  if(path.has_parent_path())
+    {
+      std::filesystem::create_directories(path.parent_path());
+    }
+
+  const std::filesystem::path temp_path = path.string() + "." + std::to_string(getpid()) + ".tmp";
+
+  {
+    std::ofstream file(temp_path, std::ios::binary);
+    file.write(writer.buffer().data(), writer.buffer().size());
+
+    if(!file.good())
+      {
+        file.close();
+        std::filesystem::remove(temp_path);
+
+        throw std::runtime_error("Snapshot Error: Unable to write the snapshot - \"" + path.string() + "\".");
+      }
+  }
+
+  std::error_code error;
+  std::filesystem::rename(temp_path, path, error);
+
+  if(error)
+    {
+      std::filesystem::remove(temp_path, error);
+      throw std::runtime_error("Snapshot Error: Unable to replace the snapshot - \"" + path.string() + "\".");
+    }
+}
+
+bool
+load(const std::filesystem::path& path, const uint64_t key, def::Data& data)
+{
+  std::ifstream file(path, std::ios::binary | std::ios::ate);
+
+  if(!file.is_open())
+    {
+      return false;
+    }
+
+  std::string content(static_cast<std::size_t>(file.tellg()), '\0');
+  file.seekg(0);
+  file.read(content.data(), content.size());
+
+  if(!file.good())
+    {
+      return false;
+    }
+
+  try
+    {
+      serialize::Reader reader(content.data(), content.size());
+
+      if(reader.read<uint32_t>() != details::MAGIC || reader.read<uint32_t>() != details::VERSION || reader.read<uint64_t>() != key)
+        {
+          return false;
+        }
+
+      def::Data loaded;
+      details::read_data(reader, loaded);
+
+      data = std::move(loaded);
+
+      return true;
+    }
+  catch(const std::exception& e)
+    {
+      std::cout << "Snapshot Warning: Invalid snapshot - \"" << path.string() << "\". " << e.what() << std::endl;
+    }
+
+  return false;
+}
+
+} // namespace snapshot
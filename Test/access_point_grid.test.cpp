@@ -0,0 +1,102 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <memory>
+#include <tuple>
+#include <vector>
+
+#include <Include/DEF/AccessPointGrid.hpp>
+
+namespace
+{
+
+/** Owns a top level pin and a net of a grid pin, the grid pin keeps only pointers to them */
+struct PinHolder
+{
+  pin::Pin                  m_pin;
+  def::Net                  m_net;
+  std::unique_ptr<def::Pin> m_grid_pin;
+};
+
+/** Makes a pin on a metal layer, which can be accessed only at given nodes of the grid */
+std::unique_ptr<PinHolder>
+make_pin(const std::size_t net_idx, const types::Metal metal, const std::vector<geom::PointS>& nodes)
+{
+  auto holder = std::make_unique<PinHolder>();
+
+  holder->m_net.m_idx  = net_idx;
+  holder->m_net.m_name = "net_" + std::to_string(net_idx);
+  holder->m_pin.m_ports.emplace_back(std::array<double, 4>{ 0.0, 0.0, 1.0, 1.0 }, metal);
+  holder->m_grid_pin   = std::make_unique<def::Pin>(&holder->m_pin, &holder->m_net);
+
+  for(const geom::PointS& node : nodes)
+    {
+      holder->m_grid_pin->m_access_points.m_points.emplace_back(geom::Point{ double(node.x), double(node.y) }, node);
+    }
+
+  return holder;
+}
+
+std::vector<geom::PointS>
+get_sorted_obstacles(def::AccessPointGrid& grid, const types::Metal metal)
+{
+  std::vector<geom::PointS> points = grid.get_obstacles(metal);
+
+  std::sort(points.begin(), points.end(), [](const geom::PointS& lhs, const geom::PointS& rhs) { return std::tie(lhs.x, lhs.y) < std::tie(rhs.x, rhs.y); });
+
+  return points;
+}
+
+} // namespace
+
+TEST(AccessPointGridTest, Obstacles)
+{
+  def::AccessPointGrid grid({ 0.0, 0.0 }, { 4.0, 4.0 }, 1.0);
+
+  /** M1 is routed along horizontal lines, M2 along vertical ones, a layer marks only its own bit */
+  grid.add_obstacle(geom::Polygon({ 1.0, 1.0, 2.0, 2.0 }, types::Metal::M1));
+  grid.add_obstacle(geom::Polygon({ 3.0, 3.0, 4.0, 4.0 }, types::Metal::M2));
+
+  using Points = std::vector<geom::PointS>;
+
+  EXPECT_EQ(get_sorted_obstacles(grid, types::Metal::M1), (Points{ { 1, 1 }, { 1, 2 }, { 2, 1 }, { 2, 2 } }));
+  EXPECT_EQ(get_sorted_obstacles(grid, types::Metal::M2), (Points{ { 3, 3 }, { 3, 4 }, { 4, 3 }, { 4, 4 } }));
+  EXPECT_TRUE(grid.get_obstacles(types::Metal::M3).empty());
+}
+
+TEST(AccessPointGridTest, PinPlacement)
+{
+  def::AccessPointGrid grid({ 0.0, 0.0 }, { 4.0, 4.0 }, 1.0);
+  grid.add_obstacle(geom::Polygon({ 1.0, 1.0, 2.0, 2.0 }, types::Metal::M1));
+
+  /** The blocked node is skipped */
+  const auto first = make_pin(0, types::Metal::M1, { { 1, 1 }, { 3, 1 } });
+
+  ASSERT_TRUE(grid.add_pin(first->m_grid_pin.get()));
+  EXPECT_EQ(first->m_grid_pin->m_center, (geom::PointS{ std::size_t(3), std::size_t(1) }));
+  EXPECT_EQ(first->m_pin.m_center, (geom::Point{ 3.0, 1.0 }));
+
+  /** The occupied node is skipped and the node on lines without pins is cheaper than the one sharing a line */
+  const auto second = make_pin(1, types::Metal::M1, { { 3, 1 }, { 3, 3 }, { 2, 3 } });
+
+  ASSERT_TRUE(grid.add_pin(second->m_grid_pin.get()));
+  EXPECT_EQ(second->m_grid_pin->m_center, (geom::PointS{ std::size_t(2), std::size_t(3) }));
+
+  /** Ends of lines are via blockages, they are taken only when there are no free nodes */
+  const auto third = make_pin(2, types::Metal::M1, { { 0, 2 } });
+
+  ASSERT_TRUE(grid.add_pin(third->m_grid_pin.get()));
+  EXPECT_EQ(third->m_grid_pin->m_center, (geom::PointS{ std::size_t(0), std::size_t(2) }));
+
+  /** A pin without an accessible node isn't placed */
+  const auto fourth = make_pin(3, types::Metal::M1, { { 1, 2 }, { 2, 3 } });
+
+  EXPECT_FALSE(grid.add_pin(fourth->m_grid_pin.get()));
+}
+
+int
+main(int argc, char* argv[])
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,72 @@
+#include <gtest/gtest.h>
+
+#include <Include/CostMap.hpp>
+
+namespace
+{
+
+matrix::Matrix<>
+make_row(const std::size_t length)
+{
+  matrix::Matrix<> source({ length, 1, 2 });
+  source.fill(1.0);
+
+  return source;
+}
+
+} // namespace
+
+TEST(CostMapTest, SingleTerminal)
+{
+  const matrix::Matrix<>   source = make_row(5);
+  const matrix::SetOfNodes terminals{ matrix::Node{ 0, 0, 0, 0.0, 0, 0 } };
+
+  matrix::Matrix<>         costs({ 5, 1, 2 });
+  algorithms::CostMap      cost_map(source, terminals);
+
+  cost_map.compute(terminals, costs.slice(0), costs.slice(1));
+
+  /** Steps along the row cost 9/8, switching layers costs 2, the farthest cell of the vertical layer costs 6.5 */
+  EXPECT_EQ(costs(0, 0, 0), 1.0);
+  EXPECT_DOUBLE_EQ(costs(2, 0, 0), 0.9 * (1.0 - 2.25 / 6.5));
+  EXPECT_DOUBLE_EQ(costs(0, 0, 1), 0.9 * (1.0 - 2.0 / 6.5));
+  EXPECT_DOUBLE_EQ(costs(4, 0, 1), 0.0);
+
+  for(uint32_t x = 1; x < 5; ++x)
+    {
+      EXPECT_LT(costs(x, 0, 0), costs(x - 1, 0, 0));
+    }
+}
+
+TEST(CostMapTest, Obstacles)
+{
+  const matrix::Matrix<>   source = make_row(5);
+  const matrix::SetOfNodes terminals{ matrix::Node{ 0, 0, 0, 0.0, 0, 0 } };
+  const matrix::SetOfNodes obs{ matrix::Node{ 0, 0, 0, 0.0, 0, 0 }, matrix::Node{ 2, 0, 0, 0.0, 0, 0 } };
+
+  matrix::Matrix<>         costs({ 5, 1, 2 });
+  algorithms::CostMap      cost_map(source, obs);
+
+  cost_map.compute(terminals, costs.slice(0), costs.slice(1));
+
+  EXPECT_EQ(costs(0, 0, 0), 1.0);
+  EXPECT_GT(costs(1, 0, 0), 0.0);
+  EXPECT_EQ(costs(2, 0, 0), 0.0);
+  EXPECT_EQ(costs(3, 0, 0), 0.0);
+  EXPECT_EQ(costs(3, 0, 1), 0.0);
+
+  /** The same engine is reused by the next net */
+  const matrix::SetOfNodes other{ matrix::Node{ 4, 0, 0, 0.0, 0, 0 } };
+  cost_map.compute(other, costs.slice(0), costs.slice(1));
+
+  EXPECT_EQ(costs(4, 0, 0), 1.0);
+  EXPECT_GT(costs(3, 0, 0), 0.0);
+  EXPECT_EQ(costs(1, 0, 0), 0.0);
+}
+
+int
+main(int argc, char* argv[])
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
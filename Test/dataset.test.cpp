@@ -0,0 +1,386 @@
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <limits>
+#include <string>
+#include <vector>
+
+#include <Include/Dataset.hpp>
+
+namespace
+{
+
+/** Builds a record with a 3x2x1 "<f8" cost map, values are shifted by the seed so records differ */
+dataset::details::Record
+make_record(const std::string& name, const std::size_t seed)
+{
+  dataset::details::Record record;
+  record.m_name       = name;
+  record.m_chunk      = seed;
+  record.m_nets       = "net_" + std::to_string(seed) + "\n";
+  record.m_pins_count = seed + 2;
+  record.m_nets_count = seed + 1;
+
+  for(auto* tensor : { &record.m_cost_h, &record.m_cost_v })
+    {
+      const double shift = tensor == &record.m_cost_h ? 0.0 : 100.0;
+
+      tensor->m_dtype     = "<f8";
+      tensor->m_shape     = { 2, 3, 1 };
+      tensor->m_data.resize(6 * sizeof(double));
+
+      for(std::size_t i = 0; i < 6; ++i)
+        {
+          const double value = shift + double(seed) + 0.5 * double(i);
+          std::memcpy(tensor->m_data.data() + i * sizeof(double), &value, sizeof(double));
+        }
+    }
+
+  /** The path size isn't a multiple of 8, so the padding of records is checked too */
+  record.m_path.m_dtype = "|u1";
+  record.m_path.m_shape = { 2, 3, 1 };
+  record.m_path.m_data  = { 0, 1, 2, 0, 1, char(seed) };
+
+  return record;
+}
+
+/** Makes an empty temporary folder */
+std::filesystem::path
+make_folder(const std::string& name)
+{
+  const std::filesystem::path folder = std::filesystem::temp_directory_path() / name;
+
+  std::filesystem::remove_all(folder);
+  std::filesystem::create_directories(folder);
+
+  return folder;
+}
+
+/** Builds a sample with 3x2 single layer tensors */
+dataset::Sample
+make_sample(const std::string& name, const std::size_t chunk)
+{
+  dataset::Sample sample;
+  sample.m_name       = name;
+  sample.m_chunk      = chunk;
+  sample.m_nets       = "net\n";
+  sample.m_cost_h     = matrix::Matrix<>({ 3, 2, 1 });
+  sample.m_cost_v     = matrix::Matrix<>({ 3, 2, 1 });
+  sample.m_path       = matrix::Matrix<uint8_t>({ 3, 2, 1 });
+  sample.m_pins_count = 2;
+  sample.m_nets_count = 1;
+
+  sample.m_path(1, 0, 0) = 1;
+  sample.m_path(2, 1, 0) = 2;
+
+  return sample;
+}
+
+/** Reads lines of a file */
+std::vector<std::string>
+read_lines(const std::filesystem::path& path)
+{
+  std::ifstream            file(path);
+  std::vector<std::string> lines;
+
+  for(std::string line; std::getline(file, line);)
+    {
+      lines.push_back(line);
+    }
+
+  return lines;
+}
+
+} // namespace
+
+TEST(DatasetTest, ShardRoundTrip)
+{
+  const std::filesystem::path folder = make_folder("fastlink_dataset_shard_test");
+
+  /** A small shard size makes the writer start the second shard after two records */
+  {
+    dataset::ShardWriter writer(folder, 500);
+
+    for(std::size_t i = 0; i < 3; ++i)
+      {
+        const auto [shard, idx] = writer.append(make_record("sample_" + std::to_string(i), i));
+
+        EXPECT_EQ(shard, dataset::ShardWriter::shard_name(i / 2));
+        EXPECT_EQ(idx, i % 2);
+      }
+
+    writer.flush();
+  }
+
+  EXPECT_EQ(dataset::ShardWriter::shard_name(12), "shard_0012.bin");
+
+  const std::filesystem::path first  = folder / "shard_0000.bin";
+  const std::filesystem::path second = folder / "shard_0001.bin";
+
+  /** The index holds an 8-byte aligned offset per record */
+  ASSERT_EQ(std::filesystem::file_size(std::filesystem::path(first).replace_extension(".idx")), 2 * sizeof(uint64_t));
+  ASSERT_EQ(std::filesystem::file_size(std::filesystem::path(second).replace_extension(".idx")), sizeof(uint64_t));
+
+  {
+    std::ifstream         index(std::filesystem::path(first).replace_extension(".idx"), std::ios::binary);
+    std::vector<uint64_t> offsets(2);
+    index.read(reinterpret_cast<char*>(offsets.data()), offsets.size() * sizeof(uint64_t));
+
+    EXPECT_EQ(offsets[0], 0);
+    EXPECT_GT(offsets[1], sizeof(dataset::details::RecordHeader));
+    EXPECT_EQ(offsets[1] % 8, 0);
+    EXPECT_EQ(std::filesystem::file_size(first) % 8, 0);
+  }
+
+  {
+    dataset::ShardReader reader(first);
+    ASSERT_EQ(reader.size(), 2);
+
+    for(std::size_t i = 0; i < 2; ++i)
+      {
+        const dataset::details::Record record = make_record("sample_" + std::to_string(i), i);
+        const dataset::RecordView      view   = reader.at(i);
+
+        EXPECT_EQ(view.m_name, record.m_name);
+        EXPECT_EQ(view.m_nets, record.m_nets);
+        EXPECT_EQ(view.m_shape, (matrix::Shape{ 3, 2, 1 }));
+        EXPECT_EQ(view.m_cost_dtype, "<f8");
+        EXPECT_EQ(view.m_path_dtype, "|u1");
+        EXPECT_EQ(view.m_pins_count, record.m_pins_count);
+        EXPECT_EQ(view.m_nets_count, record.m_nets_count);
+        EXPECT_EQ(std::memcmp(view.m_cost_h, record.m_cost_h.m_data.data(), record.m_cost_h.m_data.size()), 0);
+        EXPECT_EQ(std::memcmp(view.m_cost_v, record.m_cost_v.m_data.data(), record.m_cost_v.m_data.size()), 0);
+        EXPECT_EQ(std::memcmp(view.m_path, record.m_path.m_data.data(), record.m_path.m_data.size()), 0);
+      }
+
+    EXPECT_THROW(reader.at(2), std::out_of_range);
+  }
+
+  {
+    dataset::ShardReader reader(second);
+    ASSERT_EQ(reader.size(), 1);
+    EXPECT_EQ(reader.at(0).m_name, "sample_2");
+  }
+
+  /** A reopened writer keeps existing shards and starts a new one */
+  {
+    dataset::ShardWriter writer(folder, 500);
+    EXPECT_EQ(writer.append(make_record("sample_3", 3)).first, "shard_0002.bin");
+    writer.flush();
+  }
+
+  EXPECT_EQ(dataset::ShardReader(second).size(), 1);
+
+  std::filesystem::remove_all(folder);
+}
+
+TEST(DatasetTest, HalfRounding)
+{
+  using dataset::details::to_half;
+
+  EXPECT_EQ(to_half(0.0), 0x0000);
+  EXPECT_EQ(to_half(-0.0), 0x8000);
+  EXPECT_EQ(to_half(1.0), 0x3C00);
+  EXPECT_EQ(to_half(-2.0), 0xC000);
+  EXPECT_EQ(to_half(0.1), 0x2E66);
+
+  /** Halfway values round to the even mantissa */
+  EXPECT_EQ(to_half(1.0 + std::ldexp(1.0, -11)), 0x3C00);
+  EXPECT_EQ(to_half(1.0 + 3 * std::ldexp(1.0, -11)), 0x3C02);
+  EXPECT_EQ(to_half(std::nextafter(1.0 + std::ldexp(1.0, -11), 2.0)), 0x3C01);
+
+  /** The largest half is 65504, values from 65520 overflow */
+  EXPECT_EQ(to_half(65504.0), 0x7BFF);
+  EXPECT_EQ(to_half(std::nextafter(65520.0, 0.0)), 0x7BFF);
+  EXPECT_EQ(to_half(65520.0), 0x7C00);
+  EXPECT_EQ(to_half(-1e10), 0xFC00);
+
+  /** Infinity keeps its sign, NaN stays NaN */
+  EXPECT_EQ(to_half(std::numeric_limits<double>::infinity()), 0x7C00);
+  EXPECT_EQ(to_half(-std::numeric_limits<double>::infinity()), 0xFC00);
+
+  const uint16_t nan = to_half(std::numeric_limits<double>::quiet_NaN());
+  EXPECT_EQ(nan & 0x7C00, 0x7C00);
+  EXPECT_NE(nan & 0x03FF, 0);
+
+  /** Subnormals are multiples of 2^-24 */
+  EXPECT_EQ(to_half(std::ldexp(1.0, -14)), 0x0400);
+  EXPECT_EQ(to_half(std::ldexp(1.0, -14) - std::ldexp(1.0, -24)), 0x03FF);
+  EXPECT_EQ(to_half(std::ldexp(1.0, -14) - std::ldexp(1.0, -25)), 0x0400);
+  EXPECT_EQ(to_half(std::ldexp(1.0, -24)), 0x0001);
+  EXPECT_EQ(to_half(-std::ldexp(1.0, -24)), 0x8001);
+  EXPECT_EQ(to_half(3 * std::ldexp(1.0, -25)), 0x0002);
+  EXPECT_EQ(to_half(std::ldexp(1.0, -25)), 0x0000);
+  EXPECT_EQ(to_half(std::nextafter(std::ldexp(1.0, -25), 1.0)), 0x0001);
+  EXPECT_EQ(to_half(std::ldexp(1.0, -26)), 0x0000);
+  EXPECT_EQ(to_half(std::numeric_limits<double>::denorm_min()), 0x0000);
+}
+
+TEST(DatasetTest, CostEncoding)
+{
+  matrix::Matrix<> cost({ 2, 1, 2 });
+  cost(0, 0, 0) = 1.0;
+  cost(0, 0, 1) = 0.5;
+  cost(1, 0, 0) = -1.0;
+  cost(1, 0, 1) = 2.0;
+
+  const dataset::details::Tensor half = dataset::details::encode_cost(cost, dataset::CostType::F16);
+  ASSERT_EQ(half.m_dtype, "<f2");
+  ASSERT_EQ(half.m_shape, (std::vector<std::size_t>{ 1, 2, 2 }));
+  ASSERT_EQ(half.m_data.size(), 4 * sizeof(uint16_t));
+
+  std::vector<uint16_t> halves(4);
+  std::memcpy(halves.data(), half.m_data.data(), half.m_data.size());
+  EXPECT_EQ(halves, (std::vector<uint16_t>{ 0x3C00, 0x3800, 0xBC00, 0x4000 }));
+
+  /** Quantised values are clamped to [0, 1] */
+  const dataset::details::Tensor bytes = dataset::details::encode_cost(cost, dataset::CostType::U8);
+  ASSERT_EQ(bytes.m_dtype, "|u1");
+  EXPECT_EQ(std::vector<uint8_t>(bytes.m_data.begin(), bytes.m_data.end()), (std::vector<uint8_t>{ 255, 128, 0, 255 }));
+}
+
+TEST(DatasetTest, PathBits)
+{
+  /** Ten columns take two bytes per row, the second byte is partially used */
+  matrix::Matrix<uint8_t> path({ 10, 2, 1 });
+  path(0, 0, 0) = 1;
+  path(7, 0, 0) = 2;
+  path(8, 0, 0) = 1;
+  path(9, 1, 0) = 2;
+
+  const dataset::details::Tensor bits = dataset::details::encode_path(path, dataset::PathType::BITS);
+  ASSERT_EQ(bits.m_dtype, "bits");
+  ASSERT_EQ(bits.m_shape, (std::vector<std::size_t>{ 2, 2, 2 }));
+
+  /** The first plane marks wires and vias, the second one only vias, the most significant bit is the first column */
+  const std::vector<uint8_t> expected = { 0x81, 0x80, 0x00, 0x40,
+                                          0x01, 0x00, 0x00, 0x40 };
+  EXPECT_EQ(std::vector<uint8_t>(bits.m_data.begin(), bits.m_data.end()), expected);
+
+  const dataset::details::Tensor bytes = dataset::details::encode_path(path, dataset::PathType::U8);
+  ASSERT_EQ(bytes.m_shape, (std::vector<std::size_t>{ 2, 10, 1 }));
+  EXPECT_EQ(bytes.m_data[7], 2);
+  EXPECT_EQ(bytes.m_data[19], 2);
+}
+
+TEST(DatasetTest, JournalTornRecord)
+{
+  const std::filesystem::path folder = make_folder("fastlink_dataset_journal_test");
+  const std::filesystem::path path   = folder / "journal.txt";
+
+  {
+    dataset::Journal journal(path);
+    journal.append({ { "a", { "row_a_1", "row_a_2" } }, { "b", {} } });
+  }
+
+  const std::size_t valid_size = std::filesystem::file_size(path);
+
+  /** A kill in the middle of a write leaves an entry without some of its rows */
+  {
+    std::ofstream file(path, std::ios::binary | std::ios::app);
+    file << "2 c\nrow_c_1\nrow_c";
+  }
+
+  {
+    dataset::Journal journal(path);
+
+    EXPECT_TRUE(journal.contains("a"));
+    EXPECT_TRUE(journal.contains("b"));
+    EXPECT_FALSE(journal.contains("c"));
+    EXPECT_EQ(journal.rows(), (std::vector<std::string>{ "row_a_1", "row_a_2" }));
+    EXPECT_EQ(std::filesystem::file_size(path), valid_size);
+
+    journal.append({ { "c", { "row_c_1" } } });
+  }
+
+  /** The next entry follows the last complete one */
+  {
+    dataset::Journal journal(path);
+
+    EXPECT_TRUE(journal.contains("c"));
+    EXPECT_EQ(journal.rows(), (std::vector<std::string>{ "row_a_1", "row_a_2", "row_c_1" }));
+  }
+
+  std::filesystem::remove_all(folder);
+}
+
+TEST(DatasetTest, WriterResume)
+{
+  const std::filesystem::path folder  = make_folder("fastlink_dataset_resume_test");
+  dataset::Options            options = { dataset::Format::SHARD, dataset::CostType::F16, dataset::PathType::BITS, false };
+
+  {
+    dataset::Writer writer(folder, 4, options);
+
+    dataset::Batch first = { 0, "a", {} };
+    first.m_samples.push_back(make_sample("sample_a", 0));
+    first.m_samples.push_back(make_sample("sample_a", 1));
+
+    dataset::Batch second = { 1, "b", {} };
+    second.m_samples.push_back(make_sample("sample_b", 0));
+
+    /** Records are written in order of pushes, rows in order of tasks */
+    writer.push(std::move(second));
+    writer.push(std::move(first));
+    writer.finish();
+  }
+
+  /** The run is killed while the journal entry of the third task is written */
+  {
+    std::ofstream file(folder / "journal.txt", std::ios::binary | std::ios::app);
+    file << "1 c\nshard_0000.bin,3";
+  }
+
+  options.m_resume = true;
+
+  {
+    dataset::Writer writer(folder, 4, options);
+
+    EXPECT_TRUE(writer.is_completed("a"));
+    EXPECT_TRUE(writer.is_completed("b"));
+    EXPECT_FALSE(writer.is_completed("c"));
+
+    dataset::Batch third = { 0, "c", {} };
+    third.m_samples.push_back(make_sample("sample_c", 0));
+
+    writer.push(std::move(third));
+    writer.finish();
+  }
+
+  const std::vector<std::string> rows = read_lines(folder / "data.csv");
+  ASSERT_EQ(rows.size(), 5);
+  EXPECT_EQ(rows[0], "shard,record,name,chunk,pins_count,nets_count");
+  EXPECT_EQ(rows[1], "shard_0000.bin,1,sample_a,0,2,1");
+  EXPECT_EQ(rows[2], "shard_0000.bin,2,sample_a,1,2,1");
+  EXPECT_EQ(rows[3], "shard_0000.bin,0,sample_b,0,2,1");
+  EXPECT_EQ(rows[4], "shard_0001.bin,0,sample_c,0,2,1");
+
+  /** Records of the resumed run go to a new shard, the old one is kept as it is */
+  EXPECT_EQ(dataset::ShardReader(folder / "shard_0000.bin").size(), 3);
+
+  dataset::ShardReader      reader(folder / "shard_0001.bin");
+  const dataset::RecordView view = reader.at(0);
+
+  ASSERT_EQ(reader.size(), 1);
+  EXPECT_EQ(view.m_name, "sample_c");
+  EXPECT_EQ(view.m_cost_dtype, "<f2");
+  EXPECT_EQ(view.m_path_dtype, "bits");
+  EXPECT_EQ(static_cast<const uint8_t*>(view.m_path)[0], 0x40);
+  EXPECT_EQ(static_cast<const uint8_t*>(view.m_path)[1], 0x20);
+
+  /** Options of a resumed dataset can't change */
+  options.m_cost = dataset::CostType::F32;
+  EXPECT_THROW(dataset::Writer(folder, 4, options), std::runtime_error);
+
+  std::filesystem::remove_all(folder);
+}
+
+int
+main(int argc, char* argv[])
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
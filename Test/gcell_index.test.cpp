@@ -0,0 +1,97 @@
+#include <gtest/gtest.h>
+
+#include <array>
+#include <optional>
+#include <utility>
+
+#include <Include/DEF/GCellIndex.hpp>
+
+namespace
+{
+
+/** Three columns and two rows with non-uniform steps */
+def::GCellIndex
+make_index()
+{
+  return def::GCellIndex({ 0.0, 10.0, 20.0, 35.0 }, { 0.0, 5.0, 15.0 });
+}
+
+using Cell = std::optional<std::pair<std::size_t, std::size_t>>;
+
+std::optional<std::array<std::size_t, 4>>
+find_range(const def::GCellIndex& index, const geom::Point& left_top, const geom::Point& right_bottom)
+{
+  const std::optional<def::CellRange> range = index.find_range(left_top, right_bottom);
+
+  if(!range)
+    {
+      return std::nullopt;
+    }
+
+  return std::array<std::size_t, 4>{ range->m_left, range->m_top, range->m_right, range->m_bottom };
+}
+
+} // namespace
+
+TEST(GCellIndexTest, FindCell)
+{
+  const def::GCellIndex index = make_index();
+
+  EXPECT_EQ(index.find_cell({ 0.0, 0.0 }), Cell({ 0, 0 }));
+  EXPECT_EQ(index.find_cell({ 12.5, 7.0 }), Cell({ 1, 1 }));
+
+  /** A point on an inner edge belongs to the next cell */
+  EXPECT_EQ(index.find_cell({ 10.0, 5.0 }), Cell({ 1, 1 }));
+  EXPECT_EQ(index.find_cell({ 20.0, 0.0 }), Cell({ 2, 0 }));
+  EXPECT_EQ(index.find_cell({ 9.0, 4.0 }), Cell({ 0, 0 }));
+
+  /** The far edges belong to the last column and the last row */
+  EXPECT_EQ(index.find_cell({ 35.0, 15.0 }), Cell({ 2, 1 }));
+  EXPECT_EQ(index.find_cell({ 35.0, 0.0 }), Cell({ 2, 0 }));
+  EXPECT_EQ(index.find_cell({ 0.0, 15.0 }), Cell({ 0, 1 }));
+
+  /** Points outside of the die */
+  EXPECT_EQ(index.find_cell({ -1.0, 3.0 }), std::nullopt);
+  EXPECT_EQ(index.find_cell({ 36.0, 3.0 }), std::nullopt);
+  EXPECT_EQ(index.find_cell({ 3.0, -1.0 }), std::nullopt);
+  EXPECT_EQ(index.find_cell({ 3.0, 16.0 }), std::nullopt);
+
+  EXPECT_EQ(def::GCellIndex().find_cell({ 0.0, 0.0 }), std::nullopt);
+}
+
+TEST(GCellIndexTest, FindRange)
+{
+  using Range                 = std::array<std::size_t, 4>;
+
+  const def::GCellIndex index = make_index();
+
+  EXPECT_EQ(find_range(index, { 12.0, 6.0 }, { 13.0, 7.0 }), Range({ 1, 1, 1, 1 }));
+  EXPECT_EQ(find_range(index, { 5.0, 1.0 }, { 25.0, 10.0 }), Range({ 0, 0, 2, 1 }));
+
+  /** A box touching a cell by its edge doesn't cover it */
+  EXPECT_EQ(find_range(index, { 0.0, 0.0 }, { 10.0, 5.0 }), Range({ 0, 0, 0, 0 }));
+  EXPECT_EQ(find_range(index, { 10.0, 5.0 }, { 35.0, 15.0 }), Range({ 1, 1, 2, 1 }));
+
+  /** A point on an edge is in the next cell, on the far edges it's in the last cell */
+  EXPECT_EQ(find_range(index, { 20.0, 5.0 }, { 20.0, 5.0 }), Range({ 2, 1, 2, 1 }));
+  EXPECT_EQ(find_range(index, { 35.0, 15.0 }, { 35.0, 15.0 }), Range({ 2, 1, 2, 1 }));
+  EXPECT_EQ(find_range(index, { 0.0, 0.0 }, { 0.0, 0.0 }), Range({ 0, 0, 0, 0 }));
+
+  /** Boxes sticking out of the die are clipped */
+  EXPECT_EQ(find_range(index, { -5.0, -5.0 }, { 5.0, 5.0 }), Range({ 0, 0, 0, 0 }));
+  EXPECT_EQ(find_range(index, { -1.0, -1.0 }, { 100.0, 100.0 }), Range({ 0, 0, 2, 1 }));
+
+  /** Boxes outside of the die or touching it from outside */
+  EXPECT_EQ(find_range(index, { 40.0, 0.0 }, { 50.0, 5.0 }), std::nullopt);
+  EXPECT_EQ(find_range(index, { 35.0, 0.0 }, { 50.0, 5.0 }), std::nullopt);
+  EXPECT_EQ(find_range(index, { -10.0, 0.0 }, { 0.0, 5.0 }), std::nullopt);
+  EXPECT_EQ(find_range(index, { 0.0, -10.0 }, { 5.0, -1.0 }), std::nullopt);
+  EXPECT_EQ(find_range(index, { 36.0, 16.0 }, { 36.0, 16.0 }), std::nullopt);
+}
+
+int
+main(int argc, char* argv[])
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -10,6 +10,98 @@ TEST(UtilsTest, MakeRectangle)
   EXPECT_EQ(polygon.m_points, expected_points);
 }
 
+TEST(PolygonTest, BoxIntersection)
+{
+  const geom::Polygon lhs({ 0, 0, 10, 10 }, types::Metal::M1);
+  const geom::Polygon rhs({ 5, -5, 20, 5 }, types::Metal::M2);
+  const geom::Polygon far({ 30, 30, 40, 40 });
+  const geom::Polygon touching({ 10, 0, 20, 10 });
+
+  const geom::Polygon intersection = lhs - rhs;
+
+  EXPECT_TRUE(lhs.is_box());
+  EXPECT_EQ(intersection.m_metal, types::Metal::M1);
+  EXPECT_EQ(intersection.m_points, geom::Polygon({ 5, 0, 10, 5 }).m_points);
+  EXPECT_TRUE((lhs - far).m_points.empty());
+  EXPECT_TRUE((lhs - touching).m_points.empty());
+
+  EXPECT_TRUE(lhs / rhs);
+  EXPECT_TRUE(lhs / touching);
+  EXPECT_FALSE(lhs / far);
+}
+
+TEST(PolygonTest, BoxUnion)
+{
+  const geom::Polygon lhs({ 0, 0, 10, 10 });
+  const geom::Polygon aligned({ 10, 0, 20, 10 });
+  const geom::Polygon inner({ 2, 2, 4, 4 });
+
+  EXPECT_EQ((lhs + aligned).m_points, geom::Polygon({ 0, 0, 20, 10 }).m_points);
+  EXPECT_EQ((inner + lhs).m_points, lhs.m_points);
+
+  geom::Polygon polygon = inner;
+  polygon += lhs;
+
+  EXPECT_EQ(polygon.m_points, lhs.m_points);
+}
+
+TEST(PolygonTest, BoxAreaAndPoint)
+{
+  const geom::Polygon box({ 10, 5, -1, -4 });
+
+  EXPECT_DOUBLE_EQ(box.get_area(), 99.0);
+  EXPECT_TRUE(box.probe_point(geom::Point(10.0, 0.0)));
+  EXPECT_TRUE(box.probe_point(geom::Point(0.0, 0.0)));
+  EXPECT_FALSE(box.probe_point(geom::Point(11.0, 0.0)));
+}
+
+TEST(PolygonTest, MergeOverlapping)
+{
+  std::vector<geom::Polygon> polygons{ geom::Polygon({ 0, 0, 10, 10 }, types::Metal::M1), geom::Polygon({ 50, 0, 60, 10 }, types::Metal::M1), geom::Polygon({ 20, 0, 30, 10 }, types::Metal::M1),
+                                       geom::Polygon({ 10, 0, 20, 10 }, types::Metal::M1), geom::Polygon({ 52, 2, 54, 4 }, types::Metal::M1) };
+
+  geom::merge_overlapping(polygons);
+
+  ASSERT_EQ(polygons.size(), 2);
+  EXPECT_EQ(polygons[0].m_points, geom::Polygon({ 0, 0, 30, 10 }).m_points);
+  EXPECT_EQ(polygons[0].m_metal, types::Metal::M1);
+  EXPECT_EQ(polygons[1].m_points, geom::Polygon({ 50, 0, 60, 10 }).m_points);
+
+  /** A merged group moves to the position of its last polygon, the first port of a pin depends on it */
+  std::vector<geom::Polygon> ports{ geom::Polygon({ 0, 0, 10, 10 }, types::Metal::M1), geom::Polygon({ 50, 0, 60, 10 }, types::Metal::M1), geom::Polygon({ 5, 0, 20, 10 }, types::Metal::M1),
+                                    geom::Polygon({ 80, 0, 90, 10 }, types::Metal::M1) };
+
+  geom::merge_overlapping(ports);
+
+  ASSERT_EQ(ports.size(), 3);
+  EXPECT_EQ(ports[0].m_points, geom::Polygon({ 50, 0, 60, 10 }).m_points);
+  EXPECT_EQ(ports[1].m_points, geom::Polygon({ 0, 0, 20, 10 }).m_points);
+  EXPECT_EQ(ports[2].m_points, geom::Polygon({ 80, 0, 90, 10 }).m_points);
+}
+
+TEST(CoordTest, RoundingAndBounds)
+{
+  const geom::Polygon box({ 0.4, 0.0, 10.6, 5.0 });
+
+  EXPECT_LT(geom::prev_coord(100), 100);
+  EXPECT_LT(geom::prev_coord(0), 0);
+
+  if constexpr(std::is_integral_v<geom::Coord>)
+    {
+      EXPECT_EQ(geom::to_coord(2.5), 3);
+      EXPECT_EQ(geom::to_coord(-2.5), -3);
+      EXPECT_EQ(geom::to_coord(1.4), 1);
+      EXPECT_EQ(geom::prev_coord(100), 99);
+      EXPECT_EQ(box.m_points, geom::Polygon({ 0, 0, 11, 5 }).m_points);
+    }
+  else
+    {
+      EXPECT_EQ(geom::to_coord(2.5), 2.5);
+      EXPECT_GT(geom::prev_coord(100), 100 - 1e-9);
+      EXPECT_EQ(box.m_points[0], geom::Point(10.6, 5.0));
+    }
+}
+
 int
 main(int argc, char* argv[])
 {
@@ -0,0 +1,130 @@
+#include <gtest/gtest.h>
+
+#include <vector>
+
+#include <Include/Graph.hpp>
+
+namespace
+{
+
+/** A square 0 - 1 - 2 - 3 - 0 with a duplicated edge */
+graph::Graph
+make_square()
+{
+  graph::Graph graph;
+
+  for(uint32_t i = 0; i < 4; ++i)
+    {
+      graph.place_node();
+    }
+
+  graph.add_edge(1, 0, 1);
+  graph.add_edge(2, 1, 2);
+  graph.add_edge(3, 2, 3);
+  graph.add_edge(4, 3, 0);
+  graph.add_edge(5, 1, 0);
+
+  graph.freeze();
+
+  return graph;
+}
+
+std::vector<uint32_t>
+get_neighbours(const graph::Graph& graph, uint32_t node)
+{
+  std::vector<uint32_t> neighbours;
+
+  graph.for_each_neighbour(node, [&](const uint32_t next, const uint32_t) { neighbours.push_back(next); });
+
+  return neighbours;
+}
+
+} // namespace
+
+TEST(GraphTest, Freeze)
+{
+  const graph::Graph graph = make_square();
+
+  EXPECT_EQ(graph.nodes_count(), 4);
+  EXPECT_EQ(graph.edges_count(), 8);
+
+  EXPECT_EQ(get_neighbours(graph, 0), std::vector<uint32_t>({ 1, 3 }));
+
+  const uint32_t edge = graph.find_edge(0, 1);
+
+  ASSERT_NE(edge, graph::Graph::NONE);
+  EXPECT_EQ(graph.get_weight(edge), 1);
+  EXPECT_EQ(graph.get_weight(graph.get_reverse(edge)), 1);
+  EXPECT_EQ(graph.get_destination(graph.get_reverse(edge)), 0);
+
+  EXPECT_EQ(graph.find_edge(0, 2), graph::Graph::NONE);
+}
+
+TEST(GraphTest, Costs)
+{
+  graph::Graph   graph   = make_square();
+
+  const uint32_t edge    = graph.find_edge(2, 3);
+  const uint32_t reverse = graph.get_reverse(edge);
+
+  graph.add_cost(10, 3, 2);
+  EXPECT_EQ(graph.get_weight(edge), 13);
+  EXPECT_EQ(graph.get_weight(reverse), 13);
+
+  graph.remove_cost(5, 2, 3);
+  EXPECT_EQ(graph.get_weight(edge), 8);
+
+  graph.zero_cost(2, 3);
+  EXPECT_EQ(graph.get_weight(reverse), 0);
+
+  graph.restore_cost(3, 2);
+  EXPECT_EQ(graph.get_weight(edge), 3);
+  EXPECT_EQ(graph.get_base_cost(reverse), 3);
+
+  EXPECT_THROW(graph.add_cost(1, 0, 2), std::out_of_range);
+  EXPECT_THROW(graph.add_edge(1, 0, 4), std::out_of_range);
+  EXPECT_THROW(graph.freeze(), std::runtime_error);
+}
+
+TEST(GraphTest, Overlay)
+{
+  graph::Graph   graph = make_square();
+
+  const uint32_t edge  = graph.find_edge(1, 2);
+  graph.add_cost(7, 1, 2);
+
+  /** A node 4 splits the edge 1 - 2 */
+  graph.place_node();
+  EXPECT_TRUE(graph.disable_edge(1, 2));
+  graph.add_edge(6, 1, 4);
+  graph.add_edge(6, 4, 2);
+  graph.add_edge(9, 0, 1);
+
+  EXPECT_EQ(graph.nodes_count(), 5);
+  EXPECT_EQ(graph.edges_count(), 12);
+  EXPECT_EQ(graph.find_edge(1, 2), graph::Graph::NONE);
+  EXPECT_EQ(get_neighbours(graph, 1), std::vector<uint32_t>({ 0, 4 }));
+  EXPECT_EQ(get_neighbours(graph, 4), std::vector<uint32_t>({ 1, 2 }));
+  EXPECT_EQ(graph.get_weight(graph.find_edge(0, 1)), 1);
+
+  graph.add_cost(2, 2, 4);
+  EXPECT_EQ(graph.get_weight(graph.find_edge(4, 2)), 8);
+  EXPECT_FALSE(graph.disable_edge(1, 4));
+  EXPECT_FALSE(graph.disable_edge(1, 2));
+
+  graph.discard_overlay();
+
+  EXPECT_EQ(graph.nodes_count(), 4);
+  EXPECT_EQ(graph.edges_count(), 8);
+  EXPECT_EQ(graph.find_edge(1, 2), edge);
+  EXPECT_EQ(graph.get_weight(edge), 9);
+  EXPECT_EQ(get_neighbours(graph, 1), std::vector<uint32_t>({ 0, 2 }));
+  EXPECT_TRUE(get_neighbours(graph, 4).empty());
+}
+
+int
+main(int argc, char* argv[])
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
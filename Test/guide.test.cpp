@@ -0,0 +1,96 @@
+#include <gtest/gtest.h>
+
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+#include <Include/Guide.hpp>
+
+namespace
+{
+
+std::filesystem::path
+write_guide(const std::string& name, const std::string& content)
+{
+  const std::filesystem::path path = std::filesystem::temp_directory_path() / name;
+
+  std::ofstream               file(path, std::ios::binary);
+  file << content;
+
+  return path;
+}
+
+} // namespace
+
+TEST(GuideTest, ReadTree)
+{
+  const std::filesystem::path    path  = write_guide("guide_test_tree.guide", "net_a\n(\n0 0 6900 20700 met1\n0 0 20700 6900 met2\n0 0 6900 20700 met1\n)\nnet_b\r\n(\r\n6900 6900 13800 13800 li1\r\n)\r\n");
+  const std::vector<guide::Tree> trees = guide::read(path);
+
+  ASSERT_EQ(trees.size(), 2);
+
+  EXPECT_EQ(trees[0].m_name, "net_a");
+  ASSERT_EQ(trees[0].m_nodes.size(), 5);
+  ASSERT_EQ(trees[0].m_edges.size(), 4);
+  EXPECT_EQ(trees[0].m_nodes[0].m_connections, 2);
+  EXPECT_EQ(trees[0].m_nodes[2].m_connections, 1);
+  EXPECT_EQ(trees[0].m_edges[0].m_metal_layer, types::Metal::M1);
+  EXPECT_EQ(trees[0].m_edges[2].m_metal_layer, types::Metal::M2);
+
+  const guide::Edge& edge = trees[0].m_edges[3];
+  EXPECT_EQ(trees[0].m_nodes[edge.m_source].m_x, 1);
+  EXPECT_EQ(trees[0].m_nodes[edge.m_destination].m_x, 2);
+
+  EXPECT_EQ(trees[1].m_name, "net_b");
+  ASSERT_EQ(trees[1].m_nodes.size(), 1);
+  EXPECT_EQ(trees[1].m_nodes[0].m_x, 1);
+  EXPECT_EQ(trees[1].m_nodes[0].m_y, 1);
+  EXPECT_TRUE(trees[1].m_edges.empty());
+
+  std::filesystem::remove(path);
+}
+
+TEST(GuideTest, ParallelRead)
+{
+  constexpr std::size_t NETS_COUNT = 100000;
+
+  std::string           content;
+
+  for(std::size_t i = 0; i < NETS_COUNT; ++i)
+    {
+      const std::string x = std::to_string(i % 100 * 6900);
+      content += "net_" + std::to_string(i) + "\n(\n" + x + " 0 " + x + " 34500 met1\n0 6900 6900 13800 met2\n)\n";
+    }
+
+  const std::filesystem::path    path       = write_guide("guide_test_parallel.guide", content);
+  const std::vector<guide::Tree> sequential = guide::read(path, 1);
+  const std::vector<guide::Tree> parallel   = guide::read(path, 8);
+
+  ASSERT_EQ(sequential.size(), NETS_COUNT);
+  ASSERT_EQ(parallel.size(), NETS_COUNT);
+
+  for(std::size_t i = 0; i < NETS_COUNT; ++i)
+    {
+      EXPECT_EQ(parallel[i].m_name, "net_" + std::to_string(i));
+      ASSERT_EQ(parallel[i].m_nodes.size(), sequential[i].m_nodes.size());
+      ASSERT_EQ(parallel[i].m_edges.size(), sequential[i].m_edges.size());
+    }
+
+  std::filesystem::remove(path);
+}
+
+TEST(GuideTest, WrongFormat)
+{
+  const std::filesystem::path path = write_guide("guide_test_wrong.guide", "net_a\n(\n0 zero 6900 20700 met1\n)\n");
+
+  EXPECT_THROW(guide::read(path), std::runtime_error);
+
+  std::filesystem::remove(path);
+}
+
+int
+main(int argc, char* argv[])
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
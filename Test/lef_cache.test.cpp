@@ -0,0 +1,205 @@
+#include <gtest/gtest.h>
+
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <unistd.h>
+
+#include <Include/LEF.hpp>
+
+namespace
+{
+
+/** A technology with two layers and a macro with a pin and an obstacle */
+lef::Data
+make_data()
+{
+  lef::Data data;
+  data.m_database_number          = 2000.0;
+  data.m_layers[types::Metal::M1] = { lef::Layer::Type::ROUTING, lef::Layer::Direction::HORIZONTAL, 0.07, 0.14, 0.14, 0.0, 0.065 };
+  data.m_layers[types::Metal::M2] = { lef::Layer::Type::ROUTING, lef::Layer::Direction::VERTICAL, 0.07, 0.19, 0.19, 0.095, 0.07 };
+
+  lef::Macro& macro = data.m_macros["NAND2_X1"];
+  macro.m_width     = 0.76;
+  macro.m_height    = 1.4;
+  macro.m_obs.emplace_back(geom::Polygon({ 0.0, 0.0, 1520.0, 200.0 }, types::Metal::M1));
+
+  pin::Pin& pin     = macro.m_pins["A1"];
+  pin.m_name        = "A1";
+  pin.m_use         = pin::Use::SIGNAL;
+  pin.m_direction   = pin::Direction::INPUT;
+  pin.m_center      = { 100.0, 400.0 };
+  pin.m_ports.emplace_back(geom::Polygon({ 80.0, 300.0, 120.0, 500.0 }, types::Metal::M1));
+  pin.m_obs.emplace_back(geom::Polygon({ 0.0, 600.0, 200.0, 700.0 }, types::Metal::M2));
+
+  return data;
+}
+
+void
+expect_polygons_eq(const std::vector<geom::Polygon>& lhs, const std::vector<geom::Polygon>& rhs)
+{
+  ASSERT_EQ(lhs.size(), rhs.size());
+
+  for(std::size_t i = 0; i < lhs.size(); ++i)
+    {
+      EXPECT_EQ(lhs[i].m_metal, rhs[i].m_metal);
+      EXPECT_EQ(lhs[i].m_points, rhs[i].m_points);
+    }
+}
+
+void
+expect_data_eq(const lef::Data& lhs, const lef::Data& rhs)
+{
+  EXPECT_EQ(lhs.m_database_number, rhs.m_database_number);
+  ASSERT_EQ(lhs.m_layers.size(), rhs.m_layers.size());
+
+  for(const auto& [metal, layer] : lhs.m_layers)
+    {
+      ASSERT_TRUE(rhs.m_layers.contains(metal));
+
+      const lef::Layer& other = rhs.m_layers.at(metal);
+      EXPECT_EQ(layer.m_type, other.m_type);
+      EXPECT_EQ(layer.m_direction, other.m_direction);
+      EXPECT_EQ(layer.m_width, other.m_width);
+      EXPECT_EQ(layer.m_pitch_x, other.m_pitch_x);
+      EXPECT_EQ(layer.m_pitch_y, other.m_pitch_y);
+      EXPECT_EQ(layer.m_offset, other.m_offset);
+      EXPECT_EQ(layer.m_spacing, other.m_spacing);
+    }
+
+  ASSERT_EQ(lhs.m_macros.size(), rhs.m_macros.size());
+
+  for(const auto& [name, macro] : lhs.m_macros)
+    {
+      ASSERT_TRUE(rhs.m_macros.contains(name));
+
+      const lef::Macro& other = rhs.m_macros.at(name);
+      EXPECT_EQ(macro.m_width, other.m_width);
+      EXPECT_EQ(macro.m_height, other.m_height);
+      expect_polygons_eq(macro.m_obs, other.m_obs);
+      ASSERT_EQ(macro.m_pins.size(), other.m_pins.size());
+
+      for(const auto& [pin_name, pin] : macro.m_pins)
+        {
+          ASSERT_TRUE(other.m_pins.contains(pin_name));
+
+          const pin::Pin& other_pin = other.m_pins.at(pin_name);
+          EXPECT_EQ(pin.m_is_placed, other_pin.m_is_placed);
+          EXPECT_EQ(pin.m_name, other_pin.m_name);
+          EXPECT_EQ(pin.m_use, other_pin.m_use);
+          EXPECT_EQ(pin.m_direction, other_pin.m_direction);
+          EXPECT_EQ(pin.m_center, other_pin.m_center);
+          expect_polygons_eq(pin.m_ports, other_pin.m_ports);
+          expect_polygons_eq(pin.m_obs, other_pin.m_obs);
+        }
+    }
+}
+
+} // namespace
+
+class LEFCacheTest : public ::testing::Test
+{
+protected:
+  void
+  SetUp() override
+  {
+    m_folder = std::filesystem::temp_directory_path() / ("lef_cache_test_" + std::to_string(getpid()));
+    std::filesystem::create_directories(m_folder);
+  }
+
+  void
+  TearDown() override
+  {
+    std::filesystem::remove_all(m_folder);
+  }
+
+  std::filesystem::path m_folder;
+};
+
+TEST_F(LEFCacheTest, DataRoundTrip)
+{
+  const lef::Data data = make_data();
+
+  serialize::Writer writer;
+  lef::details::write_data(writer, data);
+
+  const std::string& buffer = writer.buffer();
+  serialize::Reader  reader(buffer.data(), buffer.size());
+  lef::Data          result;
+
+  lef::details::read_data(reader, result);
+
+  EXPECT_TRUE(reader.is_end());
+  expect_data_eq(data, result);
+}
+
+TEST_F(LEFCacheTest, CacheRoundTrip)
+{
+  const lef::Data             data       = make_data();
+  const std::filesystem::path cache_path = m_folder / "nested" / "lef.cache";
+
+  lef::LEF::store_cache(cache_path, 42, data);
+
+  lef::Data result;
+
+  ASSERT_TRUE(lef::LEF::load_cache(cache_path, 42, result));
+  expect_data_eq(data, result);
+
+  /** Only the snapshot is left, the temporary file has been renamed */
+  EXPECT_EQ(std::distance(std::filesystem::directory_iterator(cache_path.parent_path()), std::filesystem::directory_iterator()), 1);
+}
+
+TEST_F(LEFCacheTest, StaleCache)
+{
+  const std::filesystem::path cache_path = m_folder / "lef.cache";
+
+  lef::LEF::store_cache(cache_path, 42, make_data());
+
+  /** A snapshot of other LEF files */
+  lef::Data result;
+
+  EXPECT_FALSE(lef::LEF::load_cache(cache_path, 43, result));
+  EXPECT_TRUE(result.m_layers.empty());
+  EXPECT_TRUE(result.m_macros.empty());
+
+  /** A snapshot of another format version */
+  serialize::Writer writer;
+  writer.write<uint32_t>(lef::details::CACHE_VERSION + 1);
+  writer.write<uint64_t>(42);
+  lef::details::write_data(writer, make_data());
+
+  {
+    std::ofstream file(cache_path, std::ios::binary | std::ios::trunc);
+    file.write(writer.buffer().data(), writer.buffer().size());
+  }
+
+  EXPECT_FALSE(lef::LEF::load_cache(cache_path, 42, result));
+  EXPECT_TRUE(result.m_layers.empty());
+  EXPECT_TRUE(result.m_macros.empty());
+
+  /** A missing snapshot */
+  EXPECT_FALSE(lef::LEF::load_cache(m_folder / "missing.cache", 42, result));
+  EXPECT_TRUE(result.m_macros.empty());
+}
+
+TEST_F(LEFCacheTest, TruncatedCache)
+{
+  const std::filesystem::path cache_path = m_folder / "lef.cache";
+
+  lef::LEF::store_cache(cache_path, 42, make_data());
+  std::filesystem::resize_file(cache_path, std::filesystem::file_size(cache_path) - 5);
+
+  /** Partly read data is dropped */
+  lef::Data result;
+
+  EXPECT_FALSE(lef::LEF::load_cache(cache_path, 42, result));
+  EXPECT_TRUE(result.m_layers.empty());
+  EXPECT_TRUE(result.m_macros.empty());
+}
+
+int
+main(int argc, char* argv[])
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -1,5 +1,8 @@
 #include <gtest/gtest.h>
 
+#include <cstdint>
+#include <limits>
+
 #include <Include/Matrix.hpp>
 
 TEST(MatrixTest, CreateEmptyMatrix)
@@ -105,6 +108,83 @@ TEST(MatrixTest, MoveAssign)
   });
 }
 
+TEST(MatrixTest, ElementType)
+{
+  matrix::Matrix<uint8_t> matrix({ 4, 3, 2 });
+  matrix.set_at(2, 3, 2, 1);
+
+  EXPECT_EQ(matrix.get_at(3, 2, 1), 2);
+  EXPECT_EQ(matrix.data()[2 * (4 * 2) + 3 * 2 + 1], 2);
+
+  matrix::Matrix<uint8_t> copy_matrix = matrix;
+
+  EXPECT_EQ(copy_matrix.get_at(3, 2, 1), 2);
+  EXPECT_EQ(copy_matrix.get_at(0, 0, 0), 0);
+}
+
+TEST(MatrixTest, AccessorsAndViews)
+{
+  matrix::Matrix<double> matrix({ 5, 3, 2 });
+
+  EXPECT_EQ(reinterpret_cast<std::uintptr_t>(matrix.data()) % matrix::ALIGNMENT, 0);
+
+  matrix.fill(1.0);
+  matrix(4, 2, 1) = 7.0;
+
+  EXPECT_EQ(matrix.get_at(4, 2, 1), 7.0);
+  EXPECT_EQ(matrix.slice(1)(4, 2), 7.0);
+  EXPECT_EQ(matrix.slice(0)(4, 2), 1.0);
+  EXPECT_EQ(matrix.row(2)[4 * 2 + 1], 7.0);
+
+  matrix.slice(0).fill(3.0);
+
+  EXPECT_EQ(matrix(0, 0, 0), 3.0);
+  EXPECT_EQ(matrix(0, 0, 1), 1.0);
+}
+
+TEST(MatrixTest, NormalizeInverse)
+{
+  constexpr double       INF = std::numeric_limits<double>::max();
+
+  matrix::Matrix<double> matrix({ 4, 1, 1 });
+  matrix(0, 0, 0)            = 2.0;
+  matrix(1, 0, 0)            = 4.0;
+  matrix(2, 0, 0)            = 6.0;
+  matrix(3, 0, 0)            = INF;
+
+  const auto [min, max]      = matrix.min_max(INF);
+
+  EXPECT_EQ(min, 2.0);
+  EXPECT_EQ(max, 6.0);
+
+  matrix.normalize_inverse(min, max, 0.9, INF);
+
+  EXPECT_DOUBLE_EQ(matrix(0, 0, 0), 0.9);
+  EXPECT_DOUBLE_EQ(matrix(1, 0, 0), 0.45);
+  EXPECT_DOUBLE_EQ(matrix(2, 0, 0), 0.0);
+  EXPECT_EQ(matrix(3, 0, 0), 0.0);
+}
+
+TEST(MatrixTest, PoolReuse)
+{
+  matrix::Pool<double>   pool;
+
+  matrix::Matrix<double> matrix = pool.acquire({ 4, 3, 2 });
+  matrix(1, 1, 1)               = 5.0;
+
+  const double*          data   = matrix.data();
+  pool.release(std::move(matrix));
+
+  EXPECT_EQ(matrix.size(), 0);
+
+  matrix::Matrix<double> other = pool.acquire({ 3, 4, 2 });
+  matrix::Matrix<double> same  = pool.acquire({ 4, 3, 2 });
+
+  EXPECT_NE(other.data(), data);
+  EXPECT_EQ(same.data(), data);
+  EXPECT_EQ(same(1, 1, 1), 0.0);
+}
+
 int
 main(int argc, char* argv[])
 {
@@ -0,0 +1,118 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include <Include/Parallel.hpp>
+
+TEST(ParallelTest, RunsEachTaskOnce)
+{
+  const std::size_t             count = 1000;
+  std::vector<std::atomic<int>> visits(count);
+
+  parallel::for_each_task(count, 4, [&](const std::size_t task, const std::size_t worker) {
+    EXPECT_LT(worker, 4);
+    visits[task].fetch_add(1);
+  });
+
+  for(std::size_t i = 0; i < count; ++i)
+    {
+      EXPECT_EQ(visits[i].load(), 1);
+    }
+}
+
+TEST(ParallelTest, SingleThreadKeepsOrder)
+{
+  std::vector<std::size_t> order;
+
+  parallel::for_each_task(10, 1, [&](const std::size_t task, const std::size_t worker) {
+    EXPECT_EQ(worker, 0);
+    order.emplace_back(task);
+  });
+
+  ASSERT_EQ(order.size(), 10);
+
+  for(std::size_t i = 0; i < order.size(); ++i)
+    {
+      EXPECT_EQ(order[i], i);
+    }
+}
+
+TEST(ParallelTest, RethrowsTaskException)
+{
+  EXPECT_THROW(parallel::for_each_task(100, 4, [](const std::size_t task, const std::size_t) {
+    if(task == 42)
+      {
+        throw std::runtime_error("Task Error");
+      }
+  }),
+               std::runtime_error);
+}
+
+TEST(ParallelTest, ShardsCoverAllItemsInOrder)
+{
+  const std::size_t                                count  = 103;
+  const std::size_t                                shards = parallel::shards_count(count, 4);
+  std::vector<std::pair<std::size_t, std::size_t>> ranges(shards);
+
+  parallel::for_each_shard(count, 4, [&](const std::size_t begin, const std::size_t end, const std::size_t shard) {
+    ranges[shard] = { begin, end };
+  });
+
+  ASSERT_EQ(shards, 4);
+  EXPECT_EQ(ranges.front().first, 0);
+  EXPECT_EQ(ranges.back().second, count);
+
+  for(std::size_t i = 1; i < shards; ++i)
+    {
+      EXPECT_EQ(ranges[i - 1].second, ranges[i].first);
+    }
+
+  EXPECT_EQ(parallel::shards_count(2, 4), 2);
+}
+
+TEST(ParallelTest, BudgetLendsIdleThreads)
+{
+  parallel::ThreadBudget budget;
+
+  EXPECT_EQ(budget.acquire(3), 0);
+
+  budget.release(2);
+
+  EXPECT_EQ(budget.acquire(3), 2);
+  EXPECT_EQ(budget.available(), 0);
+
+  /** Two of four threads have no tasks from the start, the thread of a worker is lent as soon as the worker runs out of tasks */
+  std::atomic<int> started = 0;
+
+  parallel::for_each_task(
+      2, 4, [&](const std::size_t, const std::size_t) {
+        EXPECT_GE(budget.available(), 2);
+
+        if(started.fetch_add(1) == 0)
+          {
+            while(budget.available() != 3)
+              {
+                std::this_thread::yield();
+              }
+          }
+      },
+      &budget);
+
+  EXPECT_EQ(budget.available(), 4);
+}
+
+TEST(ParallelTest, ResolvesThreads)
+{
+  EXPECT_EQ(parallel::resolve_threads(3), 3);
+  EXPECT_GE(parallel::resolve_threads(0), 1);
+}
+
+int
+main(int argc, char* argv[])
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
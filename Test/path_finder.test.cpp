@@ -0,0 +1,119 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <stop_token>
+#include <vector>
+
+#include <Include/Algorithms.hpp>
+
+namespace
+{
+
+/**
+ * Nets (0, 2) and (4, 5) both prefer the node 1, only the first one can take the detour 0 - 3 - 6 - 2.
+ *
+ *      4
+ *      |
+ *  0 - 1 - 2
+ *  |   |   |
+ *  |   5   |
+ *  |       |
+ *  3 ----- 6
+ */
+struct Layout
+{
+  std::vector<matrix::Node> m_nodes = { { 0, 1, 0, 0.0, 0, 0 }, { 1, 1, 0, 0.0, 0, 0 }, { 2, 1, 0, 0.0, 0, 0 }, { 0, 3, 0, 0.0, 0, 0 }, { 1, 0, 0, 0.0, 0, 0 }, { 1, 2, 0, 0.0, 0, 0 }, { 2, 3, 0, 0.0, 0, 0 } };
+  matrix::SetOfNodes        m_terminals;
+  graph::Graph              m_graph;
+
+  Layout(const bool has_detour)
+  {
+    for(std::size_t i = 0; i < m_nodes.size(); ++i)
+      {
+        m_graph.place_node();
+      }
+
+    m_graph.add_edge(1, 0, 1);
+    m_graph.add_edge(1, 1, 2);
+    m_graph.add_edge(1, 4, 1);
+    m_graph.add_edge(1, 1, 5);
+
+    if(has_detour)
+      {
+        m_graph.add_edge(1, 0, 3);
+        m_graph.add_edge(1, 3, 6);
+        m_graph.add_edge(1, 6, 2);
+      }
+
+    m_graph.freeze();
+
+    for(const uint32_t terminal : { 0, 2, 4, 5 })
+      {
+        m_terminals.insert(m_nodes[terminal]);
+      }
+  }
+};
+
+bool
+contains(const std::vector<graph::Edge>& tree, const uint32_t node)
+{
+  return std::any_of(tree.begin(), tree.end(), [node](const graph::Edge& edge) { return edge.m_source == node || edge.m_destination == node; });
+}
+
+} // namespace
+
+TEST(PathFinderTest, Negotiation)
+{
+  const Layout           layout(true);
+
+  algorithms::PathFinder path_finder(layout.m_graph, layout.m_terminals, layout.m_nodes);
+  const auto             result = path_finder.route({ { 0, 2 }, { 4, 5 } }, 10);
+  const auto&            trees  = result.m_trees;
+
+  ASSERT_EQ(trees.size(), 2);
+  EXPECT_GT(result.m_iterations, 1);
+  EXPECT_TRUE(result.is_complete());
+
+  EXPECT_EQ(trees[0].size(), 3);
+  EXPECT_FALSE(contains(trees[0], 1));
+
+  EXPECT_EQ(trees[1].size(), 2);
+  EXPECT_TRUE(contains(trees[1], 1));
+}
+
+TEST(PathFinderTest, Unresolved)
+{
+  const Layout           layout(false);
+
+  algorithms::PathFinder path_finder(layout.m_graph, layout.m_terminals, layout.m_nodes);
+  const auto             result = path_finder.route({ { 0, 2 }, { 4, 5 } }, 10);
+  const auto&            trees  = result.m_trees;
+
+  /** Sharing doesn't go down, so the negotiation stops early and the first net is routed again around the second one */
+  EXPECT_EQ(result.m_iterations, 1 + algorithms::PathFinder::MAX_STALL_ITERATIONS);
+  EXPECT_EQ(result.m_unroutable, 0);
+  EXPECT_FALSE(result.is_complete());
+  EXPECT_TRUE(trees[0].empty());
+  EXPECT_EQ(trees[1].size(), 2);
+}
+
+TEST(PathFinderTest, Cancel)
+{
+  const Layout     layout(true);
+
+  std::stop_source stop;
+  stop.request_stop();
+
+  algorithms::PathFinder path_finder(layout.m_graph, layout.m_terminals, layout.m_nodes);
+  const auto             result = path_finder.route({ { 0, 2 }, { 4, 5 } }, 10, stop.get_token());
+
+  EXPECT_TRUE(result.m_is_cancelled);
+  EXPECT_FALSE(result.is_complete());
+}
+
+int
+main(int argc, char* argv[])
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,85 @@
+#include <gtest/gtest.h>
+
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <Include/Serialize.hpp>
+
+TEST(SerializeTest, RoundTrip)
+{
+  serialize::Writer writer;
+  writer.write<uint32_t>(7);
+  writer.write(std::string("macro"));
+  writer.write(0.25);
+
+  const std::string& buffer = writer.buffer();
+  serialize::Reader  reader(buffer.data(), buffer.size());
+
+  EXPECT_EQ(reader.read<uint32_t>(), 7);
+  EXPECT_EQ(reader.read<std::string>(), "macro");
+  EXPECT_EQ(reader.read<double>(), 0.25);
+  EXPECT_TRUE(reader.is_end());
+}
+
+TEST(SerializeTest, TruncatedData)
+{
+  serialize::Writer writer;
+  writer.write(std::string("macro"));
+
+  const std::string& buffer = writer.buffer();
+  serialize::Reader  reader(buffer.data(), buffer.size() - 1);
+
+  EXPECT_THROW(
+      {
+        try
+          {
+            reader.read<std::string>();
+          }
+        catch(const std::runtime_error& e)
+          {
+            EXPECT_STREQ(e.what(), "Serialize Error: Unexpected end of data.");
+            throw;
+          }
+      },
+      std::runtime_error);
+}
+
+TEST(SerializeTest, Hash)
+{
+  const std::string data = "a";
+
+  EXPECT_EQ(serialize::fnv1a(data.data(), 0), serialize::FNV_OFFSET);
+  EXPECT_EQ(serialize::fnv1a(data.data(), data.size()), 0xaf63dc4c8601ec8cull);
+  EXPECT_NE(serialize::fnv1a(data.data(), data.size()), serialize::fnv1a("b", 1));
+}
+
+TEST(SerializeTest, Polygons)
+{
+  const std::vector<geom::Polygon> polygons = { geom::Polygon({ 0.0, 0.0, 2.0, 1.0 }, types::Metal::M1), geom::Polygon({ 1.0, 3.0, 4.0, 5.0 }, types::Metal::M3), geom::Polygon() };
+
+  serialize::Writer writer;
+  serialize::write_polygons(writer, polygons);
+
+  const std::string&         buffer = writer.buffer();
+  serialize::Reader          reader(buffer.data(), buffer.size());
+  std::vector<geom::Polygon> result;
+
+  serialize::read_polygons(reader, result);
+
+  ASSERT_EQ(result.size(), polygons.size());
+  EXPECT_TRUE(reader.is_end());
+
+  for(std::size_t i = 0; i < polygons.size(); ++i)
+    {
+      EXPECT_EQ(result[i].m_metal, polygons[i].m_metal);
+      EXPECT_EQ(result[i].m_points, polygons[i].m_points);
+    }
+}
+
+int
+main(int argc, char* argv[])
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
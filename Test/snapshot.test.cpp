@@ -0,0 +1,196 @@
+#include <gtest/gtest.h>
+
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <Include/Snapshot.hpp>
+
+namespace
+{
+
+/** Owns objects of a design, the data keeps only pointers to them */
+struct Design
+{
+  def::Data                                m_data;
+  std::vector<std::unique_ptr<pin::Pin>>   m_pins;
+  std::vector<std::unique_ptr<def::Net>>   m_nets;
+  std::vector<std::unique_ptr<def::Pin>>   m_def_pins;
+  std::vector<std::unique_ptr<def::GCell>> m_gcells;
+};
+
+std::unique_ptr<Design>
+make_design(const std::size_t nets_count)
+{
+  auto  design = std::make_unique<Design>();
+  auto& data   = design->m_data;
+
+  data.m_box   = { 0, 0, 100, 50 };
+  data.m_components.push_back({ "u1", "NAND2", 10, 20, types::Orientation::E });
+  data.m_obstacles.emplace_back(std::array<double, 4>{ 1.0, 2.0, 3.0, 4.0 }, types::Metal::M2);
+  data.m_tracks.push_back({ 0.5, 1.0, 100, types::Metal::M1 });
+  data.m_max_gcell_x = 1;
+  data.m_max_gcell_y = 1;
+  data.m_gcell_index = def::GCellIndex({ 0.0, 100.0 }, { 0.0, 50.0 });
+
+  auto* gcell        = design->m_gcells.emplace_back(std::make_unique<def::GCell>(0, 0, geom::Polygon({ 0.0, 0.0, 100.0, 50.0 }))).get();
+  gcell->m_obstacles.emplace_back(std::array<double, 4>{ 5.0, 5.0, 6.0, 6.0 }, types::Metal::M1);
+  gcell->m_grids[types::Metal::M1] = { { 0.0, 0.0 }, { 100.0, 50.0 }, 1.0 };
+  gcell->m_stacks.resize(1);
+  data.m_gcells = { { gcell } };
+
+  def::Stack& stack = gcell->m_stacks[0];
+  stack.set_all_grids(gcell->m_grids);
+  stack.add_grid(gcell->m_grids[types::Metal::M1], types::Metal::M1);
+  stack.add_obstacle({ { 1, 2 }, { 3, 4 } });
+
+  /** Names are added in the reverse order, so the order of nets differs from any order of names */
+  for(std::size_t i = 0; i < nets_count; ++i)
+    {
+      const std::string name = "net_" + std::to_string(nets_count - i);
+
+      auto*             pin  = design->m_pins.emplace_back(std::make_unique<pin::Pin>()).get();
+      pin->m_name            = "pin_" + std::to_string(i);
+      pin->m_center          = { geom::Coord(i), geom::Coord(2 * i) };
+      pin->m_ports.emplace_back(std::array<double, 4>{ double(i), 0.0, double(i) + 1.0, 1.0 }, types::Metal::M1);
+
+      auto* net              = design->m_nets.emplace_back(std::make_unique<def::Net>()).get();
+      net->m_idx             = i;
+      net->m_name            = name;
+      net->m_pins.emplace(pin->m_name);
+
+      auto* def_pin          = design->m_def_pins.emplace_back(std::make_unique<def::Pin>(pin, net)).get();
+      def_pin->m_center      = { i, i + 1 };
+      def_pin->m_access_points.m_points.emplace_back(geom::Point{ double(i), 0.5 }, geom::PointS{ i, std::size_t(0) });
+
+      data.m_pins[pin->m_name] = pin;
+      data.m_nets[name]        = net;
+      gcell->m_inner_pins.push_back(def_pin);
+      gcell->m_nets.push_back(net);
+      stack.add_net({ def_pin }, net);
+    }
+
+  return design;
+}
+
+std::vector<std::string>
+get_net_names(const def::Stack& stack)
+{
+  std::vector<std::string> names;
+
+  for(const def::details::Net* net : stack.get_ordered_nets())
+    {
+      names.push_back(net->m_ptr->m_name);
+    }
+
+  return names;
+}
+
+} // namespace
+
+TEST(SnapshotTest, RoundTrip)
+{
+  const std::filesystem::path path   = std::filesystem::temp_directory_path() / "fastlink_snapshot_test.bin";
+  const auto                  design = make_design(64);
+  const def::Data&            saved  = design->m_data;
+
+  snapshot::save(path, 42, saved);
+
+  def::Data loaded;
+
+  EXPECT_FALSE(snapshot::load(path, 43, loaded));
+  ASSERT_TRUE(snapshot::load(path, 42, loaded));
+
+  std::filesystem::remove(path);
+
+  EXPECT_EQ(loaded.m_box, saved.m_box);
+  ASSERT_EQ(loaded.m_components.size(), 1);
+  EXPECT_EQ(loaded.m_components[0].m_name, "NAND2");
+  EXPECT_EQ(loaded.m_components[0].m_orientation, types::Orientation::E);
+  ASSERT_EQ(loaded.m_obstacles.size(), 1);
+  EXPECT_EQ(loaded.m_obstacles[0].m_metal, types::Metal::M2);
+  EXPECT_EQ(loaded.m_obstacles[0].m_points, saved.m_obstacles[0].m_points);
+  ASSERT_EQ(loaded.m_tracks.size(), 1);
+  EXPECT_EQ(loaded.m_tracks[0].m_num, 100);
+  EXPECT_EQ(loaded.m_gcell_index.get_columns(), saved.m_gcell_index.get_columns());
+  EXPECT_EQ(loaded.m_gcell_index.get_rows(), saved.m_gcell_index.get_rows());
+
+  ASSERT_EQ(loaded.m_pins.size(), saved.m_pins.size());
+
+  for(const auto& [name, pin] : saved.m_pins)
+    {
+      ASSERT_EQ(loaded.m_pins.count(name), 1);
+      EXPECT_EQ(loaded.m_pins.at(name)->m_center, pin->m_center);
+      EXPECT_EQ(loaded.m_pins.at(name)->m_ports[0].m_points, pin->m_ports[0].m_points);
+    }
+
+  ASSERT_EQ(loaded.m_nets.size(), saved.m_nets.size());
+
+  for(const auto& [name, net] : saved.m_nets)
+    {
+      ASSERT_EQ(loaded.m_nets.count(name), 1);
+      EXPECT_EQ(loaded.m_nets.at(name)->m_idx, net->m_idx);
+      EXPECT_EQ(loaded.m_nets.at(name)->m_pins, net->m_pins);
+    }
+
+  ASSERT_EQ(loaded.m_gcells.size(), 1);
+  ASSERT_EQ(loaded.m_gcells[0].size(), 1);
+
+  const def::GCell* saved_gcell  = saved.m_gcells[0][0];
+  const def::GCell* loaded_gcell = loaded.m_gcells[0][0];
+
+  EXPECT_EQ(loaded_gcell->m_box.m_points, saved_gcell->m_box.m_points);
+  EXPECT_EQ(loaded_gcell->m_obstacles.size(), 1);
+  EXPECT_EQ(loaded_gcell->m_inner_pins.size(), saved_gcell->m_inner_pins.size());
+  EXPECT_EQ(loaded_gcell->m_nets.size(), saved_gcell->m_nets.size());
+  EXPECT_EQ(loaded_gcell->m_grids.at(types::Metal::M1).m_end, saved_gcell->m_grids.at(types::Metal::M1).m_end);
+
+  /** Nets of a stack keep their order, pins and access points */
+  ASSERT_EQ(loaded_gcell->m_stacks.size(), 1);
+
+  const def::Stack& saved_stack  = saved_gcell->m_stacks[0];
+  const def::Stack& loaded_stack = loaded_gcell->m_stacks[0];
+
+  EXPECT_EQ(get_net_names(loaded_stack), get_net_names(saved_stack));
+
+  const auto saved_nets  = saved_stack.get_ordered_nets();
+  const auto loaded_nets = loaded_stack.get_ordered_nets();
+
+  for(std::size_t i = 0, end = saved_nets.size(); i < end; ++i)
+    {
+      EXPECT_EQ(loaded_nets[i]->m_idx, saved_nets[i]->m_idx);
+      ASSERT_EQ(loaded_nets[i]->m_pins.size(), 1);
+      EXPECT_EQ(loaded_nets[i]->m_pins[0]->m_ptr->m_name, saved_nets[i]->m_pins[0]->m_ptr->m_name);
+      EXPECT_EQ(loaded_nets[i]->m_pins[0]->m_center, saved_nets[i]->m_pins[0]->m_center);
+      EXPECT_EQ(loaded_nets[i]->m_pins[0]->m_net, loaded_nets[i]->m_ptr);
+      EXPECT_EQ(loaded_nets[i]->m_pins[0]->m_access_points.m_points, saved_nets[i]->m_pins[0]->m_access_points.m_points);
+    }
+
+  EXPECT_EQ(loaded_stack.get_used_metals(), saved_stack.get_used_metals());
+  EXPECT_EQ(loaded_stack.get_obstacles(), saved_stack.get_obstacles());
+  EXPECT_EQ(loaded_stack.get_all_grids().size(), saved_stack.get_all_grids().size());
+}
+
+TEST(SnapshotTest, RejectsBrokenFile)
+{
+  const std::filesystem::path path   = std::filesystem::temp_directory_path() / "fastlink_snapshot_broken_test.bin";
+  const auto                  design = make_design(4);
+
+  snapshot::save(path, 42, design->m_data);
+  std::filesystem::resize_file(path, std::filesystem::file_size(path) - 1);
+
+  def::Data loaded;
+
+  EXPECT_FALSE(snapshot::load(path, 42, loaded));
+  EXPECT_TRUE(loaded.m_gcells.empty());
+
+  std::filesystem::remove(path);
+}
+
+int
+main(int argc, char* argv[])
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
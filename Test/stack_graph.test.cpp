@@ -0,0 +1,293 @@
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <optional>
+#include <random>
+#include <set>
+#include <tuple>
+#include <vector>
+
+#include <Include/DEF/Stack.hpp>
+
+namespace
+{
+
+/** An edge by positions of its nodes, the smaller position goes first */
+using EdgeKey = std::tuple<uint32_t, uint32_t, uint32_t, uint32_t, uint32_t, uint32_t, uint32_t>;
+
+EdgeKey
+make_key(const matrix::Node& lhs, const matrix::Node& rhs, const uint32_t weight)
+{
+  auto a = std::make_tuple(lhs.m_x, lhs.m_y, lhs.m_z);
+  auto b = std::make_tuple(rhs.m_x, rhs.m_y, rhs.m_z);
+
+  if(b < a)
+    {
+      std::swap(a, b);
+    }
+
+  return { std::get<0>(a), std::get<1>(a), std::get<2>(a), std::get<0>(b), std::get<1>(b), std::get<2>(b), weight };
+}
+
+/** Enabled edges of the graph of a stack */
+std::set<EdgeKey>
+get_edges(const def::Stack& stack)
+{
+  std::set<EdgeKey> edges;
+
+  for(uint32_t node = 0, end = stack.m_graph.nodes_count(); node < end; ++node)
+    {
+      stack.m_graph.for_each_neighbour(node, [&](const uint32_t next, const uint32_t edge) { edges.insert(make_key(stack.m_nodes[node], stack.m_nodes[next], stack.m_graph.get_weight(edge))); });
+    }
+
+  return edges;
+}
+
+/** Reference sweep of a matrix from scratch, written plainly to check the incremental overlay against it */
+std::set<EdgeKey>
+sweep_from_scratch(const matrix::Matrix<>& source)
+{
+  const matrix::Shape&      shape = source.m_shape;
+  std::vector<uint8_t>      is_known(shape.m_x * shape.m_y * shape.m_z, 0);
+  std::vector<matrix::Node> queue;
+  std::set<EdgeKey>         edges;
+
+  const auto push = [&](const matrix::Node& node) {
+    uint8_t& known = is_known[(std::size_t(node.m_y) * shape.m_x + node.m_x) * shape.m_z + node.m_z];
+
+    if(known == 0)
+      {
+        known = 1;
+        queue.push_back(node);
+      }
+  };
+
+  for(uint32_t x = 0; x < shape.m_x; ++x)
+    {
+      for(uint32_t y = 0; y < shape.m_y; ++y)
+        {
+          if(source(x, y, 0) != 0 && source(x, y, 1) != 0)
+            {
+              push({ x, y, 0, 0.0, 0, 0 });
+            }
+        }
+    }
+
+  for(std::size_t i = 0; i < queue.size(); ++i)
+    {
+      const matrix::Node from = queue[i];
+
+      for(const auto& [dx, dy, dz] : { std::tuple{ 1, 0, 0 }, std::tuple{ -1, 0, 0 }, std::tuple{ 0, 1, 0 }, std::tuple{ 0, -1, 0 }, std::tuple{ 0, 0, 1 }, std::tuple{ 0, 0, -1 } })
+        {
+          /** Wires of the first layer go along x, of the second one along y */
+          if((from.m_z == 0 && dy != 0) || (from.m_z == 1 && dx != 0))
+            {
+              continue;
+            }
+
+          int64_t x = from.m_x;
+          int64_t y = from.m_y;
+          int64_t z = from.m_z;
+
+          while(true)
+            {
+              x += dx;
+              y += dy;
+              z += dz;
+
+              if(x < 0 || y < 0 || z < 0 || x >= int64_t(shape.m_x) || y >= int64_t(shape.m_y) || z >= int64_t(shape.m_z))
+                {
+                  break;
+                }
+
+              const uint8_t value  = source(x, y, z);
+              const bool    is_via = source(x, y, 1 - z) != 0;
+
+              if(is_via || value == uint8_t(types::Cell::TERMINAL))
+                {
+                  const matrix::Node to     = { uint32_t(x), uint32_t(y), uint32_t(z), 0.0, 0, 0 };
+                  const uint32_t     weight = dz != 0 ? 4 * std::max(to.m_z, from.m_z) : uint32_t(std::abs(x - int64_t(from.m_x)) + std::abs(y - int64_t(from.m_y)));
+
+                  edges.insert(make_key(from, to, weight));
+                  push(to);
+                  break;
+                }
+
+              if(value == 0)
+                {
+                  break;
+                }
+            }
+        }
+    }
+
+  return edges;
+}
+
+/** Owns pins and nets of a stack, the stack keeps only pointers to them */
+struct Design
+{
+  def::Stack                             m_stack;
+  std::vector<std::unique_ptr<pin::Pin>> m_pins;
+  std::vector<std::unique_ptr<def::Net>> m_nets;
+  std::vector<std::unique_ptr<def::Pin>> m_def_pins;
+  std::size_t                            m_size_x = 0;
+  std::size_t                            m_size_y = 0;
+  std::size_t                            m_step   = 1;
+};
+
+/** Vertical tracks of the second layer are every v_step tracks of the first layer, rectangles of obstacles are a cell or two wide */
+std::unique_ptr<Design>
+make_design(std::mt19937& random, const std::size_t size_x, const std::size_t size_y, const std::size_t v_step, const std::size_t step, const std::size_t obstacles_count)
+{
+  auto design      = std::make_unique<Design>();
+  design->m_size_x = size_x;
+  design->m_size_y = size_y;
+  design->m_step   = step;
+
+  const def::utils::MetalGrid h_grid = { { 0, 0 }, { geom::Coord(size_x), geom::Coord(size_y) }, 1 };
+  const def::utils::MetalGrid v_grid = { { 0, 0 }, { geom::Coord(size_x), geom::Coord(size_y) }, geom::Coord(v_step) };
+
+  /** Stacks get grids of all layers of a design, only the first two are used */
+  design->m_stack.set_all_grids({ { types::Metal::M1, h_grid }, { types::Metal::M2, v_grid }, { types::Metal::M3, h_grid } });
+  design->m_stack.add_grid(h_grid, types::Metal::M1);
+  design->m_stack.add_grid(v_grid, types::Metal::M2);
+
+  for(std::size_t z = 0; z < 2; ++z)
+    {
+      std::vector<geom::PointS> points;
+
+      for(std::size_t i = 0; i < obstacles_count; ++i)
+        {
+          const std::size_t x = random() % (size_x + 1);
+          const std::size_t y = random() % (size_y + 1);
+
+          points.emplace_back(x, y);
+          points.emplace_back(std::min(x + random() % 2, size_x), std::min(y + random() % 2, size_y));
+        }
+
+      design->m_stack.add_obstacle(points);
+    }
+
+  return design;
+}
+
+/** Places a chunk of pins, cross pins on the far sides are moved to the border of the matrix */
+void
+place_chunk(Design& design, std::mt19937& random, const std::size_t pins_count)
+{
+  def::Stack& stack = design.m_stack;
+
+  stack.m_terminals.clear();
+  stack.m_nets.clear();
+
+  for(std::size_t i = 0; i < pins_count; ++i)
+    {
+      const types::Metal metal = random() % 2 == 0 ? types::Metal::M1 : types::Metal::M2;
+
+      auto*              pin   = design.m_pins.emplace_back(std::make_unique<pin::Pin>()).get();
+      pin->m_ports.emplace_back(std::array<double, 4>{ 0.0, 0.0, 1.0, 1.0 }, metal);
+
+      auto* net              = design.m_nets.emplace_back(std::make_unique<def::Net>()).get();
+      net->m_idx             = design.m_nets.size();
+
+      auto* def_pin          = design.m_def_pins.emplace_back(std::make_unique<def::Pin>(pin, net)).get();
+      def_pin->m_center      = { random() % (design.m_size_x + 1), random() % (design.m_size_y + 1) };
+
+      if(random() % 4 == 0)
+        {
+          def_pin->m_type = def::Pin::Type::CROSS;
+
+          if(metal == types::Metal::M1)
+            {
+              def_pin->m_center.x = random() % 2 == 0 ? 0 : design.m_size_x;
+            }
+          else
+            {
+              def_pin->m_center.y = random() % 2 == 0 ? 0 : design.m_size_y;
+            }
+        }
+
+      stack.add_pin(def_pin);
+    }
+
+  stack.create_matrix(0, design.m_step);
+  stack.create_graph();
+}
+
+} // namespace
+
+TEST(StackGraphTest, OverlayMatchesRebuild)
+{
+  std::mt19937 random(42);
+  std::size_t  blocked_terminals = 0;
+  std::size_t  border_terminals  = 0;
+
+  for(std::size_t design_idx = 0; design_idx < 60; ++design_idx)
+    {
+      const std::size_t size_x = 2 + random() % 12;
+      const std::size_t size_y = 2 + random() % 12;
+      const auto        design = make_design(random, size_x, size_y, 1 + random() % 3, 1 + random() % 2, random() % 8);
+      def::Stack&       stack  = design->m_stack;
+
+      /** The first chunk without terminals builds the base graph, its matrix is the base matrix */
+      place_chunk(*design, random, 0);
+
+      const matrix::Matrix<> base = stack.m_matrix;
+      ASSERT_EQ(get_edges(stack), sweep_from_scratch(base));
+
+      for(std::size_t chunk = 0; chunk < 5; ++chunk)
+        {
+          place_chunk(*design, random, 1 + random() % 6);
+
+          for(const matrix::Node& terminal : stack.m_terminals)
+            {
+              blocked_terminals += base(terminal.m_x, terminal.m_y, terminal.m_z) == 0 || base(terminal.m_x, terminal.m_y, 1 - terminal.m_z) == 0;
+              border_terminals  += terminal.m_x == 0 || terminal.m_y == 0 || terminal.m_x + 1 == base.m_shape.m_x || terminal.m_y + 1 == base.m_shape.m_y;
+            }
+
+          ASSERT_EQ(get_edges(stack), sweep_from_scratch(stack.m_matrix)) << "design " << design_idx << ", chunk " << chunk;
+        }
+
+      /** Dropping the overlay restores the base graph */
+      place_chunk(*design, random, 0);
+      ASSERT_EQ(get_edges(stack), sweep_from_scratch(base));
+    }
+
+  /** Terminals without a via in the base and on the border of the matrix are the cases the overlay has to patch */
+  EXPECT_GT(blocked_terminals, 0);
+  EXPECT_GT(border_terminals, 0);
+}
+
+TEST(StackGraphTest, WideMatrix)
+{
+  std::mt19937 random(7);
+
+  /** Nodes past the 255th column are found by their positions in the flat index */
+  const auto  design = make_design(random, 300, 4, 7, 1, 40);
+  def::Stack& stack  = design->m_stack;
+
+  place_chunk(*design, random, 0);
+  place_chunk(*design, random, 12);
+
+  ASSERT_GT(stack.m_matrix.m_shape.m_x, 255);
+  ASSERT_EQ(get_edges(stack), sweep_from_scratch(stack.m_matrix));
+
+  bool is_past_255 = false;
+
+  for(uint32_t node = 0, end = stack.m_nodes.size(); node < end; ++node)
+    {
+      ASSERT_EQ(stack.find_node(stack.m_nodes[node]), node);
+      is_past_255 |= stack.m_nodes[node].m_x > 255;
+    }
+
+  EXPECT_TRUE(is_past_255);
+  EXPECT_EQ(stack.find_node({ uint32_t(stack.m_matrix.m_shape.m_x), 0, 0, 0.0, 0, 0 }), graph::Graph::NONE);
+}
+
+int
+main(int argc, char* argv[])
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}